@@ -0,0 +1,77 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <sys/resource.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <fmt/format.h>
+// Wisnia
+#include "AST.hpp"
+#include "Exceptions.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "SemanticAnalysis.hpp"
+
+using namespace Wisnia;
+using namespace std::literals;
+
+namespace {
+std::atomic<size_t> allocations{0};
+}  // namespace
+
+// Counts every allocation made through the global operator new
+void *operator new(const size_t size) {
+  ++allocations;
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+// Lexes, parses and analyzes a source file with the AST nodes either allocated one by one on
+// the heap (`heap`) or placed into a node arena (`arena`), printing the number of allocations
+// made and the peak RSS of the process
+int main(int argc, char *argv[]) {
+  if (argc != 3 || (argv[1] != "heap"sv && argv[1] != "arena"sv)) {
+    std::cerr << fmt::format("Usage: {} <heap|arena> <file name>\n", argv[0]);
+    return -1;
+  }
+  const std::string_view mode{argv[1]};
+
+  try {
+    AST::NodeArena arena{};
+    std::optional<AST::NodeArena::Scope> scope{};
+    if (mode == "arena") {
+      scope.emplace(arena);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const size_t before = allocations;
+    Lexer lexer{argv[2], Lexer::Streaming{}};
+    Parser parser{lexer};
+    const auto root = parser.parse();
+    SemanticAnalysis analysis{};
+    root->accept(analysis);
+    const size_t after = allocations;
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << fmt::format("{:<5}: {} allocations ({} nodes in the arena), peak RSS {} KiB, {:.3f} ms\n",
+                             mode,
+                             after - before,
+                             arena.getAllocations(),
+                             usage.ru_maxrss,
+                             elapsed.count());
+  } catch (const WisniaError &ex) {
+    std::cerr << ex.what() << "\n";
+    return -1;
+  }
+}
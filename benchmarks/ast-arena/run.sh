@@ -0,0 +1,15 @@
+#!/bin/bash
+
+# Compares allocating the AST nodes one by one on the heap against placing them into a node arena.
+# Build the driver first:
+#   cmake -DCMAKE_BUILD_TYPE=Release -DBENCHMARKS=ON .. && make wisnia-bench-ast-arena
+
+BENCH=${BENCH:-wisnia-bench-ast-arena}
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+
+# 14 lines per generated function, 7143 functions ~ 100k lines of code
+python3 "$SCRIPT_DIR/../29988-lines-of-code/main.py" --wisnia 7143
+echo "Source size:" $(wc -lc calculate.wsn | awk '{printf "%d lines, %.3f MiB\n", $1, $2/(1024*1024)}')
+
+$BENCH heap calculate.wsn
+$BENCH arena calculate.wsn
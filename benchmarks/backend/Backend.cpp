@@ -0,0 +1,99 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <string>
+#include <fmt/format.h>
+// Wisnia
+#include "AST.hpp"
+#include "CodeGenerator.hpp"
+#include "Exceptions.hpp"
+#include "IRGenerator.hpp"
+#include "Lexer.hpp"
+#include "Modules.hpp"
+#include "Parser.hpp"
+#include "SemanticAnalysis.hpp"
+
+using namespace Wisnia;
+
+namespace {
+size_t sAllocations{0};
+}  // namespace
+
+void *operator new(const size_t size) {
+  sAllocations++;
+  if (void *memory = std::malloc(size)) {
+    return memory;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void *memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept {
+  std::free(memory);
+}
+
+// Runs the back-end over a source file like the compiler does, and prints the best time of every
+// stage out of a few runs, along with the number of heap allocations the stage made
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << fmt::format("Usage: {} <file name> [runs]\n", argv[0]);
+    return -1;
+  }
+  const size_t runs = argc == 3 ? std::stoul(argv[2]) : 3;
+
+  struct Stage {
+    double m_time{std::numeric_limits<double>::max()};
+    size_t m_allocations{0};
+  };
+  Stage generate{}, codegen{};
+  size_t instructions{0}, bytes{0};
+
+  try {
+    for (size_t run = 0; run < runs; ++run) {
+      Lexer lexer{argv[1]};
+      Parser parser{lexer};
+      auto root = parser.parse();
+      SemanticAnalysis analysis{};
+      root->accept(analysis);
+      Modules::markAllAsUnused();
+
+      auto start = std::chrono::steady_clock::now();
+      size_t allocations = sAllocations;
+      auto lap = [&](Stage &stage) {
+        const auto now = std::chrono::steady_clock::now();
+        stage.m_time = std::min(stage.m_time, std::chrono::duration<double, std::milli>(now - start).count());
+        stage.m_allocations = sAllocations - allocations;
+        start = std::chrono::steady_clock::now();
+        allocations = sAllocations;
+      };
+
+      IRGenerator irGenerator{};
+      root->accept(irGenerator);
+      lap(generate);
+
+      CodeGenerator codeGenerator{};
+      const auto &optimized = irGenerator.getInstructions(IRGenerator::Transformation::INSTRUCTION_OPTIMIZATION);
+      codeGenerator.generate(optimized);
+      lap(codegen);
+
+      instructions = optimized.size();
+      bytes = codeGenerator.getTextSection().size();
+    }
+  } catch (const WisniaError &ex) {
+    std::cerr << ex.what() << "\n";
+    return -1;
+  }
+
+  std::cout << fmt::format("{} instructions, {} bytes of code\n", instructions, bytes);
+  std::cout << fmt::format("ir generation  : {:.3f} ms, {} allocations\n", generate.m_time, generate.m_allocations);
+  std::cout << fmt::format("code generation: {:.3f} ms, {} allocations\n", codegen.m_time, codegen.m_allocations);
+}
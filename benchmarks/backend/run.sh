@@ -0,0 +1,14 @@
+#!/bin/bash
+
+# Measures the time and the heap allocations of generating the IR and the machine code.
+# Build the driver first:
+#   cmake -DCMAKE_BUILD_TYPE=Release -DBENCHMARKS=ON .. && make wisnia-bench-backend
+
+BENCH=${BENCH:-wisnia-bench-backend}
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+
+# 14 lines per generated function, 2000 functions ~ 28k lines of code
+python3 "$SCRIPT_DIR/../29988-lines-of-code/main.py" --wisnia 2000
+echo "Source size:" $(wc -lc calculate.wsn | awk '{printf "%d lines, %.3f MiB\n", $1, $2/(1024*1024)}')
+
+$BENCH calculate.wsn 3
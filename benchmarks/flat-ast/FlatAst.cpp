@@ -0,0 +1,80 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <fmt/format.h>
+// Wisnia
+#include "AST.hpp"
+#include "Exceptions.hpp"
+#include "FlatTree.hpp"
+#include "NodeCollector.hpp"
+#include "ParallelParser.hpp"
+
+using namespace Wisnia;
+using namespace std::literals;
+
+// Parses a source file like the compiler does and walks either the pointer-linked tree (`pointer`)
+// or its flat form (`flat`), printing the best time of every stage out of a few runs. The walk
+// gathers all the variables, which is a traversal with no work to speak of, and the flat form has
+// to be built from the parsed nodes first
+int main(int argc, char *argv[]) {
+  if (argc < 3 || argc > 4 || (argv[1] != "pointer"sv && argv[1] != "flat"sv)) {
+    std::cerr << fmt::format("Usage: {} <pointer|flat> <file name> [runs]\n", argv[0]);
+    return -1;
+  }
+  const std::string_view mode{argv[1]};
+  const auto source = SourceBuffer::fromFile(argv[2]);
+  const size_t runs = argc == 4 ? std::stoul(argv[3]) : 3;
+
+  struct Stages {
+    double parse{std::numeric_limits<double>::max()};
+    double flatten{std::numeric_limits<double>::max()};
+    double walk{std::numeric_limits<double>::max()};
+    double total{std::numeric_limits<double>::max()};
+  } best{};
+  size_t nodes{0};
+
+  try {
+    for (size_t run = 0; run < runs; ++run) {
+      auto start = std::chrono::steady_clock::now();
+      auto lap = [&start](double &stage) {
+        const auto now = std::chrono::steady_clock::now();
+        const double elapsed = std::chrono::duration<double, std::milli>(now - start).count();
+        stage = std::min(stage, elapsed);
+        start = now;
+        return elapsed;
+      };
+      double total{0};
+
+      AST::NodeArena arena{};
+      AST::NodeArena::Scope scope{arena};
+      auto root = ParallelParser{source}.parse();
+      total += lap(best.parse);
+
+      if (mode == "flat") {
+        const AST::FlatTree tree{*root};
+        total += lap(best.flatten);
+        nodes = tree.collect<AST::VarExpr>().size();
+        total += lap(best.walk);
+      } else {
+        best.flatten = 0;
+        NodeCollector<AST::VarExpr> collector{};
+        root->accept(collector);
+        nodes = collector.getNodes().size();
+        total += lap(best.walk);
+      }
+      best.total = std::min(best.total, total);
+    }
+  } catch (const WisniaError &ex) {
+    std::cerr << ex.what() << "\n";
+    return -1;
+  }
+
+  std::cout << fmt::format("{:<7}: parse {:.3f} ms, flatten {:.3f} ms, walk {:.3f} ms ({} variables), "
+                           "total {:.3f} ms\n",
+                           mode, best.parse, best.flatten, best.walk, nodes, best.total);
+}
@@ -0,0 +1,15 @@
+#!/bin/bash
+
+# Compares walking the pointer-linked AST against building and walking its flat form.
+# Build the driver first:
+#   cmake -DCMAKE_BUILD_TYPE=Release -DBENCHMARKS=ON .. && make wisnia-bench-flat-ast
+
+BENCH=${BENCH:-wisnia-bench-flat-ast}
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+
+# 14 lines per generated function, 71429 functions ~ 1M lines of code
+python3 "$SCRIPT_DIR/../29988-lines-of-code/main.py" --wisnia 71429
+echo "Source size:" $(wc -lc calculate.wsn | awk '{printf "%d lines, %.3f MiB\n", $1, $2/(1024*1024)}')
+
+$BENCH pointer calculate.wsn 3
+$BENCH flat calculate.wsn 3
@@ -0,0 +1,34 @@
+#!/bin/bash
+
+# Measures the run time of programs that spend most of their time calling functions: a loop
+# calling a function, and a recursive function. Both depend on how the arguments and the return
+# value are passed, and on how many registers are saved and restored around each call.
+# Compare against another compiler build, e.g. one from before a change to the calling code:
+#   BASELINE=/path/to/old/wisnia ./run.sh
+
+WISNIA=${WISNIA:-wisnia}
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+
+print_header () {
+  echo "------------------------------------------------------------------------------"
+  echo "$1"
+  echo "------------------------------------------------------------------------------"
+}
+
+print_push_count () {
+  echo "Push instructions:" $(objdump -D -b binary -m i386:x86-64 "$1" | grep -c "push")
+}
+
+for program in calls recursion; do
+  print_header "WisniaLang ($program)"
+  $WISNIA "$SCRIPT_DIR/$program.wsn" >/dev/null && mv a.out $program
+  print_push_count $program
+  hyperfine --runs 20 --warmup 2 "./$program"
+
+  if [ -n "$BASELINE" ]; then
+    print_header "WisniaLang (baseline, $program)"
+    $BASELINE "$SCRIPT_DIR/$program.wsn" >/dev/null && mv a.out $program-baseline
+    print_push_count $program-baseline
+    hyperfine --runs 20 --warmup 2 "./$program-baseline"
+  fi
+done
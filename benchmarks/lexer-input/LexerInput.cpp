@@ -0,0 +1,46 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <fmt/format.h>
+// Wisnia
+#include "Exceptions.hpp"
+#include "Lexer.hpp"
+
+using namespace Wisnia;
+using namespace std::literals;
+
+// Tokenizes a source file either through the memory-mapped path (`mmap`) or by first reading
+// the whole file through std::ifstream into memory (`stream`), as the lexer used to do
+int main(int argc, char *argv[]) {
+  if (argc != 3 || (argv[1] != "mmap"sv && argv[1] != "stream"sv)) {
+    std::cerr << fmt::format("Usage: {} <mmap|stream> <file name>\n", argv[0]);
+    return -1;
+  }
+  const std::string_view mode{argv[1]};
+  const std::string_view fileName{argv[2]};
+
+  try {
+    const auto start = std::chrono::steady_clock::now();
+    size_t tokens{0};
+    if (mode == "mmap") {
+      Lexer lexer{fileName};
+      tokens = lexer.getArena().size();
+    } else {
+      std::ifstream sourceFile{fileName.data()};
+      std::istringstream iss{std::string{std::istreambuf_iterator(sourceFile), std::istreambuf_iterator<char>()}};
+      Lexer lexer{iss};
+      tokens = lexer.getArena().size();
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << fmt::format("{:<6}: {} tokens in {:.3f} ms\n", mode, tokens, elapsed.count());
+  } catch (const WisniaError &ex) {
+    std::cerr << ex.what() << "\n";
+    return -1;
+  }
+}
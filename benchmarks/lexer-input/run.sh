@@ -0,0 +1,24 @@
+#!/bin/bash
+
+# Compares lexing a memory-mapped source file against reading it through std::ifstream.
+# Build the driver first:
+#   cmake -DCMAKE_BUILD_TYPE=Release -DBENCHMARKS=ON .. && make wisnia-bench-lexer-input
+
+print_header () {
+  echo "------------------------------------------------------------------------------"
+  echo "$1"
+  echo "------------------------------------------------------------------------------"
+}
+
+BENCH=${BENCH:-wisnia-bench-lexer-input}
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+
+# 14 lines per generated function, 71429 functions ~ 1M lines of code
+python3 "$SCRIPT_DIR/../29988-lines-of-code/main.py" --wisnia 71429
+echo "Source size:" $(wc -lc calculate.wsn | awk '{printf "%d lines, %.3f MiB\n", $1, $2/(1024*1024)}')
+
+print_header "Lexer (mmap)"
+hyperfine --runs 20 --warmup 1 "$BENCH mmap calculate.wsn"
+
+print_header "Lexer (ifstream)"
+hyperfine --runs 20 --warmup 1 "$BENCH stream calculate.wsn"
@@ -0,0 +1,65 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <thread>
+#include <fmt/format.h>
+// Wisnia
+#include "AST.hpp"
+#include "Exceptions.hpp"
+#include "Lexer.hpp"
+#include "ParallelParser.hpp"
+#include "Parser.hpp"
+
+using namespace Wisnia;
+
+// Lexes and parses a source file sequentially and then on 1, 2, 4, ... threads, up to the
+// number of cores, printing the best time out of a few runs for each
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << fmt::format("Usage: {} <file name> [runs]\n", argv[0]);
+    return -1;
+  }
+  const auto source = SourceBuffer::fromFile(argv[1]);
+  const size_t runs = argc == 3 ? std::stoul(argv[2]) : 5;
+
+  auto measure = [runs](auto &&parse) {
+    double best{std::numeric_limits<double>::max()};
+    size_t functions{0};
+    for (size_t run = 0; run < runs; ++run) {
+      const auto start = std::chrono::steady_clock::now();
+      const auto root = parse();
+      best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+      functions = root->getGlobalFunctions().size();
+    }
+    return std::pair{best, functions};
+  };
+
+  try {
+    const auto [sequential, functions] = measure([&] {
+      Lexer lexer{source, {0, source->size()}, Lexer::Streaming{}};
+      Parser parser{lexer};
+      return parser.parse();
+    });
+    std::cout << fmt::format("{} functions\n", functions);
+    std::cout << fmt::format("{:>10} | {:>10} | {:>7}\n", "threads", "ms", "speedup");
+    std::cout << fmt::format("{:>10} | {:>10.3f} | {:>7.2f}\n", "sequential", sequential, 1.0);
+
+    const size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t threads = 1;; threads = std::min(threads * 2, cores)) {
+      const auto [parallel, _] = measure([&] { return ParallelParser{source, threads}.parse(); });
+      std::cout << fmt::format("{:>10} | {:>10.3f} | {:>7.2f}\n", threads, parallel, sequential / parallel);
+      if (threads == cores) {
+        break;
+      }
+    }
+  } catch (const WisniaError &ex) {
+    std::cerr << ex.what() << "\n";
+    return -1;
+  }
+}
@@ -0,0 +1,14 @@
+#!/bin/bash
+
+# Shows how lexing and parsing scale with the number of threads.
+# Build the driver first:
+#   cmake -DCMAKE_BUILD_TYPE=Release -DBENCHMARKS=ON .. && make wisnia-bench-parallel-parse
+
+BENCH=${BENCH:-wisnia-bench-parallel-parse}
+SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+
+# 14 lines per generated function, 71429 functions ~ 1M lines of code
+python3 "$SCRIPT_DIR/../29988-lines-of-code/main.py" --wisnia 71429
+echo "Source size:" $(wc -lc calculate.wsn | awk '{printf "%d lines, %.3f MiB\n", $1, $2/(1024*1024)}')
+
+$BENCH calculate.wsn 5
@@ -3,6 +3,9 @@
 
 include(FetchContent)
 
+# Parsing is spread across threads
+find_package(Threads REQUIRED)
+
 if(UNIT_TESTS)
   FetchContent_Declare(googletest
     GIT_REPOSITORY https://github.com/google/googletest.git
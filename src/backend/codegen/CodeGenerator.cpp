@@ -9,7 +9,6 @@
 #include "Instruction.hpp"
 #include "MachineCodeTable.hpp"
 #include "RegisterAllocator.hpp"
-#include "Token.hpp"
 
 using namespace Wisnia;
 using namespace Basic;
@@ -29,9 +28,26 @@ constexpr RegisterContext assignRegisters(const Basic::register_t source, const
   return assigned;
 }
 
-void CodeGenerator::generate(const std::vector<InstructionPtr> &instructions) {
+// The REX prefix, the ModRM byte with the SIB byte that addresses `[rsp + offset]`, and the offset
+ByteArray getStackSlotMachineCode(const std::byte opcode, const Operand &reg, const Operand &offset) {
+  if (reg.getType() != TType::REGISTER || !offset.isLiteralIntegerType()) {
+    throw CodeGenerationError{"Unknown stack slot operands"};
+  }
+  const auto index = assignRegisters(reg.getValue<Basic::register_t>(), reg.getValue<Basic::register_t>()).source;
+  if (index < 0) {
+    throw CodeGenerationError{"Unknown register for stack slot"};
+  }
+  const auto half = static_cast<int>(RegisterAllocator::getHalfRegisters());
+  const auto rex = index < half ? std::byte{0x48} : std::byte{0x4c};
+  const auto modrm = std::byte(0x84 + half * (index % half));
+  ByteArray bytes{rex, opcode, modrm, std::byte{0x24}};
+  bytes.putValue<uint32_t>(offset.getValue<int>());
+  return bytes;
+}
+
+void CodeGenerator::generate(const std::vector<Instruction> &instructions) {
   for (const auto &instruction : instructions) {
-    switch (instruction->getOperation()) {
+    switch (instruction.getOperation()) {
       case Operation::LEA:
         emitLea(instruction);
         break;
@@ -41,6 +57,12 @@ void CodeGenerator::generate(const std::vector<InstructionPtr> &instructions) {
       case Operation::MOV_MEMORY:
         emitMoveMemory(instruction);
         break;
+      case Operation::LOAD:
+        emitLoad(instruction);
+        break;
+      case Operation::STORE:
+        emitStore(instruction);
+        break;
       case Operation::SYSCALL:
         emitSysCall();
         break;
@@ -118,9 +140,9 @@ void CodeGenerator::generate(const std::vector<InstructionPtr> &instructions) {
   }
 
   // Patch jumps
-  for (const auto &[name, offset] : m_jumps) {
+  for (const auto &[symbol, offset] : m_jumps) {
     const auto label = std::find_if(m_labels.begin(), m_labels.end(),
-                                    [&](const auto &l) { return l.m_name == name; });
+                                    [&](const auto &l) { return l.m_symbol == symbol; });
     assert(label != m_labels.end() && "No such label to jump to");
     const auto diff{offset - label->m_offset};
 
@@ -128,10 +150,26 @@ void CodeGenerator::generate(const std::vector<InstructionPtr> &instructions) {
     m_textSection.insert(offset, std::byte(0xff - diff));
   }
 
+  // Patch jumps whose targets are too far for a single byte
+  for (const auto &[symbol, offset] : m_nearJumps) {
+    const auto label = std::find_if(m_labels.begin(), m_labels.end(),
+                                    [&](const auto &l) { return l.m_symbol == symbol; });
+    assert(label != m_labels.end() && "No such label to jump to");
+
+    // The offset is counted from the end of the instruction
+    const auto diff{static_cast<uint32_t>(label->m_offset - (offset + 4))};
+    const ByteArray bytes{diff};
+
+    // Overwrite the instruction
+    for (size_t i = 0; i < bytes.size(); i++) {
+      m_textSection.insert(i + offset, bytes.data()[i]);
+    }
+  }
+
   // Patch calls
-  for (const auto &[name, offset] : m_calls) {
+  for (const auto &[symbol, offset] : m_calls) {
     const auto label = std::find_if(m_labels.begin(), m_labels.end(),
-                                    [&](const auto &l) { return l.m_name == name; });
+                                    [&](const auto &l) { return l.m_symbol == symbol; });
     assert(label != m_labels.end() && "No such label to call");
 
     // The offset of the position is a byte
@@ -146,60 +184,59 @@ void CodeGenerator::generate(const std::vector<InstructionPtr> &instructions) {
   }
 }
 
-void CodeGenerator::emitLea(const InstructionPtr &instruction) {
-  const auto &target = instruction->getTarget();
-  const auto &argOne = instruction->getArg1();
+void CodeGenerator::emitLea(const Instruction &instruction) {
+  const auto target = instruction.getTarget();
+  const auto argOne = instruction.getArg1();
 
   // lea reg, [rsp + number]
-  if (target->getType() == TType::REGISTER && argOne->isLiteralIntegerType()) {
-    const auto bytes = MachineCodeTable<uint32_t>::getLeaMachineCode(target->getValue<Basic::register_t>());
+  if (target.getType() == TType::REGISTER && argOne.isLiteralIntegerType()) {
+    const auto bytes = MachineCodeTable<uint32_t>::getLeaMachineCode(target.getValue<Basic::register_t>());
     m_textSection.putBytes(bytes);
-    m_textSection.putValue<uint32_t>(argOne->getValue<int>());
+    m_textSection.putValue<uint32_t>(argOne.getValue<int>());
     return;
   }
 
   throw CodeGenerationError{"Unknown lea instruction"};
 }
 
-void CodeGenerator::emitMove(const InstructionPtr &instruction, const bool label) {
-  const auto &target = instruction->getTarget();
-  const auto &argOne = instruction->getArg1();
+void CodeGenerator::emitMove(const Instruction &instruction, const bool label) {
+  const auto target = instruction.getTarget();
+  const auto argOne = instruction.getArg1();
 
   // mov reg, number
-  if (target->getType() == TType::REGISTER && (argOne->isLiteralIntegerType() || argOne->getType() == TType::LIT_BOOL)) {
-    const auto bytes = MachineCodeTable<uint32_t>::getMovMachineCode(target->getValue<Basic::register_t>());
+  if (target.getType() == TType::REGISTER && (argOne.isLiteralIntegerType() || argOne.getType() == TType::LIT_BOOL)) {
+    const auto bytes = MachineCodeTable<uint32_t>::getMovMachineCode(target.getValue<Basic::register_t>());
     m_textSection.putBytes(bytes);
     if (label) {
-      m_data.emplace_back(Data{m_textSection.size(), static_cast<size_t>(argOne->getValue<int>())});
+      m_data.emplace_back(Data{m_textSection.size(), static_cast<size_t>(argOne.getValue<int>())});
     }
-    const auto value = argOne->isLiteralIntegerType() ? argOne->getValue<int>() : (argOne->getValue<bool>() ? 1 : 0);
+    const auto value = argOne.isLiteralIntegerType() ? argOne.getValue<int>() : (argOne.getValue<bool>() ? 1 : 0);
     m_textSection.putValue<uint32_t>(value);
     return;
   }
 
   // mov reg, bool
-  if (target->getType() == TType::REGISTER && (argOne->getType() == TType::KW_TRUE || argOne->getType() == TType::KW_FALSE)) {
-    const auto bytes = MachineCodeTable<uint32_t>::getMovMachineCode(target->getValue<Basic::register_t>());
+  if (target.getType() == TType::REGISTER && (argOne.getType() == TType::KW_TRUE || argOne.getType() == TType::KW_FALSE)) {
+    const auto bytes = MachineCodeTable<uint32_t>::getMovMachineCode(target.getValue<Basic::register_t>());
     m_textSection.putBytes(bytes);
-    m_textSection.putValue<uint32_t>(argOne->getValue<bool>() ? 1 : 0);
+    m_textSection.putValue<uint32_t>(argOne.getValue<bool>() ? 1 : 0);
     return;
   }
 
   // mov reg, string
-  if (target->getType() == TType::REGISTER && argOne->getType() == TType::LIT_STR) {
-    auto strVal = argOne->getValue<std::string>();
+  if (target.getType() == TType::REGISTER && argOne.getType() == TType::LIT_STR) {
+    const auto strVal = argOne.getValue<std::string_view>();
     for (const auto ch : strVal) {
       m_dataSection.putBytes(std::byte(ch));
     }
-    argOne->setType(TType::LIT_INT);
-    argOne->setValue(std::abs(static_cast<int>(m_dataSection.size() - strVal.size())));
-    emitMove(instruction, true);
+    const auto offset = std::abs(static_cast<int>(m_dataSection.size() - strVal.size()));
+    emitMove(Instruction{Operation::MOV, target, Operand{TType::LIT_INT, offset}}, true);
     return;
   }
 
   // mov reg1, reg2
-  if (target->getType() == TType::REGISTER && argOne->getType() == TType::REGISTER) {
-    const auto [src, dst] = assignRegisters(argOne->getValue<Basic::register_t>(), target->getValue<Basic::register_t>());
+  if (target.getType() == TType::REGISTER && argOne.getType() == TType::REGISTER) {
+    const auto [src, dst] = assignRegisters(argOne.getValue<Basic::register_t>(), target.getValue<Basic::register_t>());
     assert((src > -1 && dst > -1) && "Failed to look up registers for mov instruction");
 
     // <-        rax       ...       r15
@@ -233,14 +270,14 @@ void CodeGenerator::emitMove(const InstructionPtr &instruction, const bool label
   throw CodeGenerationError{"Unknown mov instruction"};
 }
 
-void CodeGenerator::emitMoveMemory(const InstructionPtr &instruction) {
-  const auto &target = instruction->getTarget();
-  const auto &argOne = instruction->getArg1();
+void CodeGenerator::emitMoveMemory(const Instruction &instruction) {
+  const auto target = instruction.getTarget();
+  const auto argOne = instruction.getArg1();
 
   // mov [rsi], dl
-  if (target->getType() == TType::REGISTER && argOne->getType() == TType::REGISTER &&
-      target->getValue<Basic::register_t>() == RSI &&
-      argOne->getValue<Basic::register_t>() == DL) {
+  if (target.getType() == TType::REGISTER && argOne.getType() == TType::REGISTER &&
+      target.getValue<Basic::register_t>() == RSI &&
+      argOne.getValue<Basic::register_t>() == DL) {
     m_textSection.putBytes(std::byte{0x88}, std::byte{0x16});
     return;
   }
@@ -248,15 +285,25 @@ void CodeGenerator::emitMoveMemory(const InstructionPtr &instruction) {
   throw CodeGenerationError{"Unknown mov memory instruction"};
 }
 
+void CodeGenerator::emitLoad(const Instruction &instruction) {
+  // mov reg, [rsp + offset]
+  m_textSection.putBytes(getStackSlotMachineCode(std::byte{0x8b}, instruction.getTarget(), instruction.getArg1()));
+}
+
+void CodeGenerator::emitStore(const Instruction &instruction) {
+  // mov [rsp + offset], reg
+  m_textSection.putBytes(getStackSlotMachineCode(std::byte{0x89}, instruction.getArg1(), instruction.getTarget()));
+}
+
 void CodeGenerator::emitSysCall() {
   m_textSection.putBytes(std::byte{0x0f}, std::byte{0x05});
 }
 
-void CodeGenerator::emitPush(const InstructionPtr &instruction) {
+void CodeGenerator::emitPush(const Instruction &instruction) {
   // push reg
-  if (instruction->getArg1()->getType() == TType::REGISTER) {
+  if (instruction.getArg1().getType() == TType::REGISTER) {
 
-    const auto reg = instruction->getArg1()->getValue<Basic::register_t>();
+    const auto reg = instruction.getArg1().getValue<Basic::register_t>();
     const auto pushMachineCode = [&reg]() -> ByteArray {
       switch (reg) {
         case RAX: return {std::byte{0x50}};
@@ -286,11 +333,11 @@ void CodeGenerator::emitPush(const InstructionPtr &instruction) {
   throw CodeGenerationError{"Unknown push instruction"};
 }
 
-void CodeGenerator::emitPop(const InstructionPtr &instruction) {
+void CodeGenerator::emitPop(const Instruction &instruction) {
   // pop reg
-  if (instruction->getArg1()->getType() == TType::REGISTER) {
+  if (instruction.getArg1().getType() == TType::REGISTER) {
 
-    const auto reg = instruction->getArg1()->getValue<Basic::register_t>();
+    const auto reg = instruction.getArg1().getValue<Basic::register_t>();
     const auto popMachineCode = [&reg]() -> ByteArray {
       switch (reg) {
         case RAX: return {std::byte{0x58}};
@@ -320,46 +367,46 @@ void CodeGenerator::emitPop(const InstructionPtr &instruction) {
   throw CodeGenerationError{"Unknown pop instruction"};
 }
 
-void CodeGenerator::emitCall(const InstructionPtr &instruction) {
+void CodeGenerator::emitCall(const Instruction &instruction) {
   m_textSection.putBytes(std::byte{0xe8});
 
   // call label
-  const auto &label{instruction->getTarget()->getValue<std::string>()};
+  const auto label{instruction.getTarget().getSymbol()};
   const auto offset{m_textSection.size()};
   m_calls.emplace_back(Label{label, offset});
 
   m_textSection.putValue<uint32_t>(0);
 }
 
-void CodeGenerator::emitLabel(const InstructionPtr &instruction) {
-  const auto &label = instruction->getArg1()->getValue<std::string>();
+void CodeGenerator::emitLabel(const Instruction &instruction) {
+  const auto label = instruction.getArg1().getSymbol();
   const auto offset = m_textSection.size();
   m_labels.emplace_back(Label{label, offset});
 }
 
-void CodeGenerator::emitCmp(const InstructionPtr &instruction) {
-  const auto &argOne = instruction->getArg1();
-  const auto &argTwo = instruction->getArg2();
+void CodeGenerator::emitCmp(const Instruction &instruction) {
+  const auto argOne = instruction.getArg1();
+  const auto argTwo = instruction.getArg2();
 
   // cmp reg, number
-  if (argOne->getType() == TType::REGISTER && argTwo->isLiteralIntegerType()) {
-    const auto bytes = MachineCodeTable<uint32_t>::getCmpMachineCode(argOne->getValue<Basic::register_t>());
+  if (argOne.getType() == TType::REGISTER && argTwo.isLiteralIntegerType()) {
+    const auto bytes = MachineCodeTable<uint32_t>::getCmpMachineCode(argOne.getValue<Basic::register_t>());
     m_textSection.putBytes(bytes);
-    m_textSection.putValue<uint32_t>(argTwo->getValue<int>());
+    m_textSection.putValue<uint32_t>(argTwo.getValue<int>());
     return;
   }
 
   // cmp reg, bool
-  if (argOne->getType() == TType::REGISTER && (argTwo->getType() == TType::KW_TRUE || argTwo->getType() == TType::KW_FALSE)) {
-    const auto bytes = MachineCodeTable<uint32_t>::getCmpMachineCode(argOne->getValue<Basic::register_t>());
+  if (argOne.getType() == TType::REGISTER && (argTwo.getType() == TType::KW_TRUE || argTwo.getType() == TType::KW_FALSE)) {
+    const auto bytes = MachineCodeTable<uint32_t>::getCmpMachineCode(argOne.getValue<Basic::register_t>());
     m_textSection.putBytes(bytes);
-    m_textSection.putValue<uint32_t>(argTwo->getValue<bool>() ? 1 : 0);
+    m_textSection.putValue<uint32_t>(argTwo.getValue<bool>() ? 1 : 0);
     return;
   }
 
   // cmp reg1, reg2
-  if (argOne->getType() == TType::REGISTER && argTwo->getType() == TType::REGISTER) {
-    const auto [dst, src] = assignRegisters(argOne->getValue<Basic::register_t>(), argTwo->getValue<Basic::register_t>());
+  if (argOne.getType() == TType::REGISTER && argTwo.getType() == TType::REGISTER) {
+    const auto [dst, src] = assignRegisters(argOne.getValue<Basic::register_t>(), argTwo.getValue<Basic::register_t>());
     assert((src > -1 && dst > -1) && "Failed to look up registers for cmp instruction");
 
     // cmp       rax       ...       r15
@@ -393,24 +440,60 @@ void CodeGenerator::emitCmp(const InstructionPtr &instruction) {
   throw CodeGenerationError{"Unknown cmp instruction"};
 }
 
-void CodeGenerator::emitCmpBytePtr(const InstructionPtr &instruction) {
-  const auto &argOne = instruction->getArg1();
-  const auto &argTwo = instruction->getArg2();
+void CodeGenerator::emitCmpBytePtr(const Instruction &instruction) {
+  const auto argOne = instruction.getArg1();
+  const auto argTwo = instruction.getArg2();
 
   // cmp byte ptr [reg], number
-  if (argOne->getType() == TType::REGISTER) {
-    const auto bytes = MachineCodeTable<uint8_t>::getCmpPtrMachineCode(argOne->getValue<Basic::register_t>());
+  if (argOne.getType() == TType::REGISTER) {
+    const auto bytes = MachineCodeTable<uint8_t>::getCmpPtrMachineCode(argOne.getValue<Basic::register_t>());
     m_textSection.putBytes(bytes);
-    m_textSection.putBytes(std::byte(argTwo->getValue<int>()));
+    m_textSection.putBytes(std::byte(argTwo.getValue<int>()));
     return;
   }
 
   throw CodeGenerationError{"Unknown cmp byte ptr instruction"};
 }
 
-void CodeGenerator::emitJmp(const InstructionPtr &instruction) {
+void CodeGenerator::emitJmp(const Instruction &instruction) {
+  const auto label = instruction.getArg1().getSymbol();
+  const auto target = std::find_if(m_labels.begin(), m_labels.end(),
+                                   [&](const auto &l) { return l.m_symbol == label; });
+
+  // A jump back to a label within reach takes a single byte for its offset, and any other jump
+  // four, since how far ahead its label lies isn't known yet
+  if (target == m_labels.end() || m_textSection.size() + 2 - target->m_offset > 128) {
+    const auto getNearOperandBytes = [&]() -> ByteArray {
+      switch (instruction.getOperation()) {
+        case Operation::JMP:
+          return {std::byte{0xe9}};
+        case Operation::JE:
+        case Operation::JZ:
+          return {std::byte{0x0f}, std::byte{0x84}};
+        case Operation::JLE:
+          return {std::byte{0x0f}, std::byte{0x8e}};
+        case Operation::JG:
+          return {std::byte{0x0f}, std::byte{0x8f}};
+        case Operation::JNE:
+        case Operation::JNZ:
+          return {std::byte{0x0f}, std::byte{0x85}};
+        case Operation::JL:
+          return {std::byte{0x0f}, std::byte{0x8c}};
+        case Operation::JGE:
+          return {std::byte{0x0f}, std::byte{0x8d}};
+        default:
+          throw CodeGenerationError{"Unknown jump instruction"};
+      }
+    };
+
+    m_textSection.putBytes(getNearOperandBytes());
+    m_nearJumps.emplace_back(Label{label, m_textSection.size()});
+    m_textSection.putValue<uint32_t>(0);
+    return;
+  }
+
   const auto getOperandByte = [&]() -> std::byte {
-    switch (instruction->getOperation()) {
+    switch (instruction.getOperation()) {
       case Operation::JMP:
         return std::byte{0xeb};
       case Operation::JE:
@@ -433,17 +516,16 @@ void CodeGenerator::emitJmp(const InstructionPtr &instruction) {
   };
 
   m_textSection.putBytes(getOperandByte());
-  const auto &label = instruction->getArg1()->getValue<std::string>();
   const auto offset = m_textSection.size();
   m_jumps.emplace_back(Label{label, offset});
   m_textSection.putBytes(std::byte{0x00});
 }
 
-void CodeGenerator::emitInc(const InstructionPtr &instruction) {
+void CodeGenerator::emitInc(const Instruction &instruction) {
   // inc reg
-  if (instruction->getArg1()->getType() == TType::REGISTER) {
+  if (instruction.getArg1().getType() == TType::REGISTER) {
 
-    const auto reg = instruction->getArg1()->getValue<Basic::register_t>();
+    const auto reg = instruction.getArg1().getValue<Basic::register_t>();
     const auto incMachineCode = [&reg]() -> ByteArray {
       switch (reg) {
         case RAX: return {std::byte{0x48}, std::byte{0xff}, std::byte{0xc0}};
@@ -473,11 +555,11 @@ void CodeGenerator::emitInc(const InstructionPtr &instruction) {
   throw CodeGenerationError{"Unknown inc instruction"};
 }
 
-void CodeGenerator::emitDec(const InstructionPtr &instruction) {
+void CodeGenerator::emitDec(const Instruction &instruction) {
   // dec reg
-  if (instruction->getArg1()->getType() == TType::REGISTER) {
+  if (instruction.getArg1().getType() == TType::REGISTER) {
 
-    const auto reg = instruction->getArg1()->getValue<Basic::register_t>();
+    const auto reg = instruction.getArg1().getValue<Basic::register_t>();
     const auto decMachineCode = [&reg]() -> ByteArray {
       switch (reg) {
         case RAX: return {std::byte{0x48}, std::byte{0xff}, std::byte{0xc8}};
@@ -507,21 +589,21 @@ void CodeGenerator::emitDec(const InstructionPtr &instruction) {
   throw CodeGenerationError{"Unknown dec instruction"};
 }
 
-void CodeGenerator::emitAdd(const InstructionPtr &instruction) {
-  const auto &target = instruction->getTarget();
-  const auto &argOne = instruction->getArg1();
+void CodeGenerator::emitAdd(const Instruction &instruction) {
+  const auto target = instruction.getTarget();
+  const auto argOne = instruction.getArg1();
 
   // add reg, number
-  if (target->getType() == TType::REGISTER && argOne->isLiteralIntegerType()) {
-    const auto bytes = MachineCodeTable<uint32_t>::getAddMachineCode(target->getValue<Basic::register_t>());
+  if (target.getType() == TType::REGISTER && argOne.isLiteralIntegerType()) {
+    const auto bytes = MachineCodeTable<uint32_t>::getAddMachineCode(target.getValue<Basic::register_t>());
     m_textSection.putBytes(bytes);
-    m_textSection.putValue<uint32_t>(argOne->getValue<int>());
+    m_textSection.putValue<uint32_t>(argOne.getValue<int>());
     return;
   }
 
   // add reg1, reg2
-  if (target->getType() == TType::REGISTER && argOne->getType() == TType::REGISTER) {
-    const auto [src, dst] = assignRegisters(argOne->getValue<Basic::register_t>(), target->getValue<Basic::register_t>());
+  if (target.getType() == TType::REGISTER && argOne.getType() == TType::REGISTER) {
+    const auto [src, dst] = assignRegisters(argOne.getValue<Basic::register_t>(), target.getValue<Basic::register_t>());
     assert((src > -1 && dst > -1) && "Failed to look up registers for add instruction");
 
     //  +        rax       ...       r15
@@ -555,29 +637,29 @@ void CodeGenerator::emitAdd(const InstructionPtr &instruction) {
   throw CodeGenerationError{"Unknown add instruction"};
 }
 
-void CodeGenerator::emitSub(const InstructionPtr &instruction) {
-  const auto &target = instruction->getTarget();
-  const auto &argOne = instruction->getArg1();
+void CodeGenerator::emitSub(const Instruction &instruction) {
+  const auto target = instruction.getTarget();
+  const auto argOne = instruction.getArg1();
 
   // sub reg, number
-  if (target->getType() == TType::REGISTER && argOne->isLiteralIntegerType()) {
-    const auto bytes = MachineCodeTable<uint32_t>::getSubMachineCode(target->getValue<Basic::register_t>());
+  if (target.getType() == TType::REGISTER && argOne.isLiteralIntegerType()) {
+    const auto bytes = MachineCodeTable<uint32_t>::getSubMachineCode(target.getValue<Basic::register_t>());
     m_textSection.putBytes(bytes);
-    m_textSection.putValue<uint32_t>(argOne->getValue<int>());
+    m_textSection.putValue<uint32_t>(argOne.getValue<int>());
     return;
   }
 
   // sub edx, esi
-  if (target->getType() == TType::REGISTER && argOne->getType() == TType::REGISTER &&
-      target->getValue<Basic::register_t>() == EDX &&
-      argOne->getValue<Basic::register_t>() == ESI) {
+  if (target.getType() == TType::REGISTER && argOne.getType() == TType::REGISTER &&
+      target.getValue<Basic::register_t>() == EDX &&
+      argOne.getValue<Basic::register_t>() == ESI) {
     m_textSection.putBytes(std::byte{0x29}, std::byte{0xf2});
     return;
   }
 
   // sub reg1, reg2
-  if (target->getType() == TType::REGISTER && argOne->getType() == TType::REGISTER) {
-    const auto [src, dst] = assignRegisters(argOne->getValue<Basic::register_t>(), target->getValue<Basic::register_t>());
+  if (target.getType() == TType::REGISTER && argOne.getType() == TType::REGISTER) {
+    const auto [src, dst] = assignRegisters(argOne.getValue<Basic::register_t>(), target.getValue<Basic::register_t>());
     assert((src > -1 && dst > -1) && "Failed to look up registers for sub instruction");
 
     //  -        rax       ...       r15
@@ -611,21 +693,21 @@ void CodeGenerator::emitSub(const InstructionPtr &instruction) {
   throw CodeGenerationError{"Unknown sub instruction"};
 }
 
-void CodeGenerator::emitMul(const InstructionPtr &instruction) {
-  const auto &target = instruction->getTarget();
-  const auto &argOne = instruction->getArg1();
+void CodeGenerator::emitMul(const Instruction &instruction) {
+  const auto target = instruction.getTarget();
+  const auto argOne = instruction.getArg1();
 
   // imul reg, number
-  if (target->getType() == TType::REGISTER && argOne->isLiteralIntegerType()) {
-    const auto bytes = MachineCodeTable<uint32_t>::getMulMachineCode(target->getValue<Basic::register_t>());
+  if (target.getType() == TType::REGISTER && argOne.isLiteralIntegerType()) {
+    const auto bytes = MachineCodeTable<uint32_t>::getMulMachineCode(target.getValue<Basic::register_t>());
     m_textSection.putBytes(bytes);
-    m_textSection.putValue<uint32_t>(argOne->getValue<int>());
+    m_textSection.putValue<uint32_t>(argOne.getValue<int>());
     return;
   }
 
   // imul reg1, reg2
-  if (target->getType() == TType::REGISTER && argOne->getType() == TType::REGISTER) {
-    const auto [src, dst] = assignRegisters(argOne->getValue<Basic::register_t>(), target->getValue<Basic::register_t>());
+  if (target.getType() == TType::REGISTER && argOne.getType() == TType::REGISTER) {
+    const auto [src, dst] = assignRegisters(argOne.getValue<Basic::register_t>(), target.getValue<Basic::register_t>());
     assert((src > -1 && dst > -1) && "Failed to look up registers for imul instruction");
 
     //  *        rax       ...       r15
@@ -659,11 +741,11 @@ void CodeGenerator::emitMul(const InstructionPtr &instruction) {
   throw CodeGenerationError{"Unknown imul instruction"};
 }
 
-void CodeGenerator::emitDiv(const InstructionPtr &instruction) {
+void CodeGenerator::emitDiv(const Instruction &instruction) {
   // div reg
-  if (instruction->getArg1()->getType() == TType::REGISTER) {
+  if (instruction.getArg1().getType() == TType::REGISTER) {
 
-    const auto reg = instruction->getArg1()->getValue<Basic::register_t>();
+    const auto reg = instruction.getArg1().getValue<Basic::register_t>();
     const auto divMachineCode = [&reg]() -> ByteArray {
       switch (reg) {
         case RAX: return {std::byte{0x48}, std::byte{0xf7}, std::byte{0xf0}};
@@ -693,15 +775,15 @@ void CodeGenerator::emitDiv(const InstructionPtr &instruction) {
   throw CodeGenerationError{"Unknown div instruction"};
 }
 
-void CodeGenerator::emitXor(const InstructionPtr &instruction) {
-  const auto &argOne = instruction->getArg1();
-  const auto &argTwo = instruction->getArg2();
+void CodeGenerator::emitXor(const Instruction &instruction) {
+  const auto argOne = instruction.getArg1();
+  const auto argTwo = instruction.getArg2();
 
   // xor reg, reg
-  if (argOne->getType() == TType::REGISTER && argTwo->getType() == TType::REGISTER &&
-      argOne->getValue<Basic::register_t>() == argTwo->getValue<Basic::register_t>()) {
+  if (argOne.getType() == TType::REGISTER && argTwo.getType() == TType::REGISTER &&
+      argOne.getValue<Basic::register_t>() == argTwo.getValue<Basic::register_t>()) {
 
-    const auto reg = argOne->getValue<Basic::register_t>();
+    const auto reg = argOne.getValue<Basic::register_t>();
     const auto xorMachineCode = [&reg]() -> ByteArray {
       switch (reg) {
         case RAX: return {std::byte{0x48}, std::byte{0x31}, std::byte{0xc0}};
@@ -732,15 +814,15 @@ void CodeGenerator::emitXor(const InstructionPtr &instruction) {
   throw CodeGenerationError{"Unknown xor instruction"};
 }
 
-void CodeGenerator::emitTest(const InstructionPtr &instruction) {
-  const auto &argOne = instruction->getArg1();
-  const auto &argTwo = instruction->getArg2();
+void CodeGenerator::emitTest(const Instruction &instruction) {
+  const auto argOne = instruction.getArg1();
+  const auto argTwo = instruction.getArg2();
 
   // test reg, reg
-  if (argOne->getType() == TType::REGISTER && argTwo->getType() == TType::REGISTER &&
-      argOne->getValue<Basic::register_t>() == argTwo->getValue<Basic::register_t>()) {
+  if (argOne.getType() == TType::REGISTER && argTwo.getType() == TType::REGISTER &&
+      argOne.getValue<Basic::register_t>() == argTwo.getValue<Basic::register_t>()) {
 
-    const auto reg = argOne->getValue<Basic::register_t>();
+    const auto reg = argOne.getValue<Basic::register_t>();
     const auto testMachineCode = [&reg]() -> ByteArray {
       switch (reg) {
         case RAX: return {std::byte{0x48}, std::byte{0x85}, std::byte{0xc0}};
@@ -4,56 +4,55 @@
 #ifndef WISNIALANG_CODE_GENERATOR_HPP
 #define WISNIALANG_CODE_GENERATOR_HPP
 
-#include <memory>
 #include <vector>
 // Wisnia
 #include "ByteArray.hpp"
+#include "Instruction.hpp"
+#include "StringInterner.hpp"
 
 namespace Wisnia {
-class Instruction;
 
 class CodeGenerator {
-  using InstructionPtr = std::shared_ptr<Instruction>;
-
   struct Data {
     size_t m_start;
     size_t m_offset;
   };
 
   struct Label {
-    std::string m_name;
+    Basic::SymbolId m_symbol;
     size_t m_offset;
   };
 
  public:
   const ByteArray &getTextSection() const { return m_textSection; }
   const ByteArray &getDataSection() const { return m_dataSection; }
-  void generate(const std::vector<InstructionPtr> &instructions);
+  void generate(const std::vector<Instruction> &instructions);
 
  private:
-  void emitLea(const InstructionPtr &instruction);
-  void emitMove(const InstructionPtr &instruction, bool label = false);
-  void emitMoveMemory(const InstructionPtr &instruction);
+  void emitLea(const Instruction &instruction);
+  void emitMove(const Instruction &instruction, bool label = false);
+  void emitMoveMemory(const Instruction &instruction);
+  void emitLoad(const Instruction &instruction);
+  void emitStore(const Instruction &instruction);
   void emitSysCall();
-  void emitPush(const InstructionPtr &instruction);
-  void emitPop(const InstructionPtr &instruction);
-  void emitCall(const InstructionPtr &instruction);
-  void emitLabel(const InstructionPtr &instruction);
-  void emitCmp(const InstructionPtr &instruction);
-  void emitCmpBytePtr(const InstructionPtr &instruction);
-  void emitJmp(const InstructionPtr &instruction);
-  void emitInc(const InstructionPtr &instruction);
-  void emitDec(const InstructionPtr &instruction);
-  void emitAdd(const InstructionPtr &instruction);
-  void emitSub(const InstructionPtr &instruction);
-  void emitMul(const InstructionPtr &instruction);
-  void emitDiv(const InstructionPtr &instruction);
-  void emitXor(const InstructionPtr &instruction);
-  void emitTest(const InstructionPtr &instruction);
+  void emitPush(const Instruction &instruction);
+  void emitPop(const Instruction &instruction);
+  void emitCall(const Instruction &instruction);
+  void emitLabel(const Instruction &instruction);
+  void emitCmp(const Instruction &instruction);
+  void emitCmpBytePtr(const Instruction &instruction);
+  void emitJmp(const Instruction &instruction);
+  void emitInc(const Instruction &instruction);
+  void emitDec(const Instruction &instruction);
+  void emitAdd(const Instruction &instruction);
+  void emitSub(const Instruction &instruction);
+  void emitMul(const Instruction &instruction);
+  void emitDiv(const Instruction &instruction);
+  void emitXor(const Instruction &instruction);
+  void emitTest(const Instruction &instruction);
   void emitRet();
 
  private:
-  std::vector<InstructionPtr> m_instructions;
   ByteArray m_textSection;
   ByteArray m_dataSection;
   std::vector<size_t> m_dataOffsets;
@@ -61,6 +60,7 @@ class CodeGenerator {
   std::vector<Label> m_labels;
   std::vector<Label> m_calls;
   std::vector<Label> m_jumps;
+  std::vector<Label> m_nearJumps;
 };
 
 }  // namespace Wisnia
@@ -71,8 +71,9 @@ ByteArray ELF::generateELF() const {
   elfData.putValue<uint64_t>(0);                    // Offset from the beginning of the file
   elfData.putValue<uint64_t>(kVirtualStartAddress); // Virtual address
   elfData.putValue<uint64_t>(kVirtualStartAddress); // Physical address
-  elfData.putValue<uint64_t>(textSize);             // Number of bytes in file image of segment
-  elfData.putValue<uint64_t>(textSize);             // Number of bytes in memory image of segment
+  // The segment starts at the beginning of the file, so it spans the headers too
+  elfData.putValue<uint64_t>(kTextOffset + textSize); // Number of bytes in file image of segment
+  elfData.putValue<uint64_t>(kTextOffset + textSize); // Number of bytes in memory image of segment
   elfData.putValue<uint64_t>(kAlignment);           // Alignment
 
   // Build program header: data segment
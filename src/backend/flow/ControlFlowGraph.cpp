@@ -0,0 +1,76 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <algorithm>
+#include <unordered_map>
+// Wisnia
+#include "ControlFlowGraph.hpp"
+
+using namespace Wisnia;
+using namespace Basic;
+
+ControlFlowGraph::ControlFlowGraph(const std::span<const Instruction> function) {
+  // A new block starts at every label and after every jump or return
+  std::unordered_map<SymbolId, Index> labels{};
+  for (size_t i = 0; i < function.size(); i++) {
+    const auto &instruction = function[i];
+    if (instruction.getOperation() == Operation::LABEL && !m_blocks.empty() && m_blocks.back().m_end != i) {
+      m_blocks.back().m_end = i;
+    }
+    if (m_blocks.empty() || m_blocks.back().m_end == i) {
+      m_blocks.push_back({i, function.size()});
+    }
+    if (instruction.getOperation() == Operation::LABEL) {
+      labels.emplace(instruction.getArg1().getSymbol(), m_blocks.size() - 1);
+    }
+    if (instruction.isJump() || instruction.getOperation() == Operation::RET) {
+      m_blocks.back().m_end = i + 1;
+    }
+  }
+
+  for (Index index = 0; index < m_blocks.size(); index++) {
+    const auto &last = function[m_blocks[index].m_end - 1];
+    if (last.isJump()) {
+      const auto target = labels.find(last.getArg1().getSymbol());
+      if (target == labels.end()) {
+        throw InstructionError{"Jump to the unknown label " + last.getArg1().getValueStr()};
+      }
+      addEdge(index, target->second);
+    }
+    const bool fallsThrough = !last.isJump() || last.isConditionalJump();
+    if (fallsThrough && last.getOperation() != Operation::RET && index + 1 < m_blocks.size()) {
+      addEdge(index, index + 1);
+    }
+  }
+
+  // Number the blocks in postorder with a depth-first search from the entry
+  m_reachable.assign(m_blocks.size(), false);
+  if (m_blocks.empty()) {
+    return;
+  }
+  std::vector<std::pair<Index, size_t>> pending{{kEntry, 0}};
+  m_reachable[kEntry] = true;
+  while (!pending.empty()) {
+    auto &[block, next] = pending.back();
+    if (next < m_blocks[block].m_successors.size()) {
+      const Index successor = m_blocks[block].m_successors[next++];
+      if (!m_reachable[successor]) {
+        m_reachable[successor] = true;
+        pending.emplace_back(successor, 0);
+      }
+    } else {
+      m_reversePostorder.push_back(block);
+      pending.pop_back();
+    }
+  }
+  std::ranges::reverse(m_reversePostorder);
+}
+
+void ControlFlowGraph::addEdge(const Index from, const Index to) {
+  // A conditional jump to the very next block is a single edge
+  auto &successors = m_blocks[from].m_successors;
+  if (std::ranges::find(successors, to) == successors.end()) {
+    successors.push_back(to);
+    m_blocks[to].m_predecessors.push_back(from);
+  }
+}
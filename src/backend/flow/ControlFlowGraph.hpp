@@ -0,0 +1,54 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_CONTROL_FLOW_GRAPH_HPP
+#define WISNIALANG_CONTROL_FLOW_GRAPH_HPP
+
+#include <span>
+#include <vector>
+// Wisnia
+#include "Instruction.hpp"
+
+namespace Wisnia {
+
+// The basic blocks of a function and the edges between them. A block starts at a label or after a
+// jump, and ends with a jump, a return, or right before the next label. Blocks refer to the
+// instructions of the function by their positions, so the graph doesn't keep the instructions
+class ControlFlowGraph {
+ public:
+  using Index = size_t;
+  static constexpr Index kEntry{0};
+
+  struct BasicBlock {
+    // The instructions [m_begin, m_end) of the function
+    size_t m_begin, m_end;
+    std::vector<Index> m_predecessors{};
+    // The target of a jump comes first, followed by the next block if control can fall through
+    std::vector<Index> m_successors{};
+  };
+
+  explicit ControlFlowGraph(std::span<const Instruction> function);
+
+  const std::vector<BasicBlock> &getBlocks() const { return m_blocks; }
+  const BasicBlock &getBlock(const Index index) const { return m_blocks[index]; }
+
+  // The blocks that can be reached from the entry, in reverse postorder
+  const std::vector<Index> &getReversePostorder() const { return m_reversePostorder; }
+  bool isReachable(const Index index) const { return m_reachable[index]; }
+
+  // Whether the edge leaves a block with several successors for a block with several predecessors
+  bool isCriticalEdge(const Index from, const Index to) const {
+    return m_blocks[from].m_successors.size() > 1 && m_blocks[to].m_predecessors.size() > 1;
+  }
+
+ private:
+  void addEdge(Index from, Index to);
+
+  std::vector<BasicBlock> m_blocks;
+  std::vector<Index> m_reversePostorder;
+  std::vector<bool> m_reachable;
+};
+
+}  // namespace Wisnia
+
+#endif  // WISNIALANG_CONTROL_FLOW_GRAPH_HPP
@@ -0,0 +1,95 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <algorithm>
+#include <ranges>
+// Wisnia
+#include "DominatorTree.hpp"
+
+using namespace Wisnia;
+
+// "A Simple, Fast Dominance Algorithm" by Cooper, Harvey and Kennedy
+// https://www.cs.rice.edu/~keith/EMBED/dom.pdf
+DominatorTree::DominatorTree(const ControlFlowGraph &graph) {
+  const auto &blocks = graph.getBlocks();
+  const auto &order = graph.getReversePostorder();
+  m_immediateDominators.assign(blocks.size(), kNone);
+  m_children.resize(blocks.size());
+  m_frontiers.resize(blocks.size());
+  m_preorder.assign(blocks.size(), kNone);
+  m_postorder.assign(blocks.size(), kNone);
+  if (order.empty()) {
+    return;
+  }
+
+  // Position of each block in reverse postorder, which the two fingers of `intersect` walk up by
+  std::vector<size_t> position(blocks.size(), kNone);
+  for (size_t i = 0; i < order.size(); i++) {
+    position[order[i]] = i;
+  }
+  const auto intersect = [&](Index a, Index b) {
+    while (a != b) {
+      while (position[a] > position[b]) a = m_immediateDominators[a];
+      while (position[b] > position[a]) b = m_immediateDominators[b];
+    }
+    return a;
+  };
+
+  m_immediateDominators[ControlFlowGraph::kEntry] = ControlFlowGraph::kEntry;
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (const auto block : order | std::views::drop(1)) {
+      Index dominator{kNone};
+      for (const auto predecessor : blocks[block].m_predecessors) {
+        if (m_immediateDominators[predecessor] == kNone) {
+          continue;
+        }
+        dominator = dominator == kNone ? predecessor : intersect(predecessor, dominator);
+      }
+      if (m_immediateDominators[block] != dominator) {
+        m_immediateDominators[block] = dominator;
+        changed = true;
+      }
+    }
+  }
+
+  for (const auto block : order | std::views::drop(1)) {
+    m_children[m_immediateDominators[block]].push_back(block);
+  }
+
+  // Definitions in a predecessor of a join block reach the join block through the predecessor's
+  // dominators, up to the join block's immediate dominator
+  for (const auto block : order) {
+    const auto &predecessors = blocks[block].m_predecessors;
+    if (predecessors.size() < 2) {
+      continue;
+    }
+    for (auto runner : predecessors) {
+      if (!graph.isReachable(runner)) {
+        continue;
+      }
+      while (runner != m_immediateDominators[block]) {
+        auto &frontier = m_frontiers[runner];
+        if (std::ranges::find(frontier, block) == frontier.end()) {
+          frontier.push_back(block);
+        }
+        runner = m_immediateDominators[runner];
+      }
+    }
+  }
+
+  size_t preorder{0}, postorder{0};
+  std::vector<std::pair<Index, size_t>> pending{{ControlFlowGraph::kEntry, 0}};
+  m_preorder[ControlFlowGraph::kEntry] = preorder++;
+  while (!pending.empty()) {
+    auto &[block, next] = pending.back();
+    if (next < m_children[block].size()) {
+      const Index child = m_children[block][next++];
+      m_preorder[child] = preorder++;
+      pending.emplace_back(child, 0);
+    } else {
+      m_postorder[block] = postorder++;
+      pending.pop_back();
+    }
+  }
+}
@@ -0,0 +1,53 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_DOMINATOR_TREE_HPP
+#define WISNIALANG_DOMINATOR_TREE_HPP
+
+#include <optional>
+#include <vector>
+// Wisnia
+#include "ControlFlowGraph.hpp"
+
+namespace Wisnia {
+
+// A block dominates another if every path from the entry to the other block goes through it. Only
+// the blocks that can be reached from the entry are part of the tree
+class DominatorTree {
+  using Index = ControlFlowGraph::Index;
+
+ public:
+  explicit DominatorTree(const ControlFlowGraph &graph);
+
+  // Nothing for the entry and for the blocks that can't be reached
+  std::optional<Index> getImmediateDominator(const Index index) const {
+    if (index == ControlFlowGraph::kEntry || m_immediateDominators[index] == kNone) {
+      return std::nullopt;
+    }
+    return m_immediateDominators[index];
+  }
+
+  const std::vector<Index> &getChildren(const Index index) const { return m_children[index]; }
+
+  // The blocks where the dominance of the block ends, which is where its definitions meet others
+  const std::vector<Index> &getFrontier(const Index index) const { return m_frontiers[index]; }
+
+  // Every reachable block dominates itself
+  bool dominates(const Index a, const Index b) const {
+    return m_preorder[a] != kNone && m_preorder[b] != kNone &&
+           m_preorder[a] <= m_preorder[b] && m_postorder[b] <= m_postorder[a];
+  }
+
+ private:
+  static constexpr Index kNone{static_cast<Index>(-1)};
+
+  std::vector<Index> m_immediateDominators;
+  std::vector<std::vector<Index>> m_children;
+  std::vector<std::vector<Index>> m_frontiers;
+  // Numbering of the tree, so that dominance is checked in constant time
+  std::vector<size_t> m_preorder, m_postorder;
+};
+
+}  // namespace Wisnia
+
+#endif  // WISNIALANG_DOMINATOR_TREE_HPP
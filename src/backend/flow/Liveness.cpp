@@ -0,0 +1,89 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <algorithm>
+// Wisnia
+#include "Liveness.hpp"
+
+using namespace Wisnia;
+
+Liveness::Liveness(const ControlFlowGraph &graph, const std::span<const Instruction> function) {
+  m_firstVariable = UINT32_MAX;
+  for (const auto &instruction : function) {
+    for (size_t i = 0; i < Instruction::kOperands; i++) {
+      if (const auto operand = instruction.getOperand(i); operand.isIdentifierType()) {
+        const auto reg = static_cast<uint32_t>(operand.getVirtualRegister());
+        m_firstVariable = std::min(m_firstVariable, reg);
+        m_endVariable = std::max(m_endVariable, reg + 1);
+      }
+    }
+  }
+  if (m_firstVariable >= m_endVariable) {
+    m_firstVariable = m_endVariable = 0;
+  }
+
+  const auto &blocks = graph.getBlocks();
+  const auto count = m_endVariable - m_firstVariable;
+
+  // The blocks that read each variable before writing it, and the blocks that write it
+  constexpr auto kNone = UINT32_MAX;
+  std::vector<std::vector<Index>> reads(count), writes(count);
+  for (Index block = 0; block < blocks.size(); block++) {
+    for (const auto &instruction : function.subspan(blocks[block].m_begin, blocks[block].m_end - blocks[block].m_begin)) {
+      for (size_t i = 0; i < Instruction::kOperands; i++) {
+        if (const auto operand = instruction.getOperand(i); operand.isIdentifierType() && instruction.isUse(i)) {
+          const auto variable = static_cast<uint32_t>(operand.getVirtualRegister()) - m_firstVariable;
+          if ((writes[variable].empty() || writes[variable].back() != block) &&
+              (reads[variable].empty() || reads[variable].back() != block)) {
+            reads[variable].push_back(block);
+          }
+        }
+      }
+      for (size_t i = 0; i < Instruction::kOperands; i++) {
+        if (const auto operand = instruction.getOperand(i); operand.isIdentifierType() && instruction.isDefinition(i)) {
+          const auto variable = static_cast<uint32_t>(operand.getVirtualRegister()) - m_firstVariable;
+          if (writes[variable].empty() || writes[variable].back() != block) {
+            writes[variable].push_back(block);
+          }
+        }
+      }
+    }
+  }
+
+  // A variable read in a block is live when entering it, and so when leaving each of its
+  // predecessors, and when entering those of them that don't write it. The variables are visited
+  // in order, which keeps the sets sorted, and the last variable each block was marked with tells
+  // whether it has been visited for the current one
+  m_liveIn.assign(blocks.size(), {});
+  m_liveOut.assign(blocks.size(), {});
+  std::vector<uint32_t> liveIn(blocks.size(), kNone), liveOut(blocks.size(), kNone), written(blocks.size(), kNone);
+  std::vector<Index> pending{};
+  for (uint32_t variable = 0; variable < count; variable++) {
+    if (reads[variable].empty()) {
+      continue;
+    }
+    const auto reg = static_cast<VirtualRegister>(m_firstVariable + variable);
+    for (const auto block : writes[variable]) {
+      written[block] = variable;
+    }
+    pending = reads[variable];
+    while (!pending.empty()) {
+      const auto block = pending.back();
+      pending.pop_back();
+      if (liveIn[block] == variable) {
+        continue;
+      }
+      liveIn[block] = variable;
+      m_liveIn[block].push_back(reg);
+      for (const auto predecessor : blocks[block].m_predecessors) {
+        if (liveOut[predecessor] != variable) {
+          liveOut[predecessor] = variable;
+          m_liveOut[predecessor].push_back(reg);
+        }
+        if (written[predecessor] != variable) {
+          pending.push_back(predecessor);
+        }
+      }
+    }
+  }
+}
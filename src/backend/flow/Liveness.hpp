@@ -0,0 +1,69 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_LIVENESS_HPP
+#define WISNIALANG_LIVENESS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+// Wisnia
+#include "ControlFlowGraph.hpp"
+#include "Instruction.hpp"
+
+namespace Wisnia {
+
+// The variables of a function that are live when entering and when leaving each of its blocks,
+// i.e. that may still be read before being written again. Found by following each variable back
+// from the blocks that read it, through their predecessors, until reaching the blocks that write
+// it ("Computing Liveness Sets for SSA-Form Programs" by Brandner et al.). Values carried around
+// loops are followed over the back edges, so they're live at the ends of the loops too. Each block
+// is visited once for each variable live in it, so the time taken is proportional to the sizes of
+// the sets rather than to the number of blocks times the number of variables
+class Liveness {
+  using Index = ControlFlowGraph::Index;
+  // Sorted by the virtual register
+  using Set = std::vector<VirtualRegister>;
+
+ public:
+  Liveness(const ControlFlowGraph &graph, std::span<const Instruction> function);
+
+  // The virtual registers of a function are numbered consecutively, from the first to the end one
+  bool hasVariables() const { return m_firstVariable < m_endVariable; }
+  uint32_t getFirstVariable() const { return m_firstVariable; }
+  uint32_t getEndVariable() const { return m_endVariable; }
+
+  bool isLiveIn(const Index block, const VirtualRegister reg) const { return contains(m_liveIn[block], reg); }
+  bool isLiveOut(const Index block, const VirtualRegister reg) const { return contains(m_liveOut[block], reg); }
+
+  template <typename Function>
+  void forEachLiveIn(const Index block, Function &&function) const {
+    forEach(m_liveIn[block], function);
+  }
+
+  template <typename Function>
+  void forEachLiveOut(const Index block, Function &&function) const {
+    forEach(m_liveOut[block], function);
+  }
+
+ private:
+  template <typename Function>
+  static void forEach(const Set &set, Function &function) {
+    for (const auto reg : set) {
+      function(reg);
+    }
+  }
+
+  static bool contains(const Set &set, const VirtualRegister reg) {
+    return std::ranges::binary_search(set, reg);
+  }
+
+  uint32_t m_firstVariable{0}, m_endVariable{0};
+  std::vector<Set> m_liveIn;
+  std::vector<Set> m_liveOut;
+};
+
+}  // namespace Wisnia
+
+#endif  // WISNIALANG_LIVENESS_HPP
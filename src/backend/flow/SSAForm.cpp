@@ -0,0 +1,222 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <algorithm>
+// Wisnia
+#include "Liveness.hpp"
+#include "SSAForm.hpp"
+
+using namespace Wisnia;
+using namespace Basic;
+
+SSAForm::SSAForm(const std::span<const Instruction> function, VirtualRegisters &registers)
+    : m_graph{function}, m_dominators{m_graph} {
+  for (const auto &block : m_graph.getBlocks()) {
+    m_blocks.push_back({{}, {function.begin() + block.m_begin, function.begin() + block.m_end}});
+  }
+  const Liveness liveness{m_graph, function};
+  if (liveness.hasVariables()) {
+    placePhis(liveness);
+    rename(liveness, registers);
+  }
+}
+
+// "Efficiently Computing Static Single Assignment Form and the Control Dependence Graph" by Cytron
+// et al. A variable written in a block needs a phi function in each block of the block's dominance
+// frontier, and the phi function is itself a new definition
+void SSAForm::placePhis(const Liveness &liveness) {
+  const auto first = liveness.getFirstVariable();
+  const auto count = liveness.getEndVariable() - first;
+
+  // The blocks that write each variable, and the variable's type
+  std::vector<std::vector<Index>> definitions(count);
+  std::vector<TType> types(count, TType::TOK_INVALID);
+  for (const auto block : m_graph.getReversePostorder()) {
+    for (const auto &instruction : m_blocks[block].m_instructions) {
+      for (size_t i = 0; i < Instruction::kOperands; i++) {
+        const auto operand = instruction.getOperand(i);
+        if (!operand.isIdentifierType() || !instruction.isDefinition(i) || instruction.isUse(i)) {
+          continue;
+        }
+        const auto variable = static_cast<uint32_t>(operand.getVirtualRegister()) - first;
+        types[variable] = operand.getType();
+        if (definitions[variable].empty() || definitions[variable].back() != block) {
+          definitions[variable].push_back(block);
+        }
+      }
+    }
+  }
+
+  // The last variable that was given a phi function in each block, and that had each block queued
+  constexpr auto kNone = UINT32_MAX;
+  std::vector<uint32_t> placed(m_blocks.size(), kNone), queued(m_blocks.size(), kNone);
+  for (uint32_t variable = 0; variable < count; variable++) {
+    auto &pending = definitions[variable];
+    for (const auto block : pending) {
+      queued[block] = variable;
+    }
+    const Operand original{types[variable], static_cast<VirtualRegister>(first + variable)};
+    while (!pending.empty()) {
+      const auto block = pending.back();
+      pending.pop_back();
+      for (const auto frontier : m_dominators.getFrontier(block)) {
+        if (placed[frontier] == variable || !liveness.isLiveIn(frontier, original.getVirtualRegister())) {
+          continue;
+        }
+        placed[frontier] = variable;
+        const auto predecessors = m_graph.getBlock(frontier).m_predecessors.size();
+        m_blocks[frontier].m_phis.push_back({original, std::vector<Operand>(predecessors, original)});
+        if (queued[frontier] != variable) {
+          queued[frontier] = variable;
+          pending.push_back(frontier);
+        }
+      }
+    }
+  }
+}
+
+// Walks the dominator tree while keeping a stack of the versions of each variable, so that each
+// read gets the version of the nearest definition that dominates it
+void SSAForm::rename(const Liveness &liveness, VirtualRegisters &registers) {
+  const auto first = liveness.getFirstVariable();
+  const auto count = liveness.getEndVariable() - first;
+  const auto variableOf = [&](const Operand &operand) {
+    return static_cast<uint32_t>(operand.getVirtualRegister()) - first;
+  };
+
+  // Phi functions are placed with the original virtual register as their target
+  std::vector<std::vector<uint32_t>> phiVariables(m_blocks.size());
+  for (Index block = 0; block < m_blocks.size(); block++) {
+    for (const auto &phi : m_blocks[block].m_phis) {
+      phiVariables[block].push_back(variableOf(phi.m_target));
+    }
+  }
+
+  std::vector<std::vector<VirtualRegister>> versions(count);
+  std::vector<uint32_t> definitionCount(count, 0);
+  // The variables given a new version by the blocks on the path from the entry
+  std::vector<uint32_t> defined{};
+  const auto define = [&](const Operand &operand) {
+    const auto variable = variableOf(operand);
+    const auto reg = definitionCount[variable]++ == 0
+      ? operand.getVirtualRegister()
+      : registers.createVersion(operand.getVirtualRegister(), definitionCount[variable] - 1);
+    versions[variable].push_back(reg);
+    defined.push_back(variable);
+    return Operand{operand.getType(), reg};
+  };
+  const auto current = [&](const Operand &operand) {
+    const auto &stack = versions[variableOf(operand)];
+    return stack.empty() ? operand : Operand{operand.getType(), stack.back()};
+  };
+
+  const auto renameBlock = [&](const Index block) {
+    for (auto &phi : m_blocks[block].m_phis) {
+      phi.m_target = define(phi.m_target);
+    }
+    for (auto &instruction : m_blocks[block].m_instructions) {
+      for (size_t i = 0; i < Instruction::kOperands; i++) {
+        if (const auto operand = instruction.getOperand(i); operand.isIdentifierType() && instruction.isUse(i)) {
+          instruction.setOperand(i, current(operand));
+        }
+      }
+      for (size_t i = 0; i < Instruction::kOperands; i++) {
+        const auto operand = instruction.getOperand(i);
+        if (operand.isIdentifierType() && instruction.isDefinition(i) && !instruction.isUse(i)) {
+          instruction.setOperand(i, define(operand));
+        }
+      }
+    }
+    for (const auto successor : m_graph.getBlock(block).m_successors) {
+      const auto &predecessors = m_graph.getBlock(successor).m_predecessors;
+      const auto edge = static_cast<size_t>(std::ranges::find(predecessors, block) - predecessors.begin());
+      auto &phis = m_blocks[successor].m_phis;
+      for (size_t i = 0; i < phis.size(); i++) {
+        const auto variable = phiVariables[successor][i];
+        const Operand original{phis[i].m_target.getType(), static_cast<VirtualRegister>(first + variable)};
+        phis[i].m_arguments[edge] = current(original);
+      }
+    }
+  };
+
+  struct Frame {
+    Index m_block;
+    size_t m_child;
+    size_t m_defined;
+  };
+  std::vector<Frame> frames{};
+  const auto enter = [&](const Index block) {
+    frames.push_back({block, 0, defined.size()});
+    renameBlock(block);
+  };
+
+  enter(ControlFlowGraph::kEntry);
+  while (!frames.empty()) {
+    auto &frame = frames.back();
+    const auto &children = m_dominators.getChildren(frame.m_block);
+    if (frame.m_child < children.size()) {
+      enter(children[frame.m_child++]);
+      continue;
+    }
+    // Leaving the block, so its versions are no longer the current ones
+    for (; defined.size() > frame.m_defined; defined.pop_back()) {
+      versions[defined.back()].pop_back();
+    }
+    frames.pop_back();
+  }
+}
+
+// The copies of a block's phi functions are made one after another: the phi functions of a block
+// never read each other's targets, since nothing has been coalesced since the construction
+std::vector<Instruction> SSAForm::destruct(size_t &labelCount) const {
+  const auto &blocks = m_graph.getBlocks();
+  const auto copy = [&](const Index from, const Index to, std::vector<Instruction> &into) {
+    const auto &predecessors = blocks[to].m_predecessors;
+    const auto edge = static_cast<size_t>(std::ranges::find(predecessors, from) - predecessors.begin());
+    for (const auto &phi : m_blocks[to].m_phis) {
+      if (phi.m_arguments[edge] != phi.m_target) {
+        into.emplace_back(Operation::MOV, phi.m_target, phi.m_arguments[edge]);
+      }
+    }
+  };
+  const auto hasPhis = [&](const Index block) {
+    return !m_blocks[block].m_phis.empty();
+  };
+
+  std::vector<Instruction> output{};
+  // Blocks for the critical edges that are taken by jumping, which go after the whole function
+  std::vector<Instruction> splitBlocks{};
+  for (Index block = 0; block < m_blocks.size(); block++) {
+    const auto &instructions = m_blocks[block].m_instructions;
+    const auto &successors = blocks[block].m_successors;
+    auto last = instructions.back();
+
+    if (successors.size() == 1 && hasPhis(successors.front())) {
+      // Moves leave the flags alone, so the copies can go right before a conditional jump too
+      const bool jumps = last.isJump();
+      output.insert(output.end(), instructions.begin(), instructions.end() - jumps);
+      copy(block, successors.front(), output);
+      if (jumps) {
+        output.push_back(last);
+      }
+      continue;
+    }
+
+    if (successors.size() == 2 && hasPhis(successors.front())) {
+      // The jump is redirected to a new block that makes the copies and then jumps to the target
+      const Operand label{TType::IDENT_VOID, ".L" + std::to_string(++labelCount) + "_split"};
+      splitBlocks.emplace_back(Operation::LABEL, Operand{}, label);
+      copy(block, successors.front(), splitBlocks);
+      splitBlocks.emplace_back(Operation::JMP, Operand{}, last.getArg1());
+      last = Instruction{last.getOperation(), Operand{}, label};
+    }
+    output.insert(output.end(), instructions.begin(), instructions.end() - 1);
+    output.push_back(last);
+    if (successors.size() == 2 && hasPhis(successors.back())) {
+      // Only reached by falling through from the jump
+      copy(block, successors.back(), output);
+    }
+  }
+  output.insert(output.end(), splitBlocks.begin(), splitBlocks.end());
+  return output;
+}
@@ -0,0 +1,62 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_SSA_FORM_HPP
+#define WISNIALANG_SSA_FORM_HPP
+
+#include <span>
+#include <vector>
+// Wisnia
+#include "ControlFlowGraph.hpp"
+#include "DominatorTree.hpp"
+#include "Instruction.hpp"
+#include "VirtualRegisters.hpp"
+
+namespace Wisnia {
+class Liveness;
+
+// A function in static single-assignment form: every variable is written by a single definition,
+// and the phi functions at the start of a block pick a variable's value by the predecessor that
+// control came from. Operands that an instruction both reads and writes, e.g. the target of
+// `_tx = _tx + b`, are updated in place and keep their virtual register
+class SSAForm {
+  using Index = ControlFlowGraph::Index;
+
+ public:
+  struct Phi {
+    Operand m_target;
+    // One for each predecessor of the block, in the same order
+    std::vector<Operand> m_arguments;
+  };
+
+  struct Block {
+    std::vector<Phi> m_phis{};
+    std::vector<Instruction> m_instructions{};
+  };
+
+  // Phi functions are only placed where the variable is live (pruned SSA). The first definition of
+  // a variable keeps its virtual register, and the others get new versions of it. The blocks that
+  // can't be reached from the entry are left as they are
+  SSAForm(std::span<const Instruction> function, VirtualRegisters &registers);
+
+  const ControlFlowGraph &getGraph() const { return m_graph; }
+  const DominatorTree &getDominatorTree() const { return m_dominators; }
+  const std::vector<Block> &getBlocks() const { return m_blocks; }
+
+  // Leaves SSA form by replacing the phi functions with copies at the ends of the predecessors.
+  // The copies of a critical edge are put in a block of their own, which is labelled with the help
+  // of `labelCount` if it can't be reached by falling through
+  std::vector<Instruction> destruct(size_t &labelCount) const;
+
+ private:
+  void placePhis(const Liveness &liveness);
+  void rename(const Liveness &liveness, VirtualRegisters &registers);
+
+  ControlFlowGraph m_graph;
+  DominatorTree m_dominators;
+  std::vector<Block> m_blocks;
+};
+
+}  // namespace Wisnia
+
+#endif  // WISNIALANG_SSA_FORM_HPP
@@ -15,11 +15,11 @@ using namespace Wisnia;
 using namespace Basic;
 using namespace AST;
 
-Root &IRGenerator::popNode() {
+Operand IRGenerator::popOperand() {
   assert(!m_stack.empty() && "The stack is empty");
-  auto &topNode{*m_stack.top()};
+  const auto operand{m_stack.top()};
   m_stack.pop();
-  return topNode;
+  return operand;
 }
 
 constexpr std::array<std::array<Operation, 2>, 12> binaryExprMapping {{
@@ -80,35 +80,47 @@ constexpr TType getIdentForLiteralType(const TType type) {
   }
 }
 
+Operand IRGenerator::createTemporary(const TType type) {
+  return m_lastTemporary = Operand{getIdentForLiteralType(type), m_virtualRegisters.createTemporary()};
+}
+
+Operand IRGenerator::getVariable(const Token &token) {
+  const auto symbol = StringInterner::global().intern(token.getValue<std::string>());
+  auto [it, inserted] = m_variables.try_emplace(symbol);
+  if (inserted) {
+    it->second = m_virtualRegisters.createVariable(symbol);
+  }
+  return Operand{token.getType(), it->second};
+}
+
+Operand IRGenerator::getOperand(const Token &token) {
+  return token.isIdentifierType() ? getVariable(token) : Operand{token};
+}
+
 void IRGenerator::createBinaryExpression(const TType expressionType) {
-  const auto &rhs = popNode();
-  const auto &lhs = popNode();
+  const auto rhs = popOperand();
+  const auto lhs = popOperand();
 
-  const auto rhsType = rhs.getToken()->getType();
+  const auto rhsType = rhs.getType();
   const bool isFloat = rhsType == TType::LIT_FLT || rhsType == TType::IDENT_FLOAT;
   const Operation op = getOperationForBinaryExpression(expressionType, isFloat);
 
-  auto varToken = std::make_shared<Token>(
-    getIdentForLiteralType(rhsType),
-    "_t" + std::to_string(m_tempVars.size())
-  );
-
-  m_tempVars.emplace_back(std::make_unique<VarExpr>(varToken));
-  m_stack.push(m_tempVars.back().get());
+  const auto varToken = createTemporary(rhsType);
+  m_stack.push(varToken);
 
   // _tx = a <op> b rewritten as
   //    _tx = a
   //    _tx = _tx <op> b
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     Operation::MOV,
     varToken,       // _tx
-    lhs.getToken()  // a
-  ));
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+    lhs             // a
+  );
+  m_instructions.emplace_back(
     op,             // <op>
     varToken,       // _tx
-    rhs.getToken()  // b
-  ));
+    rhs             // b
+  );
 }
 
 std::unordered_map<Operation, Operation> jumpConditionMap1 = {
@@ -141,64 +153,44 @@ Operation IRGenerator::createJumpOpFromCondition(Root &node, const bool opposite
 
   // if (register) ==> if (register > 0)
   const auto &[token, _] = getExpression(node);
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     Operation::CMP,
-    nullptr,
+    Operand{},
     token,
-    std::make_shared<Token>(TType::LIT_INT, 0)
-  ));
+    Operand{TType::LIT_INT, 0}
+  );
   return Operation::JE;
 }
 
-std::tuple<IRGenerator::TokenPtr, TType> IRGenerator::getExpression(Root &node, const bool createVariableForLiteral) {
-  TokenPtr token;
+std::tuple<Operand, TType> IRGenerator::getExpression(Root &node, const bool createVariableForLiteral) {
+  Operand token;
   TType type;
 
   if (dynamic_cast<BinaryExpr *>(&node)) {
-    token = m_tempVars.back()->getToken();
-    type  = m_tempVars.back()->getToken()->getType();
+    token = m_lastTemporary;
+    type  = m_lastTemporary.getType();
   } else if (dynamic_cast<FnCallExpr *>(&node)) {
+    // a non-void function call yields the temporary that its return value was popped into
     type  = node.getToken()->getType();
-    token = std::make_shared<Token>(
-      getIdentForLiteralType(type),
-      "_t" + std::to_string(m_tempVars.size())
-    );
-    m_tempVars.emplace_back(std::make_unique<VarExpr>(token));
     if (type != TType::IDENT_VOID) {
-      // we expect a non-void function to return a value that is kept in the most distant register because:
-      //   1. we push all registers (rax, ..., r15)
-      //   2. we generate IRs for function call
-      //   3. we pop all registers (r15, ..., rax) <-- thus return value is stored in r15
-      auto functionReturn = std::make_shared<Token>(
-        TType::REGISTER,
-        R15
-      );
-      m_instructions.emplace_back(std::make_unique<Instruction>(
-        Operation::MOV,
-        token,
-        functionReturn
-      ));
+      token = m_lastTemporary;
     }
   } else if (node.getToken()->isIdentifierType()) {
-    token = node.getToken();
-    type  = token->getType();
+    token = getVariable(*node.getToken());
+    type  = token.getType();
   } else if (node.getToken()->isLiteralType()) {
     if (createVariableForLiteral) {
-      const auto &litToken = node.getToken();
-      auto varToken = std::make_shared<Token>(
-        getIdentForLiteralType(litToken->getType()),
-        "_t" + std::to_string(m_tempVars.size())
-      );
-      m_tempVars.emplace_back(std::make_unique<VarExpr>(varToken));
-      m_instructions.emplace_back(std::make_unique<Instruction>(
+      const Operand litToken{*node.getToken()};
+      const auto varToken = createTemporary(litToken.getType());
+      m_instructions.emplace_back(
         Operation::MOV,
         varToken, // _tx
         litToken  // literal
-      ));
-      token = m_tempVars.back()->getToken();
-      type  = m_tempVars.back()->getToken()->getType();
+      );
+      token = varToken;
+      type  = varToken.getType();
     } else {
-      token = node.getToken();
+      token = Operand{*node.getToken()};
       type  = node.getToken()->getType();
     }
   } else {
@@ -216,7 +208,7 @@ void IRGenerator::visit(Root &node) {
     const size_t start = last;
     const size_t end   = last = m_instructions.size();
     if (m_allocateRegisters) {
-      registerAllocator.allocate(vec_slice(m_instructions, start, end));
+      registerAllocator.allocate(std::span{m_instructions}.subspan(start, end - start));
     }
   }
 
@@ -226,21 +218,21 @@ void IRGenerator::visit(Root &node) {
   auto [module3, module3Used] = Modules::getModule(PRINT_BOOLEAN);
   auto [module4, module4Used] = Modules::getModule(EXIT);
 
-  if (module1Used) registerAllocator.allocate(std::move(module1), false);
-  if (module2Used) registerAllocator.allocate(std::move(module2), false);
-  if (module3Used) registerAllocator.allocate(std::move(module3), false);
-  if (module4Used) registerAllocator.allocate(std::move(module4), false);
+  if (module1Used) registerAllocator.allocate(module1, false);
+  if (module2Used) registerAllocator.allocate(module2, false);
+  if (module3Used) registerAllocator.allocate(module3, false);
+  if (module4Used) registerAllocator.allocate(module4, false);
+  registerAllocator.lowerCalls();
 
   // Instruction optimization
-  const auto &instructions = getInstructions(Transformation::REGISTER_ALLOCATION);
-  irOptimization.optimize(vec_slice(instructions, 0, instructions.size()));
+  irOptimization.optimize(getInstructions(Transformation::REGISTER_ALLOCATION));
 }
 
 void IRGenerator::visit(PrimitiveType &) {
 }
 
 void IRGenerator::visit(VarExpr &node) {
-  m_stack.push(&node);
+  m_stack.push(getOperand(*node.getToken()));
 }
 
 void IRGenerator::visit(BooleanExpr &node) {
@@ -253,24 +245,24 @@ void IRGenerator::visit(EqExpr &node) {
   const auto comparisonOp = getOperationForBinaryExpression(node.getToken()->getType(), false);
   m_comparisonOp.push(comparisonOp);
 
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     Operation::CMP,
-    nullptr,
-    node.lhs()->getToken(),
-    node.rhs()->getToken()
-  ));
+    Operand{},
+    getOperand(*node.lhs()->getToken()),
+    getOperand(*node.rhs()->getToken())
+  );
 }
 
 void IRGenerator::visit(CompExpr &node) {
   const auto comparisonOp = getOperationForBinaryExpression(node.getToken()->getType(), false);
   m_comparisonOp.push(comparisonOp);
 
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     Operation::CMP,
-    nullptr,
-    node.lhs()->getToken(),
-    node.rhs()->getToken()
-  ));
+    Operand{},
+    getOperand(*node.lhs()->getToken()),
+    getOperand(*node.rhs()->getToken())
+  );
 }
 
 void IRGenerator::visit(AddExpr &node) {
@@ -305,52 +297,72 @@ void IRGenerator::visit(UnaryExpr &node) {
 }
 
 void IRGenerator::visit(FnCallExpr &node) {
-  node.getVariable()->accept(*this);
-  constexpr auto registers = RegisterAllocator::getAllocatableRegisters;
-
-  // suboptimal approach to avoid overriding registers inside the called function
-  std::transform(registers.begin(), registers.end(), std::back_inserter(m_instructions), [&](auto reg) {
-    return std::make_unique<Instruction>(
-      Operation::PUSH,
-      nullptr,
-      std::make_shared<Token>(TType::REGISTER, reg)
-    );
-  });
+  // the registers to keep across the call are only known once they have been allocated,
+  // so the register allocator replaces the pair with pushes and pops of the live ones
+  m_instructions.emplace_back(
+    Operation::SAVE
+  );
 
+  std::vector<Operand> arguments{};
   for (const auto &arg : node.getArguments()) {
     arg->accept(*this);
-    const auto &[argToken, _] = getExpression(*arg);
-    auto varToken = std::make_shared<Token>(
-      getIdentForLiteralType(argToken->getType()),
-      "_t" + std::to_string(m_tempVars.size())
-    );
-    m_tempVars.emplace_back(std::make_unique<VarExpr>(varToken));
-    m_instructions.emplace_back(std::make_unique<Instruction>(
+    const auto argToken = popOperand();
+    const auto varToken = createTemporary(argToken.getType());
+    m_instructions.emplace_back(
       Operation::MOV,
       varToken, // _tx
       argToken  // arg
-    ));
-    m_instructions.emplace_back(std::make_unique<Instruction>(
+    );
+    arguments.push_back(varToken);
+  }
+
+  // the arguments that don't fit in registers are passed on the stack, the first of them pushed last
+  // so that it lies right above the return address
+  constexpr auto registers = RegisterAllocator::getArgumentRegisters;
+  for (size_t i = arguments.size(); i-- > registers.size();) {
+    m_instructions.emplace_back(
       Operation::PUSH,
-      nullptr,
-      varToken
-    ));
+      Operand{},
+      arguments[i]
+    );
+  }
+  // and the rest are moved into their registers right before the call, all at once
+  for (size_t i = 0; i < std::min(arguments.size(), registers.size()); i++) {
+    m_instructions.emplace_back(
+      Operation::MOV,
+      Operand{TType::REGISTER, registers[i]},
+      arguments[i]
+    );
   }
 
   const auto &functionName = node.getFunctionName();
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     Operation::CALL,
-    std::make_shared<Token>(TType::IDENT_VOID, functionName->getValue<std::string>())
-  ));
-
-  // following the function call, restore old register values
-  std::transform(std::ranges::rbegin(registers), std::ranges::rend(registers), std::back_inserter(m_instructions), [](auto reg) {
-    return std::make_unique<Instruction>(
-      Operation::POP,
-      nullptr,
-      std::make_shared<Token>(TType::REGISTER, reg)
+    Operand{TType::IDENT_VOID, functionName->getValue<std::string>()}
+  );
+
+  if (arguments.size() > registers.size()) {
+    // the caller takes the arguments passed on the stack back off it
+    m_instructions.emplace_back(
+      Operation::IADD,
+      Operand{TType::REGISTER, RSP},
+      Operand{TType::LIT_INT, static_cast<int>(8 * (arguments.size() - registers.size()))}
+    );
+  }
+
+  if (const auto type = node.getToken()->getType(); type != TType::IDENT_VOID) {
+    const auto varToken = createTemporary(type);
+    m_stack.push(varToken);
+    m_instructions.emplace_back(
+      Operation::MOV,
+      varToken,
+      Operand{TType::REGISTER, RegisterAllocator::getReturnRegister}
     );
-  });
+  }
+
+  m_instructions.emplace_back(
+    Operation::RESTORE
+  );
 }
 
 void IRGenerator::visit(ClassInitExpr &node) {
@@ -364,19 +376,19 @@ void IRGenerator::visit(ClassInitExpr &node) {
 }
 
 void IRGenerator::visit(IntExpr &node) {
-  m_stack.push(&node);
+  m_stack.emplace(*node.getToken());
 }
 
 void IRGenerator::visit(FloatExpr &node) {
-  m_stack.push(&node);
+  m_stack.emplace(*node.getToken());
 }
 
 void IRGenerator::visit(BoolExpr &node) {
-  m_stack.push(&node);
+  m_stack.emplace(*node.getToken());
 }
 
 void IRGenerator::visit(StringExpr &node) {
-  m_stack.push(&node);
+  m_stack.emplace(*node.getToken());
 }
 
 void IRGenerator::visit(StmtBlock &node) {
@@ -386,23 +398,31 @@ void IRGenerator::visit(StmtBlock &node) {
 }
 
 void IRGenerator::visit(ReturnStmt &node) {
-  node.getReturnValue()->accept(*this);
-  const auto &[token, _] = getExpression(*node.getReturnValue());
-  m_instructions.emplace_back(std::make_unique<Instruction>(
-    Operation::PUSH,
-    nullptr,
-    token
-  ));
+  if (const auto &value = node.getReturnValue(); value) {
+    value->accept(*this);
+    const auto &[token, _] = getExpression(*value, false);
+    m_instructions.emplace_back(
+      Operation::MOV,
+      m_returnValue,
+      token
+    );
+  }
+  m_instructions.emplace_back(
+    Operation::JMP,
+    Operand{},
+    m_returnLabel
+  );
+  m_returnJumps++;
 }
 
 void IRGenerator::visit(BreakStmt &) {
   const auto breakLabel = m_breakLabel.top();
   m_breakLabel.pop();
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     Operation::JMP,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, breakLabel)
-  ));
+    Operand{},
+    breakLabel
+  );
 }
 
 void IRGenerator::visit(ContinueStmt &node) {
@@ -414,22 +434,22 @@ void IRGenerator::visit(ContinueStmt &node) {
 void IRGenerator::visit(VarDeclStmt &node) {
   node.getValue()->accept(*this);
   const auto &[token, _] = getExpression(*node.getValue());
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     Operation::MOV,
-    node.getVariable()->getToken(), // int a
+    getVariable(*node.getVariable()->getToken()), // int a
     token                           // _tx
-  ));
+  );
 }
 
 void IRGenerator::visit(VarAssignStmt &node) {
   node.getVariable()->accept(*this);
   node.getValue()->accept(*this);
   const auto &[token, _] = getExpression(*node.getValue());
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     Operation::MOV,
-    node.getVariable()->getToken(),
+    getVariable(*node.getVariable()->getToken()),
     token
-  ));
+  );
 }
 
 void IRGenerator::visit(ExprStmt &node) {
@@ -453,182 +473,114 @@ void IRGenerator::visit(ReadStmt &node) {
   syscall            ;; make the system call
 */
 void IRGenerator::visit(WriteStmt &node) {
+  // each expression is printed right after it's evaluated, as the result of evaluating the next
+  // one may take the place of the last temporary. Like a function call, printing is surrounded by
+  // a SAVE and a RESTORE, so that only the live registers it overwrites are pushed and popped
   for (const auto &expr : node.getExpressions()) {
     expr->accept(*this);
-  }
-
-  for (const auto &expr : node.getExpressions()) {
     const auto &[token, type] = getExpression(*expr, false);
 
-    if (token->isIdentifierType()) {
+    Operand length{};
+    if (token.isIdentifierType()) {
       // Resolved at compiled program's run-time
+      const auto callModule = [&](const Module module, const Basic::register_t argument) {
+        m_instructions.emplace_back(
+          Operation::SAVE
+        );
+        m_instructions.emplace_back(
+          Operation::MOV,
+          Operand{TType::REGISTER, argument},
+          token
+        );
+        m_instructions.emplace_back(
+          Operation::CALL,
+          Operand{TType::IDENT_VOID, Module2Str[module]}
+        );
+        Modules::markAsUsed(module);
+      };
       switch (type) {
         case TType::IDENT_STRING:
-          m_instructions.emplace_back(std::make_unique<Instruction>(
-            Operation::PUSH,
-            nullptr,
-            std::make_shared<Token>(TType::REGISTER, RDX)
-          ));
-          m_instructions.emplace_back(std::make_unique<Instruction>(
-            Operation::PUSH,
-            nullptr,
-            std::make_shared<Token>(TType::REGISTER, RSI)
-          ));
-          m_instructions.emplace_back(std::make_unique<Instruction>(
+          // the module leaves the length of the string in `rdx`
+          callModule(CALCULATE_STRING_LENGTH, RSI);
+          length = createTemporary(TType::LIT_INT);
+          m_instructions.emplace_back(
             Operation::MOV,
-            std::make_shared<Token>(TType::REGISTER, RSI),
-            std::make_shared<Token>(type, token->getValue<std::string>())
-          ));
-          m_instructions.emplace_back(std::make_unique<Instruction>(
-            Operation::CALL,
-            std::make_shared<Token>(TType::IDENT_VOID, Module2Str[CALCULATE_STRING_LENGTH])
-          ));
-          Modules::markAsUsed(CALCULATE_STRING_LENGTH);
+            length,
+            Operand{TType::REGISTER, RDX}
+          );
+          m_instructions.emplace_back(
+            Operation::RESTORE
+          );
           break;
         case TType::IDENT_INT:
-          m_instructions.emplace_back(std::make_unique<Instruction>(
-            Operation::PUSH,
-            nullptr,
-            std::make_shared<Token>(TType::REGISTER, RDI)
-          ));
-          m_instructions.emplace_back(std::make_unique<Instruction>(
-            Operation::MOV,
-            std::make_shared<Token>(TType::REGISTER, RDI),
-            std::make_shared<Token>(type, token->getValue<std::string>())
-          ));
-          m_instructions.emplace_back(std::make_unique<Instruction>(
-            Operation::CALL,
-            std::make_shared<Token>(TType::IDENT_VOID, Module2Str[PRINT_NUMBER])
-          ));
-          m_instructions.emplace_back(std::make_unique<Instruction>(
-            Operation::POP,
-            nullptr,
-            std::make_shared<Token>(TType::REGISTER, RDI)
-          ));
-          Modules::markAsUsed(PRINT_NUMBER);
+          callModule(PRINT_NUMBER, RDI);
+          m_instructions.emplace_back(
+            Operation::RESTORE
+          );
           continue;
         case TType::IDENT_BOOL:
-          m_instructions.emplace_back(std::make_unique<Instruction>(
-            Operation::PUSH,
-            nullptr,
-            std::make_shared<Token>(TType::REGISTER, RDI)
-          ));
-          m_instructions.emplace_back(std::make_unique<Instruction>(
-            Operation::MOV,
-            std::make_shared<Token>(TType::REGISTER, RDI),
-            std::make_shared<Token>(type, token->getValue<std::string>())
-          ));
-          m_instructions.emplace_back(std::make_unique<Instruction>(
-            Operation::CALL,
-            std::make_shared<Token>(TType::IDENT_VOID, Module2Str[PRINT_BOOLEAN])
-          ));
-          m_instructions.emplace_back(std::make_unique<Instruction>(
-            Operation::POP,
-            nullptr,
-            std::make_shared<Token>(TType::REGISTER, RDI)
-          ));
-          Modules::markAsUsed(PRINT_BOOLEAN);
+          callModule(PRINT_BOOLEAN, RDI);
+          m_instructions.emplace_back(
+            Operation::RESTORE
+          );
           continue;
         case TType::IDENT_FLOAT:
           throw InstructionError{fmt::format("Float variables are not supported in print statements in {}:{}",
-                                             token->getPosition().getFileName(),
-                                             token->getPosition().getLineNo())};
+                                             expr->getToken()->getPosition().getFileName(),
+                                             expr->getToken()->getPosition().getLineNo())};
         default:
           throw InstructionError{fmt::format("Unknown variable type for print statement in {}:{}",
-                                             token->getPosition().getFileName(),
-                                             token->getPosition().getLineNo())};
+                                             expr->getToken()->getPosition().getFileName(),
+                                             expr->getToken()->getPosition().getLineNo())};
       }
     }
 
-    if (token->isLiteralType()) {
+    m_instructions.emplace_back(
+      Operation::SAVE
+    );
+    if (token.isLiteralType()) {
       // Resolved at "compile-time"
-      const auto str = token->getValueStr();
-      const auto length = (type == TType::LIT_STR) ? str.size() - 1 : str.size();
-      m_instructions.emplace_back(std::make_unique<Instruction>(
-        Operation::PUSH,
-        nullptr,
-        std::make_shared<Token>(TType::REGISTER, RDX)
-      ));
-      m_instructions.emplace_back(std::make_unique<Instruction>(
-        Operation::PUSH,
-        nullptr,
-        std::make_shared<Token>(TType::REGISTER, RSI)
-      ));
-      m_instructions.emplace_back(std::make_unique<Instruction>(
+      const auto str = token.getValueStr();
+      length = Operand{TType::LIT_INT, static_cast<int>((type == TType::LIT_STR) ? str.size() - 1 : str.size())};
+      m_instructions.emplace_back(
         Operation::MOV,
-        std::make_shared<Token>(TType::REGISTER, RDX),
-        std::make_shared<Token>(TType::LIT_INT, static_cast<int>(length))
-      ));
-      m_instructions.emplace_back(std::make_unique<Instruction>(
+        Operand{TType::REGISTER, RDX},
+        length
+      );
+      m_instructions.emplace_back(
         Operation::MOV,
-        std::make_shared<Token>(TType::REGISTER, RSI),
-        std::make_shared<Token>(TType::LIT_STR, str)
-      ));
+        Operand{TType::REGISTER, RSI},
+        Operand{TType::LIT_STR, str}
+      );
+    } else {
+      // both moves happen at once, so neither overwrites the other's source
+      m_instructions.emplace_back(
+        Operation::MOV,
+        Operand{TType::REGISTER, RDX},
+        length
+      );
+      m_instructions.emplace_back(
+        Operation::MOV,
+        Operand{TType::REGISTER, RSI},
+        token
+      );
     }
-
-    m_instructions.emplace_back(std::make_unique<Instruction>(
-      Operation::PUSH,
-      nullptr,
-      std::make_shared<Token>(TType::REGISTER, RAX)
-    ));
-    m_instructions.emplace_back(std::make_unique<Instruction>(
-      Operation::PUSH,
-      nullptr,
-      std::make_shared<Token>(TType::REGISTER, RCX)
-    ));
-    m_instructions.emplace_back(std::make_unique<Instruction>(
-      Operation::PUSH,
-      nullptr,
-      std::make_shared<Token>(TType::REGISTER, R11)
-    ));
-    m_instructions.emplace_back(std::make_unique<Instruction>(
-      Operation::PUSH,
-      nullptr,
-      std::make_shared<Token>(TType::REGISTER, RDI)
-    ));
-    m_instructions.emplace_back(std::make_unique<Instruction>(
+    m_instructions.emplace_back(
       Operation::MOV,
-      std::make_shared<Token>(TType::REGISTER, RAX),
-      std::make_shared<Token>(TType::LIT_INT, 1)
-    ));
-    m_instructions.emplace_back(std::make_unique<Instruction>(
+      Operand{TType::REGISTER, RAX},
+      Operand{TType::LIT_INT, 1}
+    );
+    m_instructions.emplace_back(
       Operation::MOV,
-      std::make_shared<Token>(TType::REGISTER, RDI),
-      std::make_shared<Token>(TType::LIT_INT, 1)
-    ));
-    m_instructions.emplace_back(std::make_unique<Instruction>(
+      Operand{TType::REGISTER, RDI},
+      Operand{TType::LIT_INT, 1}
+    );
+    m_instructions.emplace_back(
       Operation::SYSCALL
-    ));
-    m_instructions.emplace_back(std::make_unique<Instruction>(
-      Operation::POP,
-      nullptr,
-      std::make_shared<Token>(TType::REGISTER, RDI)
-    ));
-    m_instructions.emplace_back(std::make_unique<Instruction>(
-      Operation::POP,
-      nullptr,
-      std::make_shared<Token>(TType::REGISTER, R11)
-    ));
-    m_instructions.emplace_back(std::make_unique<Instruction>(
-      Operation::POP,
-      nullptr,
-      std::make_shared<Token>(TType::REGISTER, RCX)
-    ));
-    m_instructions.emplace_back(std::make_unique<Instruction>(
-      Operation::POP,
-      nullptr,
-      std::make_shared<Token>(TType::REGISTER, RAX)
-    ));
-    m_instructions.emplace_back(std::make_unique<Instruction>(
-      Operation::POP,
-      nullptr,
-      std::make_shared<Token>(TType::REGISTER, RSI)
-    ));
-    m_instructions.emplace_back(std::make_unique<Instruction>(
-      Operation::POP,
-      nullptr,
-      std::make_shared<Token>(TType::REGISTER, RDX)
-    ));
+    );
+    m_instructions.emplace_back(
+      Operation::RESTORE
+    );
   }
 }
 
@@ -640,65 +592,81 @@ void IRGenerator::visit(Param &node) {
 }
 
 void IRGenerator::visit(FnDef &node) {
-  node.getVariable()->accept(*this);
-  const auto &functionName = popNode();
-  const auto functionNameStr = functionName.getToken()->getValue<std::string>();
-  TokenPtr returnAddressToken;
+  const auto functionNameStr = node.getVariable()->getToken()->getValue<std::string>();
+  const auto returnType = node.getVariable()->getToken()->getType();
+  m_variables.clear();
+  m_returnLabel = Operand{TType::IDENT_VOID, ".L" + functionNameStr + "_return"};
+  m_returnValue = returnType != TType::IDENT_VOID ? createTemporary(returnType) : Operand{};
+  m_returnJumps = 0;
 
   if (functionNameStr != "main") {
     // the main function doesn't require a label indicating where it begins
     // because we have already designated address "0x4000b0" as the program's main entry point
-    m_instructions.emplace_back(std::make_unique<Instruction>(
+    m_instructions.emplace_back(
       Operation::LABEL,
-      nullptr,
-      std::make_shared<Token>(TType::IDENT_VOID, functionNameStr)
-    ));
-    // put the function return address into a variable because we'll be popping out the arguments
-    // passed to the function in the later steps
-    returnAddressToken = std::make_shared<Token>(
-      TType::IDENT_INT,
-      "_t" + std::to_string(m_tempVars.size())
+      Operand{},
+      Operand{TType::IDENT_VOID, functionNameStr}
+    );
+  }
+
+  // the first arguments arrive in registers, and are moved out of them all at once
+  const auto &params = node.getParameters();
+  constexpr auto registers = RegisterAllocator::getArgumentRegisters;
+  for (size_t i = 0; i < std::min(params.size(), registers.size()); i++) {
+    m_instructions.emplace_back(
+      Operation::MOV,
+      getVariable(*params[i]->getToken()),
+      Operand{TType::REGISTER, registers[i]}
     );
-    m_tempVars.emplace_back(std::make_unique<VarExpr>(returnAddressToken));
-    m_instructions.emplace_back(std::make_unique<Instruction>(
-      Operation::POP,
-      nullptr,
-      returnAddressToken
-    ));
   }
 
-  std::transform(node.getParameters().rbegin(), node.getParameters().rend(), std::back_inserter(m_instructions), [](const auto &param) {
-    return std::make_unique<Instruction>(
-      Operation::POP,
-      nullptr,
-      param->getToken()
+  // and the rest are loaded from above the return address, where the offsets are counted from the
+  // stack pointer on entry to the function until the register allocator lays out its stack frame
+  for (size_t i = registers.size(); i < params.size(); i++) {
+    m_instructions.emplace_back(
+      Operation::LOAD,
+      getVariable(*params[i]->getToken()),
+      Operand{TType::LIT_INT, static_cast<int>(8 * (i - registers.size() + 1))}
     );
-  });
+  }
 
   node.getBody()->accept(*this);
 
-  if (functionNameStr != "main") {
-    // put the function return address back on the stack
-    // only functions other than "main" must return to the caller
-    m_instructions.emplace_back(std::make_unique<Instruction>(
-      Operation::PUSH,
-      nullptr,
-      returnAddressToken
-    ));
+  // a return statement at the end of the body doesn't need to jump over nothing
+  if (!m_instructions.empty() && m_instructions.back().getOperation() == Operation::JMP &&
+      m_instructions.back().getArg1() == m_returnLabel) {
+    m_instructions.pop_back();
+    m_returnJumps--;
+  }
+  if (m_returnJumps > 0) {
+    m_instructions.emplace_back(
+      Operation::LABEL,
+      Operand{},
+      m_returnLabel
+    );
+  }
+
+  if (m_returnValue) {
+    // the return value is handed over in a register
+    m_instructions.emplace_back(
+      Operation::MOV,
+      Operand{TType::REGISTER, RegisterAllocator::getReturnRegister},
+      m_returnValue
+    );
   }
 
   if (functionNameStr == "main") {
     // the "ret" instruction isn't required in the main function
     // because we terminate the program immediately in the "_exit_" function
-    m_instructions.emplace_back(std::make_unique<Instruction>(
+    m_instructions.emplace_back(
       Operation::CALL,
-      std::make_shared<Token>(TType::IDENT_VOID, Module2Str[EXIT])
-    ));
+      Operand{TType::IDENT_VOID, Module2Str[EXIT]}
+    );
     Modules::markAsUsed(EXIT);
   } else {
-    m_instructions.emplace_back(std::make_unique<Instruction>(
+    m_instructions.emplace_back(
       Operation::RET
-    ));
+    );
   }
 }
 
@@ -730,92 +698,92 @@ void IRGenerator::visit(WhileLoop &node) {
   m_whileLabelCount++;
 
   const std::array labels {
-    ".L" + std::to_string(m_whileLabelCount) + "_while_body",
-    ".L" + std::to_string(m_whileLabelCount) + "_while_check",
-    ".L" + std::to_string(m_whileLabelCount) + "_while_end",
+    Operand{TType::IDENT_VOID, ".L" + std::to_string(m_whileLabelCount) + "_while_body"},
+    Operand{TType::IDENT_VOID, ".L" + std::to_string(m_whileLabelCount) + "_while_check"},
+    Operand{TType::IDENT_VOID, ".L" + std::to_string(m_whileLabelCount) + "_while_end"},
   };
 
   m_breakLabel.emplace(labels[2]);
 
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     Operation::JMP,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, labels[1])
-  ));
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    labels[1]
+  );
+  m_instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, labels[0])
-  ));
+    Operand{},
+    labels[0]
+  );
 
   node.getBody()->accept(*this);
 
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, labels[1])
-  ));
+    Operand{},
+    labels[1]
+  );
 
   node.getCondition()->accept(*this);
   const auto jumpOp = createJumpOpFromCondition(*node.getCondition(), false);
 
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     jumpOp,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, labels[0])
-  ));
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    labels[0]
+  );
+  m_instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, labels[2])
-  ));
+    Operand{},
+    labels[2]
+  );
 }
 
 void IRGenerator::visit(ForLoop &node) {
   m_forLabelCount++;
 
   const std::array labels {
-    ".L" + std::to_string(m_forLabelCount) + "_for_body",
-    ".L" + std::to_string(m_forLabelCount) + "_for_check",
-    ".L" + std::to_string(m_forLabelCount) + "_for_end",
+    Operand{TType::IDENT_VOID, ".L" + std::to_string(m_forLabelCount) + "_for_body"},
+    Operand{TType::IDENT_VOID, ".L" + std::to_string(m_forLabelCount) + "_for_check"},
+    Operand{TType::IDENT_VOID, ".L" + std::to_string(m_forLabelCount) + "_for_end"},
   };
 
   m_breakLabel.emplace(labels[2]);
   node.getInitial()->accept(*this);
 
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     Operation::JMP,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, labels[1])
-  ));
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    labels[1]
+  );
+  m_instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, labels[0])
-  ));
+    Operand{},
+    labels[0]
+  );
 
   node.getBody()->accept(*this);
   node.getIncrement()->accept(*this);
 
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, labels[1])
-  ));
+    Operand{},
+    labels[1]
+  );
 
   node.getCondition()->accept(*this);
   const auto jumpOp = createJumpOpFromCondition(*node.getCondition(), false);
 
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     jumpOp,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, labels[0])
-  ));
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    labels[0]
+  );
+  m_instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, labels[2])
-  ));
+    Operand{},
+    labels[2]
+  );
 }
 
 void IRGenerator::visit(ForEachLoop &node) {
@@ -831,41 +799,41 @@ void IRGenerator::visit(IfStmt &node) {
   m_ifLabelCount++;
 
   const std::array labels {
-    ".L" + std::to_string(m_ifLabelCount) + "_if_false",
-    ".L" + std::to_string(m_ifLabelCount) + "_if_end",
+    Operand{TType::IDENT_VOID, ".L" + std::to_string(m_ifLabelCount) + "_if_false"},
+    Operand{TType::IDENT_VOID, ".L" + std::to_string(m_ifLabelCount) + "_if_end"},
   };
 
   node.getCondition()->accept(*this);
   const auto jumpOp = createJumpOpFromCondition(*node.getCondition(), true);
 
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     jumpOp,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, labels[0])
-  ));
+    Operand{},
+    labels[0]
+  );
 
   node.getBody()->accept(*this);
 
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     Operation::JMP,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, labels[1])
-  ));
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    labels[1]
+  );
+  m_instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, labels[0])
-  ));
+    Operand{},
+    labels[0]
+  );
 
   for (const auto &stmt : node.getElseStatements()) {
     stmt->accept(*this);
   }
 
-  m_instructions.emplace_back(std::make_unique<Instruction>(
+  m_instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, labels[1])
-  ));
+    Operand{},
+    labels[1]
+  );
 }
 
 void IRGenerator::visit(ElseStmt &node) {
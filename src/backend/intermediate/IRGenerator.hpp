@@ -4,35 +4,28 @@
 #ifndef WISNIALANG_IR_GENERATOR_HPP
 #define WISNIALANG_IR_GENERATOR_HPP
 
-#include <memory>
-#include <vector>
+#include <span>
 #include <stack>
+#include <unordered_map>
+#include <vector>
 // Wisnia
 #include "IROptimization.hpp"
+#include "Instruction.hpp"
 #include "IRPrintHelper.hpp"
 #include "RegisterAllocator.hpp"
 #include "TType.hpp"
+#include "VirtualRegisters.hpp"
 #include "Visitor.hpp"
 
 namespace Wisnia {
-class Instruction;
-enum class Operation;
 
 class IRGenerator final : public Visitor {
-  using TokenPtr = std::shared_ptr<Basic::Token>;
-  using InstructionList = std::vector<std::shared_ptr<Instruction>>;
-  using TemporaryVariableList = std::vector<std::shared_ptr<AST::VarExpr>>;
-
-  template <typename T>
-  std::vector<T> vec_slice(const std::vector<T> &vec, size_t start, size_t end) {
-    const auto first = vec.begin() + start;
-    const auto last  = vec.begin() + end;
-    return std::vector<T>{first, last};
-  }
+  using InstructionList = std::vector<Instruction>;
 
  public:
-  explicit IRGenerator(const bool allocateRegisters = true)
-      : m_allocateRegisters{allocateRegisters} {}
+  explicit IRGenerator(const bool allocateRegisters = true,
+                       const RegisterAllocator::Algorithm algorithm = RegisterAllocator::Algorithm::LINEAR_SCAN)
+      : m_allocateRegisters{allocateRegisters}, registerAllocator{m_virtualRegisters, algorithm} {}
 
   enum class Transformation {
     NONE,
@@ -53,20 +46,24 @@ class IRGenerator final : public Visitor {
     }
   }
 
-  const TemporaryVariableList &getTemporaryVars() const {
-    return m_tempVars;
+  const VirtualRegisters &getVirtualRegisters() const {
+    return m_virtualRegisters;
+  }
+
+  const RegisterAllocator &getRegisterAllocator() const {
+    return registerAllocator;
   }
 
   void printInstructions(std::ostream &output, const Transformation transform) const {
     switch (transform) {
       case Transformation::NONE:
-        IRPrintHelper::print(output, m_instructions);
+        IRPrintHelper::print(output, m_instructions, &m_virtualRegisters);
         break;
       case Transformation::REGISTER_ALLOCATION:
-        IRPrintHelper::print(output, registerAllocator.getInstructions());
+        IRPrintHelper::print(output, registerAllocator.getInstructions(), &m_virtualRegisters);
         break;
       case Transformation::INSTRUCTION_OPTIMIZATION:
-        IRPrintHelper::print(output, irOptimization.getInstructions());
+        IRPrintHelper::print(output, irOptimization.getInstructions(), &m_virtualRegisters);
         break;
       default:
         assert(0 && "Unknown transformation type");
@@ -114,27 +111,39 @@ class IRGenerator final : public Visitor {
   void visit(AST::ElseIfStmt &) override;
 
  private:
-  AST::Root &popNode();
+  Operand popOperand();
+  Operand createTemporary(Basic::TType type);
+  // Variables are given a virtual register the first time they're seen in a function
+  Operand getVariable(const Basic::Token &token);
+  Operand getOperand(const Basic::Token &token);
   void createBinaryExpression(Basic::TType expressionType);
   Operation createJumpOpFromCondition(AST::Root &node, bool opposite);
 
   // In general, we want literal types to be associated with variables, but in the case of
   // "AST::WriteStmt", we perform a compile-time optimization to prevent loading modules for
   // printing variables whose values we already know at compile time
-  std::tuple<TokenPtr, Basic::TType> getExpression(AST::Root &node, bool createVariableForLiteral = true);
+  std::tuple<Operand, Basic::TType> getExpression(AST::Root &node, bool createVariableForLiteral = true);
 
  private:
-  std::stack<AST::Root *> m_stack;
+  std::stack<Operand> m_stack;
   std::stack<Operation> m_comparisonOp;
   InstructionList m_instructions;
-  TemporaryVariableList m_tempVars;
+  VirtualRegisters m_virtualRegisters;
+  // The virtual registers of the variables of the function being lowered
+  std::unordered_map<Basic::SymbolId, VirtualRegister> m_variables;
+  Operand m_lastTemporary;
+  // The return statements of the function being lowered leave the value in `m_returnValue` and
+  // jump to the function's epilogue at `m_returnLabel`
+  Operand m_returnLabel;
+  Operand m_returnValue;
+  size_t m_returnJumps{0};
   bool m_allocateRegisters; // We wish to skip register allocation in some unit tests
-  RegisterAllocator registerAllocator{};
+  RegisterAllocator registerAllocator;
   IROptimization irOptimization{};
   size_t m_ifLabelCount{0};
   size_t m_forLabelCount{0};
   size_t m_whileLabelCount{0};
-  std::stack<std::string> m_breakLabel;
+  std::stack<Operand> m_breakLabel;
 };
 
 }  // namespace Wisnia
@@ -5,18 +5,17 @@
 // Wisnia
 #include "IRPrintHelper.hpp"
 #include "Instruction.hpp"
-#include "Token.hpp"
 
 using namespace Wisnia;
 
-void IRPrintHelper::print(std::ostream &output, const InstructionList &instructions) {
+void IRPrintHelper::print(std::ostream &output, const InstructionList &instructions, const VirtualRegisters *names) {
   size_t maxTargetWidth{0}, maxArgOneWidth{0};
   for (const auto &ir : instructions) {
-    if (const auto &token = ir->getTarget(); token) {
-      maxTargetWidth = std::max(maxTargetWidth, token->getASTValueStr().size());
+    if (const auto operand = ir.getTarget(); operand) {
+      maxTargetWidth = std::max(maxTargetWidth, operand.getASTValueStr(names).size());
     }
-    if (const auto &instr = ir->getArg1(); instr) {
-      maxArgOneWidth = std::max(maxArgOneWidth, instr->getASTValueStr().size());
+    if (const auto operand = ir.getArg1(); operand) {
+      maxArgOneWidth = std::max(maxArgOneWidth, operand.getASTValueStr(names).size());
     }
   }
 
@@ -26,6 +25,6 @@ void IRPrintHelper::print(std::ostream &output, const InstructionList &instructi
   output << fmt::format("{:^{}}|{:^14}|{:^{}}|{:^34}\n", "Target", maxTargetWidth + 21, "Op", "Arg1", maxArgOneWidth + 21, "Arg2");
   output << fmt::format("{:->{}}{:->{}}{:->{}}{:->{}}\n", "+", maxTargetWidth + 22, "+", 15, "+", maxArgOneWidth + 22, "", 34);
   for (const auto &ir : instructions) {
-    ir->print(output);
+    ir.print(output, names);
   }
 }
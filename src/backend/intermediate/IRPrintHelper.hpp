@@ -4,17 +4,19 @@
 #ifndef WISNIALANG_IR_PRINT_HELPER_HPP
 #define WISNIALANG_IR_PRINT_HELPER_HPP
 
-#include <memory>
+#include <iosfwd>
 #include <vector>
 
 namespace Wisnia {
 class Instruction;
+class VirtualRegisters;
 
 class IRPrintHelper {
-  using InstructionList = std::vector<std::shared_ptr<Instruction>>;
+  using InstructionList = std::vector<Instruction>;
 
  public:
-  static void print(std::ostream &output, const InstructionList &instructions);
+  // Variables are printed by their names if these are given
+  static void print(std::ostream &output, const InstructionList &instructions, const VirtualRegisters *names = nullptr);
 };
 
 }  // namespace Wisnia
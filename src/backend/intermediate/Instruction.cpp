@@ -9,18 +9,105 @@
 using namespace Wisnia;
 using namespace Basic;
 
-void Instruction::print(std::ostream &output) const {
+Operand::Operand(const Token &token) : m_type{token.getType()} {
+  switch (getKind(m_type)) {
+    case Kind::REGISTER:
+      m_value = token.getValue<Basic::register_t>();
+      break;
+    case Kind::INTEGER:
+      m_value = std::bit_cast<uint32_t>(token.getValue<int>());
+      break;
+    case Kind::FLOAT:
+      m_value = std::bit_cast<uint32_t>(token.getValue<float>());
+      break;
+    case Kind::BOOLEAN:
+      m_value = token.getValue<bool>();
+      break;
+    case Kind::SYMBOL:
+      m_value = StringInterner::global().intern(token.getValue<std::string>());
+      break;
+    case Kind::VIRTUAL:
+      throw InstructionError{"Variable " + token.getValue<std::string>() + " doesn't have a virtual register"};
+    default:
+      throw InstructionError{"Token of type " + TokenType2Str[m_type] + " can't be an operand"};
+  }
+}
+
+std::string Operand::getValueStr(const VirtualRegisters *names) const {
+  switch (getKind(m_type)) {
+    case Kind::REGISTER:
+      return std::string{Register2Str[getValue<Basic::register_t>()]};
+    case Kind::INTEGER:
+      return std::to_string(getValue<int>());
+    case Kind::FLOAT:
+      return std::to_string(getValue<float>());
+    case Kind::BOOLEAN:
+      return getValue<bool>() ? "true" : "false";
+    case Kind::VIRTUAL:
+      if (names) {
+        return names->getName(getVirtualRegister());
+      }
+      return "%" + std::to_string(m_value);
+    case Kind::SYMBOL:
+      return getValue<std::string>();
+    default:
+      return "null";
+  }
+}
+
+std::string Operand::getASTValueStr(const VirtualRegisters *names) const {
+  if (m_type == TType::LIT_STR) {
+    return Token{m_type, getValue<std::string>()}.getASTValueStr();
+  }
+  return getValueStr(names);
+}
+
+namespace {
+// Instructions of the form `target = target <op> arg`
+constexpr bool isReadModifyWrite(const Operation op) {
+  return (op >= Operation::IADD && op <= Operation::FNE) ||
+         op == Operation::NOT || op == Operation::AND || op == Operation::OR || op == Operation::XOR;
+}
+}  // namespace
+
+bool Instruction::isUse(const size_t index) const {
+  switch (index) {
+    case kTarget:
+      return isReadModifyWrite(m_operation) || m_operation == Operation::MOV_MEMORY;
+    case kArgOne:
+      return m_operation != Operation::POP;
+    default:
+      return true;
+  }
+}
+
+bool Instruction::isDefinition(const size_t index) const {
+  switch (index) {
+    case kTarget:
+      return isReadModifyWrite(m_operation) || m_operation == Operation::MOV || m_operation == Operation::LEA ||
+             m_operation == Operation::LOAD;
+    case kArgOne:
+      return m_operation == Operation::POP;
+    default:
+      return false;
+  }
+}
+
+void Instruction::print(std::ostream &output, const VirtualRegisters *names) const {
+  const auto target = getTarget();
+  const auto arg1 = getArg1();
+  const auto arg2 = getArg2();
   output << fmt::format("{:^{}} %% {:<15}|{:^14}|{:^{}} %% {:<15}|{:^15} %% {:<15}\n",
     // target
-    m_target ? m_target->getASTValueStr() : "", sPrintTargetWidth + 2,
-    m_target ? TokenType2Str[m_target->getType()] : "",
+    target ? target.getASTValueStr(names) : "", sPrintTargetWidth + 2,
+    target ? TokenType2Str[target.getType()] : "",
     // operation
     Operation2Str[m_operation],
     // arg1
-    m_arg1 ? m_arg1->getASTValueStr() : "", sPrintArgOneWidth + 2,
-    m_arg1 ? TokenType2Str[m_arg1->getType()] : "",
+    arg1 ? arg1.getASTValueStr(names) : "", sPrintArgOneWidth + 2,
+    arg1 ? TokenType2Str[arg1.getType()] : "",
     // arg2
-    m_arg2 ? m_arg2->getASTValueStr() : "",
-    m_arg2 ? TokenType2Str[m_arg2->getType()] : ""
+    arg2 ? arg2.getASTValueStr(names) : "",
+    arg2 ? TokenType2Str[arg2.getType()] : ""
   );
 }
@@ -4,44 +4,216 @@
 #ifndef WISNIALANG_INSTRUCTION_HPP
 #define WISNIALANG_INSTRUCTION_HPP
 
-#include <memory>
-#include <utility>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <type_traits>
 // Wisnia
+#include "Exceptions.hpp"
 #include "Operation.hpp"
+#include "Register.hpp"
+#include "StringInterner.hpp"
+#include "TType.hpp"
+#include "VirtualRegisters.hpp"
 
 namespace Wisnia {
 namespace Basic {
 class Token;
 }  // namespace Basic
 
-class Instruction {
-  using TokenPtr = std::shared_ptr<Basic::Token>;
+// An operand of an instruction, tagged by its token type: a register, an immediate value, the
+// virtual register of a variable, or the interned symbol of a label or a string literal. Operands
+// are plain values, so that rewriting one, e.g. when assigning it a register, never affects the others
+class Operand {
+  enum class Kind : uint8_t {
+    NONE,
+    REGISTER,
+    INTEGER,
+    FLOAT,
+    BOOLEAN,
+    VIRTUAL,
+    SYMBOL
+  };
+
+  static constexpr Kind getKind(const Basic::TType type) {
+    switch (type) {
+      case Basic::TType::REGISTER:
+        return Kind::REGISTER;
+      case Basic::TType::LIT_INT:
+        return Kind::INTEGER;
+      case Basic::TType::LIT_FLT:
+        return Kind::FLOAT;
+      case Basic::TType::LIT_BOOL:
+      case Basic::TType::KW_TRUE:
+      case Basic::TType::KW_FALSE:
+        return Kind::BOOLEAN;
+      case Basic::TType::IDENT_INT:
+      case Basic::TType::IDENT_BOOL:
+      case Basic::TType::IDENT_FLOAT:
+      case Basic::TType::IDENT_STRING:
+        return Kind::VIRTUAL;
+      case Basic::TType::LIT_STR:
+      case Basic::TType::IDENT:
+      case Basic::TType::IDENT_VOID:
+        return Kind::SYMBOL;
+      default:
+        return Kind::NONE;
+    }
+  }
+
+  template <typename T>
+  static constexpr Kind getKind() {
+    if constexpr (std::is_same_v<T, Basic::register_t>) return Kind::REGISTER;
+    else if constexpr (std::is_same_v<T, int>) return Kind::INTEGER;
+    else if constexpr (std::is_same_v<T, float>) return Kind::FLOAT;
+    else if constexpr (std::is_same_v<T, bool>) return Kind::BOOLEAN;
+    else if constexpr (std::is_same_v<T, VirtualRegister>) return Kind::VIRTUAL;
+    else return Kind::SYMBOL;
+  }
+
+  Operand(const Basic::TType type, const uint32_t value, const Kind kind) : m_type{type}, m_value{value} {
+    if (getKind(type) != kind) {
+      throw InstructionError{"Operand value doesn't match its type " + Basic::TokenType2Str[type]};
+    }
+  }
+
+ public:
+  // No operand
+  constexpr Operand() = default;
+
+  Operand(const Basic::TType type, const Basic::register_t reg) : Operand{type, reg, Kind::REGISTER} {}
+  Operand(const Basic::TType type, const int value) : Operand{type, std::bit_cast<uint32_t>(value), Kind::INTEGER} {}
+  Operand(const Basic::TType type, const float value) : Operand{type, std::bit_cast<uint32_t>(value), Kind::FLOAT} {}
+  Operand(const Basic::TType type, const bool value) : Operand{type, value, Kind::BOOLEAN} {}
+  Operand(const Basic::TType type, const VirtualRegister reg)
+      : Operand{type, static_cast<uint32_t>(reg), Kind::VIRTUAL} {}
+  Operand(const Basic::TType type, const std::string_view name)
+      : Operand{type, Basic::StringInterner::global().intern(name), Kind::SYMBOL} {}
+  Operand(const Basic::TType type, const char *name) : Operand{type, std::string_view{name}} {}
+
+  // Takes both the type and the value of a token from the AST. Variables can't be taken this
+  // way, as they're given a virtual register while lowering the AST
+  explicit Operand(const Basic::Token &token);
+
+  Basic::TType getType() const { return m_type; }
+  explicit operator bool() const { return getKind(m_type) != Kind::NONE; }
+  bool operator==(const Operand &) const = default;
+
+  template <typename T>
+  T getValue() const {
+    if (getKind(m_type) != getKind<T>()) {
+      throw TokenError{"Operand of type " + Basic::TokenType2Str[m_type] + " holds a different value"};
+    }
+    if constexpr (std::is_same_v<T, std::string>) {
+      return std::string{Basic::StringInterner::global().lookup(m_value)};
+    } else if constexpr (std::is_same_v<T, std::string_view>) {
+      return Basic::StringInterner::global().lookup(m_value);
+    } else if constexpr (std::is_same_v<T, int> || std::is_same_v<T, float>) {
+      return std::bit_cast<T>(m_value);
+    } else {
+      return static_cast<T>(m_value);
+    }
+  }
+
+  // The symbol of a label or a string literal
+  Basic::SymbolId getSymbol() const { return getValue<Basic::SymbolId>(); }
+  VirtualRegister getVirtualRegister() const { return getValue<VirtualRegister>(); }
+
+  constexpr bool isIdentifierType() const {
+    return m_type == Basic::TType::IDENT_INT    || m_type == Basic::TType::IDENT_FLOAT ||
+           m_type == Basic::TType::IDENT_STRING || m_type == Basic::TType::IDENT_BOOL;
+  }
+
+  constexpr bool isLiteralType() const {
+    return m_type == Basic::TType::LIT_INT  || m_type == Basic::TType::LIT_FLT || m_type == Basic::TType::LIT_STR ||
+           m_type == Basic::TType::LIT_BOOL || m_type == Basic::TType::KW_TRUE || m_type == Basic::TType::KW_FALSE;
+  }
+
+  constexpr bool isLiteralIntegerType() const {
+    return m_type == Basic::TType::LIT_INT;
+  }
 
+  // Virtual registers are printed by their names if these are given, or by their numbers otherwise
+  std::string getValueStr(const VirtualRegisters *names = nullptr) const;
+  // Primarily used in IR output for pretty operand's value printing
+  std::string getASTValueStr(const VirtualRegisters *names = nullptr) const;
+
+ private:
+  friend class Instruction;
+
+  Basic::TType m_type{Basic::TType::TOK_INVALID};
+  uint32_t m_value{0};
+};
+
+// A three-address instruction. The operand types and values are stored in separate arrays, so
+// that an instruction takes 16 bytes and can be kept by value in a contiguous list
+class Instruction {
   static inline size_t sPrintTargetWidth{15};
   static inline size_t sPrintArgOneWidth{15};
 
  public:
+  static constexpr size_t kOperands{3};
+  static constexpr size_t kTarget{0};
+  static constexpr size_t kArgOne{1};
+  static constexpr size_t kArgTwo{2};
+
   explicit Instruction(
     const Operation op,
-    TokenPtr target = nullptr,
-    TokenPtr arg1   = nullptr,
-    TokenPtr arg2   = nullptr
-  ) : m_operation{op}, m_target{std::move(target)}, m_arg1{std::move(arg1)}, m_arg2{std::move(arg2)} {}
+    const Operand &target = {},
+    const Operand &arg1   = {},
+    const Operand &arg2   = {}
+  ) : m_operation{op} {
+    setOperand(kTarget, target);
+    setOperand(kArgOne, arg1);
+    setOperand(kArgTwo, arg2);
+  }
 
-  const Operation &getOperation() const { return m_operation; }
-  TokenPtr &getTarget() { return m_target; }
-  TokenPtr &getArg1() { return m_arg1; }
-  TokenPtr &getArg2() { return m_arg2; }
+  Operation getOperation() const { return m_operation; }
+  Operand getTarget() const { return getOperand(kTarget); }
+  Operand getArg1() const { return getOperand(kArgOne); }
+  Operand getArg2() const { return getOperand(kArgTwo); }
+
+  Operand getOperand(const size_t index) const {
+    Operand operand{};
+    operand.m_type = static_cast<Basic::TType>(m_types[index]);
+    operand.m_value = m_values[index];
+    return operand;
+  }
+
+  void setOperand(const size_t index, const Operand &operand) {
+    m_types[index] = static_cast<uint8_t>(operand.m_type);
+    m_values[index] = operand.m_value;
+  }
+
+  // Whether the instruction reads or writes its operand at the index. The target of an arithmetic
+  // instruction is both, e.g. in `_tx = _tx + b`
+  bool isUse(size_t index) const;
+  bool isDefinition(size_t index) const;
+
+  bool isJump() const {
+    return m_operation >= Operation::JMP && m_operation <= Operation::JNZ;
+  }
+
+  bool isConditionalJump() const {
+    return isJump() && m_operation != Operation::JMP;
+  }
 
   static void setPrintTargetWidth(const size_t width) { sPrintTargetWidth = width; }
   static void setPrintArgOneWidth(const size_t width) { sPrintArgOneWidth = width; }
-  void print(std::ostream &output) const;
+  void print(std::ostream &output, const VirtualRegisters *names = nullptr) const;
 
  private:
   Operation m_operation;
-  TokenPtr m_target, m_arg1, m_arg2;
+  std::array<uint8_t, kOperands> m_types;
+  std::array<uint32_t, kOperands> m_values;
 };
 
+static_assert(static_cast<size_t>(Basic::TType::TOK_EOF) <= UINT8_MAX, "Token types must fit in a byte");
+static_assert(sizeof(Instruction) == 16 && std::is_trivially_copyable_v<Instruction>);
+
 }  // namespace Wisnia
 
 #endif  // WISNIALANG_INSTRUCTION_HPP
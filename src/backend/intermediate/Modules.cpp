@@ -7,7 +7,6 @@
 #include "Instruction.hpp"
 #include "Register.hpp"
 #include "TType.hpp"
-#include "Token.hpp"
 
 using namespace Wisnia;
 using namespace Basic;
@@ -44,66 +43,66 @@ __builtin_calculate_string_length:
 Modules::InstructionList Modules::moduleCalculateStringLength() {
   InstructionList instructions{};
 
-  instructions.emplace_back(std::make_unique<Instruction>(
+  instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, Module2Str[CALCULATE_STRING_LENGTH])
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::IDENT_VOID, Module2Str[CALCULATE_STRING_LENGTH]}
+  );
+  instructions.emplace_back(
     Operation::PUSH,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RSI)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RSI}
+  );
+  instructions.emplace_back(
     Operation::XOR,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RDX),
-    std::make_shared<Token>(TType::REGISTER, RDX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RDX},
+    Operand{TType::REGISTER, RDX}
+  );
+  instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, ".calculate_string_length_loop")
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::IDENT_VOID, ".calculate_string_length_loop"}
+  );
+  instructions.emplace_back(
     Operation::CMP_BYTE_PTR,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RSI),
-    std::make_shared<Token>(TType::LIT_INT, 0)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RSI},
+    Operand{TType::LIT_INT, 0}
+  );
+  instructions.emplace_back(
     Operation::JE,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, ".calculate_string_length_exit_loop")
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::IDENT_VOID, ".calculate_string_length_exit_loop"}
+  );
+  instructions.emplace_back(
     Operation::INC,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RDX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RDX}
+  );
+  instructions.emplace_back(
     Operation::INC,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RSI)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RSI}
+  );
+  instructions.emplace_back(
     Operation::JMP,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, ".calculate_string_length_loop")
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::IDENT_VOID, ".calculate_string_length_loop"}
+  );
+  instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, ".calculate_string_length_exit_loop")
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::IDENT_VOID, ".calculate_string_length_exit_loop"}
+  );
+  instructions.emplace_back(
     Operation::POP,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RSI)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RSI}
+  );
+  instructions.emplace_back(
     Operation::RET
-  ));
+  );
 
   return instructions;
 }
@@ -147,154 +146,154 @@ __builtin_print_number:
 Modules::InstructionList Modules::modulePrintUintNumber() {
   InstructionList instructions{};
 
-  instructions.emplace_back(std::make_unique<Instruction>(
+  instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, Module2Str[PRINT_NUMBER])
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::IDENT_VOID, Module2Str[PRINT_NUMBER]}
+  );
+  instructions.emplace_back(
     Operation::PUSH,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RAX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RAX}
+  );
+  instructions.emplace_back(
     Operation::PUSH,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RCX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RCX}
+  );
+  instructions.emplace_back(
     Operation::PUSH,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, R11)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, R11}
+  );
+  instructions.emplace_back(
     Operation::PUSH,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RSI)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RSI}
+  );
+  instructions.emplace_back(
     Operation::PUSH,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RDX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RDX}
+  );
+  instructions.emplace_back(
     Operation::MOV,
-    std::make_shared<Token>(TType::REGISTER, RAX),
-    std::make_shared<Token>(TType::REGISTER, RDI)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, RAX},
+    Operand{TType::REGISTER, RDI}
+  );
+  instructions.emplace_back(
     Operation::MOV,
-    std::make_shared<Token>(TType::REGISTER, RCX),
-    std::make_shared<Token>(TType::LIT_INT, 10)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, RCX},
+    Operand{TType::LIT_INT, 10}
+  );
+  instructions.emplace_back(
     Operation::MOV,
-    std::make_shared<Token>(TType::REGISTER, RSI),
-    std::make_shared<Token>(TType::REGISTER, RSP)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, RSI},
+    Operand{TType::REGISTER, RSP}
+  );
+  instructions.emplace_back(
     Operation::ISUB,
-    std::make_shared<Token>(TType::REGISTER, RSP),
-    std::make_shared<Token>(TType::LIT_INT, 16)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, RSP},
+    Operand{TType::LIT_INT, 16}
+  );
+  instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, ".print_number_loop")
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::IDENT_VOID, ".print_number_loop"}
+  );
+  instructions.emplace_back(
     Operation::XOR,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, EDX),
-    std::make_shared<Token>(TType::REGISTER, EDX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, EDX},
+    Operand{TType::REGISTER, EDX}
+  );
+  instructions.emplace_back(
     Operation::IDIV,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RCX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RCX}
+  );
+  instructions.emplace_back(
     Operation::IADD,
-    std::make_shared<Token>(TType::REGISTER, EDX),
-    std::make_shared<Token>(TType::LIT_INT, 48) // '0'
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, EDX},
+    Operand{TType::LIT_INT, 48} // '0'
+  );
+  instructions.emplace_back(
     Operation::DEC,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RSI)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RSI}
+  );
+  instructions.emplace_back(
     Operation::MOV_MEMORY,
-    std::make_shared<Token>(TType::REGISTER, RSI),
-    std::make_shared<Token>(TType::REGISTER, DL)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, RSI},
+    Operand{TType::REGISTER, DL}
+  );
+  instructions.emplace_back(
     Operation::TEST,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RAX),
-    std::make_shared<Token>(TType::REGISTER, RAX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RAX},
+    Operand{TType::REGISTER, RAX}
+  );
+  instructions.emplace_back(
     Operation::JNZ,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, ".print_number_loop")
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::IDENT_VOID, ".print_number_loop"}
+  );
+  instructions.emplace_back(
     Operation::MOV,
-    std::make_shared<Token>(TType::REGISTER, RAX),
-    std::make_shared<Token>(TType::LIT_INT, 1)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, RAX},
+    Operand{TType::LIT_INT, 1}
+  );
+  instructions.emplace_back(
     Operation::MOV,
-    std::make_shared<Token>(TType::REGISTER, RDI),
-    std::make_shared<Token>(TType::LIT_INT, 1)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, RDI},
+    Operand{TType::LIT_INT, 1}
+  );
+  instructions.emplace_back(
     Operation::LEA,
-    std::make_shared<Token>(TType::REGISTER, EDX),
-    std::make_shared<Token>(TType::LIT_INT, 16)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, EDX},
+    Operand{TType::LIT_INT, 16}
+  );
+  instructions.emplace_back(
     Operation::ISUB,
-    std::make_shared<Token>(TType::REGISTER, EDX),
-    std::make_shared<Token>(TType::REGISTER, ESI)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, EDX},
+    Operand{TType::REGISTER, ESI}
+  );
+  instructions.emplace_back(
     Operation::SYSCALL
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+  );
+  instructions.emplace_back(
     Operation::IADD,
-    std::make_shared<Token>(TType::REGISTER, RSP),
-    std::make_shared<Token>(TType::LIT_INT, 16)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, RSP},
+    Operand{TType::LIT_INT, 16}
+  );
+  instructions.emplace_back(
     Operation::POP,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RDX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RDX}
+  );
+  instructions.emplace_back(
     Operation::POP,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RSI)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RSI}
+  );
+  instructions.emplace_back(
     Operation::POP,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, R11)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, R11}
+  );
+  instructions.emplace_back(
     Operation::POP,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RCX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RCX}
+  );
+  instructions.emplace_back(
     Operation::POP,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RAX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RAX}
+  );
+  instructions.emplace_back(
     Operation::RET
-  ));
+  );
 
   return instructions;
 }
@@ -330,123 +329,123 @@ __builtin_print_boolean:
 Modules::InstructionList Modules::modulePrintBoolean() {
   InstructionList instructions{};
 
-  instructions.emplace_back(std::make_unique<Instruction>(
+  instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, Module2Str[PRINT_BOOLEAN])
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::IDENT_VOID, Module2Str[PRINT_BOOLEAN]}
+  );
+  instructions.emplace_back(
     Operation::PUSH,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RAX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RAX}
+  );
+  instructions.emplace_back(
     Operation::PUSH,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RCX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RCX}
+  );
+  instructions.emplace_back(
     Operation::PUSH,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, R11)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, R11}
+  );
+  instructions.emplace_back(
     Operation::PUSH,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RDX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RDX}
+  );
+  instructions.emplace_back(
     Operation::PUSH,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RSI)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RSI}
+  );
+  instructions.emplace_back(
     Operation::CMP,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RDI),
-    std::make_shared<Token>(TType::LIT_INT, 0)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RDI},
+    Operand{TType::LIT_INT, 0}
+  );
+  instructions.emplace_back(
     Operation::JZ,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, ".print_boolean_false")
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::IDENT_VOID, ".print_boolean_false"}
+  );
+  instructions.emplace_back(
     Operation::MOV,
-    std::make_shared<Token>(TType::REGISTER, RDX),
-    std::make_shared<Token>(TType::LIT_INT, 4)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, RDX},
+    Operand{TType::LIT_INT, 4}
+  );
+  instructions.emplace_back(
     Operation::MOV,
-    std::make_shared<Token>(TType::REGISTER, RSI),
-    std::make_shared<Token>(TType::LIT_STR, "true")
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, RSI},
+    Operand{TType::LIT_STR, "true"}
+  );
+  instructions.emplace_back(
     Operation::JMP,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, ".print_boolean_skip")
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::IDENT_VOID, ".print_boolean_skip"}
+  );
+  instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, ".print_boolean_false")
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::IDENT_VOID, ".print_boolean_false"}
+  );
+  instructions.emplace_back(
     Operation::MOV,
-    std::make_shared<Token>(TType::REGISTER, RDX),
-    std::make_shared<Token>(TType::LIT_INT, 5)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, RDX},
+    Operand{TType::LIT_INT, 5}
+  );
+  instructions.emplace_back(
     Operation::MOV,
-    std::make_shared<Token>(TType::REGISTER, RSI),
-    std::make_shared<Token>(TType::LIT_STR, "false")
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, RSI},
+    Operand{TType::LIT_STR, "false"}
+  );
+  instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, ".print_boolean_skip")
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::IDENT_VOID, ".print_boolean_skip"}
+  );
+  instructions.emplace_back(
     Operation::MOV,
-    std::make_shared<Token>(TType::REGISTER, RAX),
-    std::make_shared<Token>(TType::LIT_INT, 1)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, RAX},
+    Operand{TType::LIT_INT, 1}
+  );
+  instructions.emplace_back(
     Operation::MOV,
-    std::make_shared<Token>(TType::REGISTER, RDI),
-    std::make_shared<Token>(TType::LIT_INT, 1)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, RDI},
+    Operand{TType::LIT_INT, 1}
+  );
+  instructions.emplace_back(
     Operation::SYSCALL
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+  );
+  instructions.emplace_back(
     Operation::POP,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RSI)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RSI}
+  );
+  instructions.emplace_back(
     Operation::POP,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RDX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RDX}
+  );
+  instructions.emplace_back(
     Operation::POP,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, R11)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, R11}
+  );
+  instructions.emplace_back(
     Operation::POP,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RCX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RCX}
+  );
+  instructions.emplace_back(
     Operation::POP,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RAX)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RAX}
+  );
+  instructions.emplace_back(
     Operation::RET
-  ));
+  );
 
   return instructions;
 }
@@ -460,25 +459,25 @@ __builtin_exit:
 Modules::InstructionList Modules::moduleExit() {
   InstructionList instructions{};
 
-  instructions.emplace_back(std::make_unique<Instruction>(
+  instructions.emplace_back(
     Operation::LABEL,
-    nullptr,
-    std::make_shared<Token>(TType::IDENT_VOID, Module2Str[EXIT])
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::IDENT_VOID, Module2Str[EXIT]}
+  );
+  instructions.emplace_back(
     Operation::XOR,
-    nullptr,
-    std::make_shared<Token>(TType::REGISTER, RDI),
-    std::make_shared<Token>(TType::REGISTER, RDI)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{},
+    Operand{TType::REGISTER, RDI},
+    Operand{TType::REGISTER, RDI}
+  );
+  instructions.emplace_back(
     Operation::MOV,
-    std::make_shared<Token>(TType::REGISTER, RAX),
-    std::make_shared<Token>(TType::LIT_INT, 60)
-  ));
-  instructions.emplace_back(std::make_unique<Instruction>(
+    Operand{TType::REGISTER, RAX},
+    Operand{TType::LIT_INT, 60}
+  );
+  instructions.emplace_back(
     Operation::SYSCALL
-  ));
+  );
 
   return instructions;
 }
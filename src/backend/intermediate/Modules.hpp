@@ -5,12 +5,12 @@
 #define WISNIALANG_MODULES_HPP
 
 #include <array>
-#include <memory>
 #include <unordered_map>
 #include <vector>
+// Wisnia
+#include "Instruction.hpp"
 
 namespace Wisnia {
-class Instruction;
 
 enum Module : uint8_t {
   CALCULATE_STRING_LENGTH,
@@ -27,7 +27,7 @@ static inline std::unordered_map<Module, std::string> Module2Str {
 };
 
 class Modules {
-  using InstructionList = std::vector<std::shared_ptr<Instruction>>;
+  using InstructionList = std::vector<Instruction>;
 
   static inline std::array<bool, 4> m_isUsed {
     false, false, false, false
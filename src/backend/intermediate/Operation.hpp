@@ -4,12 +4,13 @@
 #ifndef WISNIALANG_OPERATION_HPP
 #define WISNIALANG_OPERATION_HPP
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 
 namespace Wisnia {
 
-enum class Operation {
+enum class Operation : uint8_t {
   /* arithmetic (each for int and float) */
   IADD,  FADD,    // add
   ISUB,  FSUB,    // subtract
@@ -46,9 +47,13 @@ enum class Operation {
   LEA,
   MOV,            // copies the value from rhs register to lhs register
   MOV_MEMORY,     // copies the value from rhs register to memory address contained in lhs
+  LOAD,           // copies the value from the stack slot at the offset from rsp in rhs to lhs register
+  STORE,          // copies the value from rhs register to the stack slot at the offset from rsp in lhs
   PUSH,           // push value on the stack
   POP,            // pop value from the stack
   CALL,           // function invocation
+  SAVE,           // save the registers that are live across a function invocation
+  RESTORE,        // restore the registers saved by the matching SAVE
   SYSCALL,        // system call
   LABEL,          // label
   RET,            // function return
@@ -91,9 +96,13 @@ static inline std::unordered_map<Operation, std::string_view> Operation2Str {
   {Operation::LEA,        "lea"     },
   {Operation::MOV,        "<-"      },
   {Operation::MOV_MEMORY, "[] <-"   },
+  {Operation::LOAD,       "load"    },
+  {Operation::STORE,      "store"   },
   {Operation::PUSH,       "push"    },
   {Operation::POP,        "pop"     },
   {Operation::CALL,       "call"    },
+  {Operation::SAVE,       "save"    },
+  {Operation::RESTORE,    "restore" },
   {Operation::SYSCALL,    "syscall" },
   {Operation::LABEL,      "label"   },
   {Operation::RET,        "ret"     },
@@ -0,0 +1,75 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_VIRTUAL_REGISTERS_HPP
+#define WISNIALANG_VIRTUAL_REGISTERS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+// Wisnia
+#include "StringInterner.hpp"
+
+namespace Wisnia {
+
+// A variable or a temporary of the IR, numbered in the order they're created
+enum class VirtualRegister : uint32_t {};
+
+// Hands out the virtual registers while lowering the AST. Their names are only kept for printing
+// the IR: a variable is printed by its name, a temporary by the order it was created in, and a
+// version of either in SSA form by the name of the original followed by the version, e.g. `a.2`
+class VirtualRegisters {
+  enum class Kind : uint8_t {
+    VARIABLE,
+    TEMPORARY,
+    VERSION
+  };
+
+  struct Name {
+    // The symbol of a variable, the number of a temporary, or the original of a version
+    uint32_t m_value;
+    uint32_t m_version;
+    Kind m_kind;
+  };
+
+ public:
+  VirtualRegister createVariable(const Basic::SymbolId name) {
+    return create({name, 0, Kind::VARIABLE});
+  }
+
+  VirtualRegister createTemporary() {
+    return create({m_temporaries++, 0, Kind::TEMPORARY});
+  }
+
+  VirtualRegister createVersion(const VirtualRegister original, const uint32_t version) {
+    return create({static_cast<uint32_t>(original), version, Kind::VERSION});
+  }
+
+  std::string getName(const VirtualRegister reg) const {
+    const auto &name = m_names[static_cast<uint32_t>(reg)];
+    switch (name.m_kind) {
+      case Kind::TEMPORARY:
+        return "_t" + std::to_string(name.m_value);
+      case Kind::VERSION:
+        return getName(static_cast<VirtualRegister>(name.m_value)) + "." + std::to_string(name.m_version);
+      default:
+        return std::string{Basic::StringInterner::global().lookup(name.m_value)};
+    }
+  }
+
+  size_t size() const { return m_names.size(); }
+  size_t getTemporaryCount() const { return m_temporaries; }
+
+ private:
+  VirtualRegister create(const Name name) {
+    m_names.push_back(name);
+    return static_cast<VirtualRegister>(m_names.size() - 1);
+  }
+
+  std::vector<Name> m_names;
+  uint32_t m_temporaries{0};
+};
+
+}  // namespace Wisnia
+
+#endif  // WISNIALANG_VIRTUAL_REGISTERS_HPP
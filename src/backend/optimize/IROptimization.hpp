@@ -4,23 +4,24 @@
 #ifndef WISNIALANG_IR_OPTIMIZATION_HPP
 #define WISNIALANG_IR_OPTIMIZATION_HPP
 
-#include <memory>
+#include <span>
+#include <vector>
 // Wisnia
 #include "IRPrintHelper.hpp"
+#include "Instruction.hpp"
 
 namespace Wisnia {
-class Instruction;
 
 class IROptimization {
-  using InstructionList = std::vector<std::shared_ptr<Instruction>>;
+  using InstructionList = std::vector<Instruction>;
 
  public:
-  void optimize(InstructionList &&instructions);
+  void optimize(std::span<const Instruction> instructions);
   const InstructionList &getInstructions() const { return m_instructions; }
   void print(std::ostream &output) const { IRPrintHelper::print(output, m_instructions); }
 
  private:
-  void removeRedundantInstructions(InstructionList &instructions) const;
+  static bool isRedundant(const Instruction &instruction);
 
  private:
   InstructionList m_instructions;
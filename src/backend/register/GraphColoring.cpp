@@ -0,0 +1,375 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+// Wisnia
+#include "GraphColoring.hpp"
+#include "RegisterAllocator.hpp"
+#include "SparseSet.hpp"
+
+using namespace Wisnia;
+using namespace Basic;
+
+namespace {
+constexpr auto kColors = static_cast<uint32_t>(RegisterAllocator::getAllocatableRegisters.size());
+
+// A move between two variables, which coalescing them removes
+bool isCopy(const Instruction &instruction) {
+  return instruction.getOperation() == Operation::MOV && instruction.getTarget().isIdentifierType() &&
+         instruction.getArg1().isIdentifierType() && instruction.getTarget() != instruction.getArg1();
+}
+}  // namespace
+
+GraphColoring::GraphColoring(const std::span<const Instruction> function, const ControlFlowGraph &graph,
+                             const Liveness &liveness, std::vector<Node> nodes)
+    : m_nodes{std::move(nodes)},
+      m_states(m_nodes.size(), State::ABSENT),
+      m_degrees(m_nodes.size(), 0),
+      m_aliases(m_nodes.size()),
+      m_adjacency(m_nodes.size()),
+      m_nodeMoves(m_nodes.size()),
+      m_registers(m_nodes.size()) {
+  build(function, graph, liveness);
+
+  // Each node starts out on the worklist that its degree and its moves call for
+  for (uint32_t node = 0; node < m_nodes.size(); node++) {
+    m_aliases[node] = node;
+    if (m_states[node] != State::ABSENT) {
+      m_states[node] = State::ABSENT;
+      setState(node, m_degrees[node] >= kColors ? State::SPILL
+                     : isMoveRelated(node)     ? State::FREEZE
+                                               : State::SIMPLIFY);
+    }
+  }
+
+  const auto pop = [&](std::vector<uint32_t> &worklist, const State state) -> std::optional<uint32_t> {
+    while (!worklist.empty()) {
+      const auto node = worklist.back();
+      worklist.pop_back();
+      if (m_states[node] == state) {
+        return node;
+      }
+    }
+    return std::nullopt;
+  };
+  const auto popMove = [&]() -> std::optional<size_t> {
+    while (!m_moveWorklist.empty()) {
+      const auto move = m_moveWorklist.back();
+      m_moveWorklist.pop_back();
+      if (m_moves[move].m_state == MoveState::WORKLIST) {
+        return move;
+      }
+    }
+    return std::nullopt;
+  };
+
+  for (;;) {
+    if (const auto node = pop(m_simplifyWorklist, State::SIMPLIFY)) {
+      simplify(*node);
+    } else if (const auto move = popMove()) {
+      coalesce(*move);
+    } else if (const auto frozen = pop(m_freezeWorklist, State::FREEZE)) {
+      freeze(*frozen);
+    } else if (!selectSpill()) {
+      break;
+    }
+  }
+  assignRegisters();
+}
+
+// A variable interferes with the ones live after each instruction that writes it. The source of a
+// move doesn't interfere with its target, since they hold the same value, which lets them share a
+// register
+void GraphColoring::build(const std::span<const Instruction> function, const ControlFlowGraph &graph,
+                          const Liveness &liveness) {
+  const auto first = liveness.getFirstVariable();
+  const auto nodeOf = [&](const Operand &operand) {
+    return static_cast<uint32_t>(operand.getVirtualRegister()) - first;
+  };
+  SparseSet live{m_nodes.size()};
+  for (ControlFlowGraph::Index block = 0; block < graph.getBlocks().size(); block++) {
+    live.clear();
+    liveness.forEachLiveOut(block, [&](const VirtualRegister reg) {
+      live.insert(static_cast<uint32_t>(reg) - first);
+    });
+    for (size_t i = graph.getBlock(block).m_end; i-- > graph.getBlock(block).m_begin;) {
+      const auto &instruction = function[i];
+      if (isCopy(instruction)) {
+        const auto target = nodeOf(instruction.getTarget());
+        const auto source = nodeOf(instruction.getArg1());
+        live.erase(source);
+        m_nodeMoves[target].push_back(m_moves.size());
+        m_nodeMoves[source].push_back(m_moves.size());
+        m_moveWorklist.push_back(m_moves.size());
+        m_moves.push_back({target, source, MoveState::WORKLIST});
+      }
+      for (size_t j = 0; j < Instruction::kOperands; j++) {
+        if (const auto operand = instruction.getOperand(j); operand.isIdentifierType()) {
+          // Marks the variables that appear in the function
+          m_states[nodeOf(operand)] = State::SIMPLIFY;
+          if (instruction.isDefinition(j)) {
+            live.insert(nodeOf(operand));
+          }
+        }
+      }
+      for (size_t j = 0; j < Instruction::kOperands; j++) {
+        if (const auto operand = instruction.getOperand(j); operand.isIdentifierType() && instruction.isDefinition(j)) {
+          for (const auto other : live) {
+            addEdge(other, nodeOf(operand));
+          }
+        }
+      }
+      for (size_t j = 0; j < Instruction::kOperands; j++) {
+        if (const auto operand = instruction.getOperand(j); operand.isIdentifierType() && instruction.isDefinition(j)) {
+          live.erase(nodeOf(operand));
+        }
+      }
+      for (size_t j = 0; j < Instruction::kOperands; j++) {
+        if (const auto operand = instruction.getOperand(j); operand.isIdentifierType() && instruction.isUse(j)) {
+          live.insert(nodeOf(operand));
+        }
+      }
+    }
+  }
+}
+
+void GraphColoring::addEdge(const uint32_t u, const uint32_t v) {
+  if (u != v && m_edges.insert(uint64_t{std::min(u, v)} << 32 | std::max(u, v)).second) {
+    m_adjacency[u].push_back(v);
+    m_adjacency[v].push_back(u);
+    m_degrees[u]++;
+    m_degrees[v]++;
+  }
+}
+
+bool GraphColoring::hasEdge(const uint32_t u, const uint32_t v) const {
+  return m_edges.contains(uint64_t{std::min(u, v)} << 32 | std::max(u, v));
+}
+
+// Whether the node is still in the graph, rather than set aside to be colored or merged into another
+bool GraphColoring::isInGraph(const uint32_t node) const {
+  return m_states[node] != State::SELECTED && m_states[node] != State::COALESCED;
+}
+
+// The moves that have been coalesced, constrained or frozen stay that way, so they're dropped along
+// the way, and a node merged with many others doesn't go over them again
+bool GraphColoring::isMoveRelated(const uint32_t node) {
+  auto &moves = m_nodeMoves[node];
+  while (!moves.empty() && m_moves[moves.back()].m_state != MoveState::WORKLIST &&
+         m_moves[moves.back()].m_state != MoveState::ACTIVE) {
+    moves.pop_back();
+  }
+  return !moves.empty();
+}
+
+void GraphColoring::setState(const uint32_t node, const State state) {
+  if (m_states[node] == state) {
+    return;
+  }
+  m_states[node] = state;
+  switch (state) {
+    case State::SIMPLIFY:
+      m_simplifyWorklist.push_back(node);
+      break;
+    case State::FREEZE:
+      m_freezeWorklist.push_back(node);
+      break;
+    case State::SPILL:
+      m_spillWorklist.push_back(node);
+      break;
+    default:
+      break;
+  }
+}
+
+void GraphColoring::simplify(const uint32_t node) {
+  setState(node, State::SELECTED);
+  m_selectStack.push_back(node);
+  for (const auto neighbour : m_adjacency[node]) {
+    if (isInGraph(neighbour)) {
+      decrementDegree(neighbour);
+    }
+  }
+}
+
+// A node that's left with fewer neighbours than there are registers can be colored, and the moves of
+// it and of its neighbours may be coalesced now
+void GraphColoring::decrementDegree(const uint32_t node) {
+  if (m_degrees[node]-- != kColors) {
+    return;
+  }
+  enableMoves(node);
+  for (const auto neighbour : m_adjacency[node]) {
+    if (isInGraph(neighbour)) {
+      enableMoves(neighbour);
+    }
+  }
+  if (m_states[node] == State::SPILL) {
+    setState(node, isMoveRelated(node) ? State::FREEZE : State::SIMPLIFY);
+  }
+}
+
+void GraphColoring::enableMoves(const uint32_t node) {
+  for (const auto move : m_nodeMoves[node]) {
+    if (m_moves[move].m_state == MoveState::ACTIVE) {
+      m_moves[move].m_state = MoveState::WORKLIST;
+      m_moveWorklist.push_back(move);
+    }
+  }
+}
+
+void GraphColoring::coalesce(const size_t move) {
+  auto u = getAlias(m_moves[move].m_target);
+  auto v = getAlias(m_moves[move].m_source);
+  // The node with fewer neighbours is the one merged into the other, so that a variable copied to and
+  // from many temporaries isn't merged over and over
+  if (m_adjacency[u].size() < m_adjacency[v].size()) {
+    std::swap(u, v);
+  }
+  // A variable that can't be spilled would make the other one unspillable too
+  const bool unspillable = std::isinf(m_nodes[u].m_cost) || std::isinf(m_nodes[v].m_cost);
+  if (u == v) {
+    m_moves[move].m_state = MoveState::COALESCED;
+    m_coalescedMoves++;
+    addWorklist(u);
+  } else if (hasEdge(u, v) || unspillable) {
+    m_moves[move].m_state = MoveState::CONSTRAINED;
+    addWorklist(u);
+    addWorklist(v);
+  } else if (canCoalesce(u, v)) {
+    m_moves[move].m_state = MoveState::COALESCED;
+    m_coalescedMoves++;
+    combine(u, v);
+    addWorklist(u);
+  } else {
+    m_moves[move].m_state = MoveState::ACTIVE;
+  }
+}
+
+// Merging the nodes is safe if the merged node would have fewer neighbours with many neighbours than
+// there are registers (Briggs), or if each neighbour of one of them with many neighbours is already
+// a neighbour of the other one (George)
+bool GraphColoring::canCoalesce(const uint32_t u, const uint32_t v) {
+  const bool george = std::ranges::all_of(m_adjacency[v], [&](const uint32_t neighbour) {
+    return !isInGraph(neighbour) || m_degrees[neighbour] < kColors || hasEdge(neighbour, u);
+  });
+  if (george) {
+    return true;
+  }
+  uint32_t significant{0};
+  for (const auto neighbour : m_adjacency[u]) {
+    significant += isInGraph(neighbour) && m_degrees[neighbour] >= kColors;
+  }
+  for (const auto neighbour : m_adjacency[v]) {
+    significant += isInGraph(neighbour) && m_degrees[neighbour] >= kColors && !hasEdge(neighbour, u);
+  }
+  return significant < kColors;
+}
+
+void GraphColoring::combine(const uint32_t u, const uint32_t v) {
+  setState(v, State::COALESCED);
+  m_aliases[v] = u;
+  m_nodes[u].m_cost += m_nodes[v].m_cost;
+  if (!m_nodes[u].m_hint) {
+    m_nodes[u].m_hint = m_nodes[v].m_hint;
+  }
+  m_nodeMoves[u].insert(m_nodeMoves[u].end(), m_nodeMoves[v].begin(), m_nodeMoves[v].end());
+  enableMoves(v);
+  for (const auto neighbour : m_adjacency[v]) {
+    if (isInGraph(neighbour)) {
+      addEdge(neighbour, u);
+      decrementDegree(neighbour);
+    }
+  }
+  if (m_degrees[u] >= kColors && m_states[u] == State::FREEZE) {
+    setState(u, State::SPILL);
+  }
+}
+
+void GraphColoring::addWorklist(const uint32_t node) {
+  if (m_states[node] == State::FREEZE && !isMoveRelated(node) && m_degrees[node] < kColors) {
+    setState(node, State::SIMPLIFY);
+  }
+}
+
+// Gives up on coalescing the node's moves, so that it can be set aside
+void GraphColoring::freeze(const uint32_t node) {
+  setState(node, State::SIMPLIFY);
+  freezeMoves(node);
+}
+
+void GraphColoring::freezeMoves(const uint32_t node) {
+  for (const auto move : m_nodeMoves[node]) {
+    auto &[target, source, state] = m_moves[move];
+    if (state != MoveState::WORKLIST && state != MoveState::ACTIVE) {
+      continue;
+    }
+    state = MoveState::FROZEN;
+    const auto other = getAlias(source) == getAlias(node) ? getAlias(target) : getAlias(source);
+    if (m_states[other] == State::FREEZE && !isMoveRelated(other) && m_degrees[other] < kColors) {
+      setState(other, State::SIMPLIFY);
+    }
+  }
+}
+
+// The node that's the cheapest to spill for each neighbour it has
+bool GraphColoring::selectSpill() {
+  std::erase_if(m_spillWorklist, [&](const uint32_t node) { return m_states[node] != State::SPILL; });
+  if (m_spillWorklist.empty()) {
+    return false;
+  }
+  const auto cheapest = std::ranges::min_element(m_spillWorklist, {}, [&](const uint32_t node) {
+    return m_nodes[node].m_cost / m_degrees[node];
+  });
+  const auto node = *cheapest;
+  m_spillWorklist.erase(cheapest);
+  setState(node, State::SIMPLIFY);
+  freezeMoves(node);
+  return true;
+}
+
+// The nodes are colored in the reverse order they were set aside, each with its hint if none of its
+// neighbours has it, or else with the first register none of them has
+void GraphColoring::assignRegisters() {
+  while (!m_selectStack.empty()) {
+    const auto node = m_selectStack.back();
+    m_selectStack.pop_back();
+    RegisterAllocator::RegisterSet taken{};
+    for (const auto neighbour : m_adjacency[node]) {
+      if (const auto alias = getAlias(neighbour); m_states[alias] == State::COLORED) {
+        taken.set(*m_registers[alias]);
+      }
+    }
+    if (const auto hint = m_nodes[node].m_hint; hint && !taken.test(*hint)) {
+      m_registers[node] = *hint;
+    } else if (const auto free = std::ranges::find_if(RegisterAllocator::getAllocatableRegisters,
+                                                      [&](const auto reg) { return !taken.test(reg); });
+               free != RegisterAllocator::getAllocatableRegisters.end()) {
+      m_registers[node] = *free;
+    } else {
+      m_states[node] = State::SPILLED;
+      m_spilled.push_back(node);
+      continue;
+    }
+    m_states[node] = State::COLORED;
+  }
+  for (uint32_t node = 0; node < m_nodes.size(); node++) {
+    if (m_states[node] == State::COALESCED) {
+      m_registers[node] = m_registers[getAlias(node)];
+    }
+  }
+}
+
+// The nodes on the way are pointed straight at the one they were merged into
+uint32_t GraphColoring::getAlias(const uint32_t node) {
+  auto alias = node;
+  while (m_states[alias] == State::COALESCED) {
+    alias = m_aliases[alias];
+  }
+  for (auto next = node; next != alias;) {
+    next = std::exchange(m_aliases[next], alias);
+  }
+  return alias;
+}
@@ -0,0 +1,114 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_GRAPH_COLORING_HPP
+#define WISNIALANG_GRAPH_COLORING_HPP
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <unordered_set>
+#include <vector>
+// Wisnia
+#include "ControlFlowGraph.hpp"
+#include "Instruction.hpp"
+#include "Liveness.hpp"
+#include "Register.hpp"
+
+namespace Wisnia {
+
+// Iterated register coalescing ("Iterated Register Coalescing" by George and Appel). Variables that
+// interfere, i.e. one of them is written while the other is live, are given different registers by
+// coloring the interference graph. A variable with fewer neighbours than there are registers can
+// always be colored, so it's set aside, which may leave its neighbours with fewer of them too. The
+// two variables of a move are merged into one, which removes the move, whenever that can't make the
+// graph harder to color. Once no variable is left with few neighbours, the cheapest one to keep on
+// the stack is set aside anyway, in the hope that its neighbours end up sharing registers
+class GraphColoring {
+ public:
+  struct Node {
+    // What keeping the variable on the stack would cost, infinite for the ones that can't be
+    double m_cost{0};
+    // The fixed register the variable is moved from or into, which it would rather be given
+    std::optional<Basic::register_t> m_hint;
+  };
+
+  // The nodes are indexed by the virtual register counting from the function's first one
+  GraphColoring(std::span<const Instruction> function, const ControlFlowGraph &graph, const Liveness &liveness,
+                std::vector<Node> nodes);
+
+  // Nothing for the spilled variables, and for the ones merged into them
+  std::optional<Basic::register_t> getRegister(const uint32_t node) const { return m_registers[node]; }
+  // The variables that didn't get a register, and have to be moved to the stack. The ones merged into
+  // them stay in registers, and are colored again once the spilled ones have been moved
+  const std::vector<uint32_t> &getSpilled() const { return m_spilled; }
+  size_t getCoalescedMoves() const { return m_coalescedMoves; }
+
+ private:
+  enum class State : uint8_t {
+    ABSENT,
+    SIMPLIFY,
+    FREEZE,
+    SPILL,
+    SELECTED,
+    COALESCED,
+    COLORED,
+    SPILLED
+  };
+
+  enum class MoveState : uint8_t {
+    WORKLIST,
+    ACTIVE,
+    COALESCED,
+    CONSTRAINED,
+    FROZEN
+  };
+
+  struct Move {
+    uint32_t m_target;
+    uint32_t m_source;
+    MoveState m_state;
+  };
+
+  void build(std::span<const Instruction> function, const ControlFlowGraph &graph, const Liveness &liveness);
+  void addEdge(uint32_t u, uint32_t v);
+  bool hasEdge(uint32_t u, uint32_t v) const;
+  bool isInGraph(uint32_t node) const;
+  bool isMoveRelated(uint32_t node);
+  void setState(uint32_t node, State state);
+
+  void simplify(uint32_t node);
+  void decrementDegree(uint32_t node);
+  void enableMoves(uint32_t node);
+  void coalesce(size_t move);
+  bool canCoalesce(uint32_t u, uint32_t v);
+  void combine(uint32_t u, uint32_t v);
+  void addWorklist(uint32_t node);
+  void freeze(uint32_t node);
+  void freezeMoves(uint32_t node);
+  bool selectSpill();
+  void assignRegisters();
+  uint32_t getAlias(uint32_t node);
+
+  std::vector<Node> m_nodes;
+  std::vector<State> m_states;
+  std::vector<uint32_t> m_degrees;
+  std::vector<uint32_t> m_aliases;
+  std::vector<std::vector<uint32_t>> m_adjacency;
+  std::unordered_set<uint64_t> m_edges;
+  std::vector<Move> m_moves;
+  std::vector<std::vector<size_t>> m_nodeMoves;
+
+  // Nodes and moves leave the worklists by changing their state, and are skipped once taken out
+  std::vector<uint32_t> m_simplifyWorklist, m_freezeWorklist, m_spillWorklist;
+  std::vector<size_t> m_moveWorklist;
+  std::vector<uint32_t> m_selectStack;
+
+  std::vector<std::optional<Basic::register_t>> m_registers;
+  std::vector<uint32_t> m_spilled;
+  size_t m_coalescedMoves{0};
+};
+
+}  // namespace Wisnia
+
+#endif  // WISNIALANG_GRAPH_COLORING_HPP
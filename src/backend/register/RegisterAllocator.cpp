@@ -2,134 +2,1122 @@
 // SPDX-License-Identifier: GPL-3.0
 
 #include <optional>
-#include <set>
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <ranges>
+#include <unordered_set>
+#include <utility>
 // Wisnia
+#include "ControlFlowGraph.hpp"
+#include "GraphColoring.hpp"
+#include "Liveness.hpp"
 #include "RegisterAllocator.hpp"
-#include "Instruction.hpp"
-#include "Token.hpp"
+#include "SparseSet.hpp"
 
 using namespace Wisnia;
 using namespace Basic;
 
-using TokenPtr = std::shared_ptr<Token>;
+namespace {
+struct Range {
+  // The instructions [m_from, m_to]
+  size_t m_from, m_to;
+};
 
-template <typename T>
-bool checkVariable(const TokenPtr &token, const T &variable) {
-  using VariableType = std::decay_t<decltype(variable)>;
-  if (!token) return false;
-  return token->isIdentifierType() && token->getValue<VariableType>() == variable;
+struct Variable {
+  // The first and the last instruction that the variable is live at
+  size_t m_start{SIZE_MAX};
+  size_t m_end{0};
+  // The instructions that the variable is live at, in order. The gaps between the ranges are lifetime
+  // holes, e.g. between the last read of a value and the next write, where others may use its register
+  std::vector<Range> m_ranges;
+  // What keeping the variable on the stack would cost: its uses and definitions, each weighed by how
+  // deeply it's nested in loops
+  double m_cost{0};
+  std::optional<Basic::register_t> m_register;
+  // The fixed register the variable is moved from or into, which it would rather be given
+  std::optional<Basic::register_t> m_hint;
+  // The literal that the variable's only definition moves into it. Instead of keeping it on the stack,
+  // it's moved into a register again wherever it's read
+  std::optional<Operand> m_constant;
+};
+
+// A move between a variable and a fixed register, before the registers have been assigned
+bool isFixedRegisterCopy(const Instruction &instruction) {
+  const auto target = instruction.getTarget();
+  const auto arg1 = instruction.getArg1();
+  return instruction.getOperation() == Operation::MOV &&
+         ((target.getType() == TType::REGISTER && arg1.isIdentifierType()) ||
+          (target.isIdentifierType() && arg1.getType() == TType::REGISTER));
+}
+
+// A literal that a register can be set to in a single move
+bool isRematerializable(const Operand &operand) {
+  return operand.isLiteralIntegerType() || operand.getType() == TType::LIT_BOOL ||
+         operand.getType() == TType::KW_TRUE || operand.getType() == TType::KW_FALSE;
+}
+
+// Whether the instruction can read the literal as it is in place of its operand at `index`. A move
+// into a fixed register is left alone, as it's a part of a parallel copy that reads registers only
+bool canFoldLiteral(const Instruction &instruction, const size_t index, const Operand &literal) {
+  switch (instruction.getOperation()) {
+    case Operation::MOV:
+      return index == Instruction::kArgOne && !isFixedRegisterCopy(instruction);
+    case Operation::IADD:
+    case Operation::ISUB:
+    case Operation::IMUL:
+      return index == Instruction::kArgOne && literal.isLiteralIntegerType();
+    case Operation::CMP:
+      return index == Instruction::kArgTwo && literal.getType() != TType::LIT_BOOL;
+    default:
+      return false;
+  }
+}
+
+// Sequentializes moves that happen all at once: a move is made once no other move still needs to
+// read its target. Moves that only wait on each other form cycles, which are broken by keeping one
+// of the values on the stack until the other moves are done
+void emitParallelCopy(std::span<const Instruction> moves, std::vector<Instruction> &output) {
+  struct Move {
+    Basic::register_t m_target;
+    Basic::register_t m_source;
+  };
+  std::vector<Move> pending{};
+  for (const auto &move : moves) {
+    const auto target = move.getTarget().getValue<Basic::register_t>();
+    const auto source = move.getArg1().getValue<Basic::register_t>();
+    // Of the moves into the same register only the last one counts
+    std::erase_if(pending, [&](const Move &other) { return other.m_target == target; });
+    pending.push_back({target, source});
+  }
+
+  // Moves into their own register are left for the instruction optimization to remove
+  for (const auto &move : pending) {
+    if (move.m_target == move.m_source) {
+      output.emplace_back(Operation::MOV, Operand{TType::REGISTER, move.m_target},
+                          Operand{TType::REGISTER, move.m_source});
+    }
+  }
+  std::erase_if(pending, [](const Move &move) { return move.m_target == move.m_source; });
+
+  std::vector<Basic::register_t> stacked{};
+  while (!pending.empty()) {
+    const auto ready = std::ranges::find_if(pending, [&](const Move &move) {
+      return std::ranges::none_of(pending, [&](const Move &other) { return other.m_source == move.m_target; });
+    });
+    if (ready != pending.end()) {
+      output.emplace_back(Operation::MOV, Operand{TType::REGISTER, ready->m_target},
+                          Operand{TType::REGISTER, ready->m_source});
+      pending.erase(ready);
+    } else {
+      output.emplace_back(Operation::PUSH, Operand{}, Operand{TType::REGISTER, pending.front().m_source});
+      stacked.push_back(pending.front().m_target);
+      pending.erase(pending.begin());
+    }
+  }
+  for (const auto reg : std::ranges::reverse_view(stacked)) {
+    output.emplace_back(Operation::POP, Operand{}, Operand{TType::REGISTER, reg});
+  }
+}
+
+using RegisterSet = RegisterAllocator::RegisterSet;
+
+RegisterSet getAllocatableSet() {
+  RegisterSet registers{};
+  for (const auto reg : RegisterAllocator::getAllocatableRegisters) {
+    registers.set(reg);
+  }
+  return registers;
+}
+
+// The 64-bit register that a smaller one is a part of
+Basic::register_t getFullRegister(const Basic::register_t reg) {
+  switch (reg) {
+    case EDX:
+    case DL:
+      return RDX;
+    case ESI:
+      return RSI;
+    default:
+      return reg;
+  }
+}
+
+// The registers a function writes itself
+RegisterSet getWrittenRegisters(std::span<const Instruction> function) {
+  RegisterSet written{};
+  const auto write = [&](const Operand &operand) {
+    if (operand.getType() == TType::REGISTER) {
+      if (const auto reg = operand.getValue<Basic::register_t>(); reg != SPILLED) {
+        written.set(getFullRegister(reg));
+      }
+    }
+  };
+  for (const auto &instruction : function) {
+    const auto target = instruction.getTarget();
+    switch (instruction.getOperation()) {
+      case Operation::MOV:
+        if (target != instruction.getArg1()) {
+          write(target);
+        }
+        break;
+      case Operation::MOV_MEMORY:
+      case Operation::SAVE:
+      case Operation::RESTORE:
+        break;
+      case Operation::POP:
+        write(instruction.getArg1());
+        break;
+      case Operation::IDIV:
+        write(target);
+        written.set(RAX).set(RDX);
+        break;
+      case Operation::SYSCALL:
+        for (const auto reg : RegisterAllocator::getSystemCallClobbers) {
+          written.set(reg);
+        }
+        break;
+      default:
+        write(target);
+        break;
+    }
+  }
+  return written & getAllocatableSet();
+}
+
+// The registers a function pushes when it's entered and pops back before each of its returns, as
+// the runtime's modules do, so that neither it nor the functions it calls overwrite them
+RegisterSet getPreservedRegisters(std::span<const Instruction> function) {
+  RegisterSet preserved{};
+  const auto registerOf = [](const Instruction &instruction) {
+    return getFullRegister(instruction.getArg1().getValue<Basic::register_t>());
+  };
+  size_t entry = !function.empty() && function.front().getOperation() == Operation::LABEL;
+  for (; entry < function.size() && function[entry].getOperation() == Operation::PUSH &&
+         function[entry].getArg1().getType() == TType::REGISTER; entry++) {
+    preserved.set(registerOf(function[entry]));
+  }
+  bool returns{false};
+  for (size_t i = 0; i < function.size(); i++) {
+    if (function[i].getOperation() != Operation::RET) {
+      continue;
+    }
+    returns = true;
+    RegisterSet popped{};
+    for (size_t j = i; j-- > 0 && function[j].getOperation() == Operation::POP &&
+                       function[j].getArg1().getType() == TType::REGISTER;) {
+      popped.set(registerOf(function[j]));
+    }
+    preserved &= popped;
+  }
+  return returns ? preserved : RegisterSet{};
+}
+
+// A loop is closed by a jump back to its start, so an instruction is nested in as many loops as
+// there are jumps back over it
+std::vector<int> getLoopDepths(const ControlFlowGraph &graph, const size_t size) {
+  std::vector<int> depths(size + 1, 0);
+  for (ControlFlowGraph::Index block = 0; block < graph.getBlocks().size(); block++) {
+    for (const auto successor : graph.getBlock(block).m_successors) {
+      if (successor <= block) {
+        depths[graph.getBlock(successor).m_begin]++;
+        depths[graph.getBlock(block).m_end]--;
+      }
+    }
+  }
+  std::partial_sum(depths.begin(), depths.end(), depths.begin());
+  return depths;
+}
+
+// Each loop that an instruction is nested in makes it run about ten times as often
+double getWeight(const int depth) {
+  double weight{1};
+  for (int i = 0; i < std::min(depth, 6); i++) {
+    weight *= 10;
+  }
+  return weight;
+}
+
+// The variables of a function, indexed by the virtual register counting from the function's first one.
+// Found in a single backward pass over the blocks: a variable that's live when leaving a block must
+// keep its register from the start of the block, or from where it's written in the block, until the
+// end of it, even if it isn't used there. That's the case for a variable carried around a loop by a
+// back edge, whose next read comes earlier in the function than the jump back. Until the pass is
+// over, the ranges of each variable are in reverse order
+std::vector<Variable> getVariables(std::span<const Instruction> function, const ControlFlowGraph &graph,
+                                   const Liveness &liveness) {
+  std::vector<Variable> variables(liveness.getEndVariable() - liveness.getFirstVariable());
+  const auto variable = [&](const VirtualRegister reg) -> Variable & {
+    return variables[static_cast<uint32_t>(reg) - liveness.getFirstVariable()];
+  };
+  // Merged with the earliest range found so far if they meet
+  const auto addRange = [](Variable &var, const size_t from, const size_t to) {
+    if (!var.m_ranges.empty() && var.m_ranges.back().m_from <= to + 1) {
+      var.m_ranges.back().m_from = std::min(var.m_ranges.back().m_from, from);
+      var.m_ranges.back().m_to = std::max(var.m_ranges.back().m_to, to);
+    } else {
+      var.m_ranges.push_back({from, to});
+    }
+  };
+  // A write starts the range that the reads after it are in, or is a range of its own if nothing
+  // reads the value
+  const auto define = [](Variable &var, const size_t at) {
+    if (!var.m_ranges.empty() && var.m_ranges.back().m_from <= at) {
+      var.m_ranges.back().m_from = at;
+    } else {
+      var.m_ranges.push_back({at, at});
+    }
+  };
+
+  const auto depths = getLoopDepths(graph, function.size());
+  std::vector<uint32_t> definitions(variables.size(), 0);
+  // The variable that each one is copied from where it's defined
+  std::vector<std::optional<VirtualRegister>> copies(variables.size());
+  for (auto block = graph.getBlocks().size(); block-- > 0;) {
+    const auto begin = graph.getBlock(block).m_begin;
+    const auto end = graph.getBlock(block).m_end;
+    liveness.forEachLiveOut(block, [&](const VirtualRegister reg) {
+      addRange(variable(reg), begin, end - 1);
+    });
+    for (size_t i = end; i-- > begin;) {
+      const auto weight = getWeight(depths[i]);
+      for (size_t j = 0; j < Instruction::kOperands; j++) {
+        if (const auto operand = function[i].getOperand(j); operand.isIdentifierType()) {
+          auto &var = variable(operand.getVirtualRegister());
+          var.m_cost += weight;
+          if (function[i].isDefinition(j)) {
+            define(var, i);
+            const auto index = static_cast<uint32_t>(operand.getVirtualRegister()) - liveness.getFirstVariable();
+            definitions[index]++;
+            if (const auto source = function[i].getArg1(); function[i].getOperation() == Operation::MOV) {
+              if (isRematerializable(source)) {
+                var.m_constant = source;
+              } else if (source.isIdentifierType()) {
+                copies[index] = source.getVirtualRegister();
+              }
+            }
+          }
+        }
+      }
+      for (size_t j = 0; j < Instruction::kOperands; j++) {
+        if (const auto operand = function[i].getOperand(j); operand.isIdentifierType() && function[i].isUse(j)) {
+          addRange(variable(operand.getVirtualRegister()), begin, i);
+        }
+      }
+      // The first move between the variable and a fixed register is the one that's kept. A variable
+      // that's still needed after it's copied into one isn't steered there, as whatever the register
+      // is given to is likely to overwrite it
+      if (isFixedRegisterCopy(function[i])) {
+        const auto target = function[i].getTarget();
+        const auto arg1 = function[i].getArg1();
+        auto &var = variable(target.isIdentifierType() ? target.getVirtualRegister() : arg1.getVirtualRegister());
+        if (target.isIdentifierType() || var.m_ranges.back().m_to == i) {
+          var.m_hint = (target.isIdentifierType() ? arg1 : target).getValue<Basic::register_t>();
+        }
+      }
+    }
+  }
+  // A copy of a constant is a constant too, e.g. a variable declared with a literal, which is moved
+  // into a temporary first. Keeping a constant out of a register drops its definition, and costs a
+  // move at each read that can't take the literal as it is
+  for (uint32_t index = 0; index < variables.size(); index++) {
+    if (definitions[index] != 1) {
+      variables[index].m_constant.reset();
+      copies[index].reset();
+    }
+  }
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (uint32_t index = 0; index < variables.size(); index++) {
+      if (auto &var = variables[index]; !var.m_constant && copies[index]) {
+        if (const auto &source = variable(*copies[index]); source.m_constant) {
+          var.m_constant = source.m_constant;
+          changed = true;
+        }
+      }
+    }
+  }
+  for (auto &var : variables) {
+    if (var.m_constant) {
+      var.m_cost = 0;
+    }
+  }
+  for (size_t i = 0; i < function.size(); i++) {
+    for (size_t j = 0; j < Instruction::kOperands; j++) {
+      if (const auto operand = function[i].getOperand(j); operand.isIdentifierType() && function[i].isUse(j)) {
+        if (auto &var = variable(operand.getVirtualRegister());
+            var.m_constant && !canFoldLiteral(function[i], j, *var.m_constant)) {
+          var.m_cost += getWeight(depths[i]);
+        }
+      }
+    }
+  }
+  for (auto &var : variables) {
+    if (!var.m_ranges.empty()) {
+      std::ranges::reverse(var.m_ranges);
+      var.m_start = var.m_ranges.front().m_from;
+      var.m_end = var.m_ranges.back().m_to;
+    }
+  }
+  return variables;
+}
+
+// The blocks around `start` that the variable is live through without being used, in order. It can
+// stay on the stack through them instead of in a register, by storing it on each edge into them and
+// loading it on each edge out of them to where it's still needed. Nothing if it's used in `start`,
+// or if the function would have to enter them with it on the stack
+std::vector<ControlFlowGraph::Index> getUnusedRegion(const ControlFlowGraph &graph, const Liveness &liveness,
+                                                     const VirtualRegister reg, const ControlFlowGraph::Index start,
+                                                     std::span<const ControlFlowGraph::Index> used) {
+  const auto isUnused = [&](const ControlFlowGraph::Index block) {
+    return block != ControlFlowGraph::kEntry && liveness.isLiveIn(block, reg) && !std::ranges::binary_search(used, block);
+  };
+  if (!isUnused(start)) {
+    return {};
+  }
+  std::vector<ControlFlowGraph::Index> region{start};
+  std::unordered_set<ControlFlowGraph::Index> visited{start};
+  const auto visit = [&](const std::vector<ControlFlowGraph::Index> &neighbours) {
+    for (const auto neighbour : neighbours) {
+      if (isUnused(neighbour) && visited.insert(neighbour).second) {
+        region.push_back(neighbour);
+      }
+    }
+  };
+  for (size_t i = 0; i < region.size(); i++) {
+    visit(graph.getBlock(region[i]).m_predecessors);
+    visit(graph.getBlock(region[i]).m_successors);
+  }
+  std::ranges::sort(region);
+  return region;
+}
+
+// Puts instructions on the edges between the blocks, so that they only run when control goes that
+// way: at the end of the source if it's the only way out of it, at the start of the target if it's
+// the only way into it, or after a conditional jump if it's the way through. Otherwise the jump is
+// redirected to a block of its own, which goes after the whole function, labelled with the help of
+// `labelCount`. Loads and stores leave the flags alone, so they can go right before a conditional
+// jump too
+std::vector<Instruction> insertOnEdges(
+    std::span<const Instruction> function, const ControlFlowGraph &graph,
+    const std::map<std::pair<ControlFlowGraph::Index, ControlFlowGraph::Index>, std::vector<Instruction>> &insertions,
+    size_t &labelCount) {
+  const auto find = [&](const ControlFlowGraph::Index from,
+                        const ControlFlowGraph::Index to) -> const std::vector<Instruction> * {
+    const auto it = insertions.find({from, to});
+    return it != insertions.end() ? &it->second : nullptr;
+  };
+
+  std::vector<Instruction> output{};
+  std::vector<Instruction> splitBlocks{};
+  const auto &blocks = graph.getBlocks();
+  for (ControlFlowGraph::Index block = 0; block < blocks.size(); block++) {
+    const auto &[begin, end, predecessors, successors] = blocks[block];
+    auto first = begin;
+    if (predecessors.size() == 1 && blocks[predecessors.front()].m_successors.size() == 2 &&
+        blocks[predecessors.front()].m_successors.front() == block) {
+      if (const auto *instructions = find(predecessors.front(), block)) {
+        if (function[first].getOperation() == Operation::LABEL) {
+          output.push_back(function[first++]);
+        }
+        output.insert(output.end(), instructions->begin(), instructions->end());
+      }
+    }
+
+    const bool jumps = first < end && function[end - 1].isJump();
+    output.insert(output.end(), function.begin() + static_cast<std::ptrdiff_t>(first),
+                  function.begin() + static_cast<std::ptrdiff_t>(end - jumps));
+    if (successors.size() == 1) {
+      if (const auto *instructions = find(block, successors.front())) {
+        output.insert(output.end(), instructions->begin(), instructions->end());
+      }
+    }
+    if (jumps) {
+      auto last = function[end - 1];
+      if (successors.size() == 2 && blocks[successors.front()].m_predecessors.size() > 1) {
+        if (const auto *instructions = find(block, successors.front())) {
+          const Operand label{TType::IDENT_VOID, ".L" + std::to_string(++labelCount) + "_split"};
+          splitBlocks.emplace_back(Operation::LABEL, Operand{}, label);
+          splitBlocks.insert(splitBlocks.end(), instructions->begin(), instructions->end());
+          splitBlocks.emplace_back(Operation::JMP, Operand{}, last.getArg1());
+          last = Instruction{last.getOperation(), Operand{}, label};
+        }
+      }
+      output.push_back(last);
+    }
+    if (successors.size() == 2) {
+      if (const auto *instructions = find(block, successors.back())) {
+        output.insert(output.end(), instructions->begin(), instructions->end());
+      }
+    }
+  }
+  output.insert(output.end(), splitBlocks.begin(), splitBlocks.end());
+  return output;
 }
+}  // namespace
 
 // Linear Scan algorithm (default for LLVM)
 // https://pages.cs.wisc.edu/~horwitz/CS701-NOTES/5.REGISTER-ALLOCATION.html#linearScan
-void RegisterAllocator::allocate(InstructionList &&instructions, const bool allocateRegisters) {
+// or graph coloring with `Algorithm::GRAPH_COLORING`, see `GraphColoring`
+void RegisterAllocator::allocate(const std::span<const Instruction> instructions, const bool allocateRegisters) {
   if (!allocateRegisters) {
+    // The calls are lowered once it's known what each function overwrites
+    m_functions.push_back({m_instructions.size(), std::vector<Lowering>(instructions.size())});
     m_instructions.insert(m_instructions.end(), instructions.begin(), instructions.end());
     return;
   }
 
-  // List of live intervals
-  const auto intervalComparison = [](const auto &a, const auto &b) { return a.m_start < b.m_start; };
-  std::set<Live, decltype(intervalComparison)> liveIntervals{};
-
-  // Populate the list with each variable's starting and ending interval points
-  for (size_t i = 0; i < instructions.size(); i++) {
-    std::string var{};
-    const auto &target = instructions[i]->getTarget();
-    const auto &argOne = instructions[i]->getArg1();
-    const auto &argTwo = instructions[i]->getArg2();
-
-    if (target) {
-      if (target->getType() == TType::REGISTER) continue;
-      var = target->getValue<std::string>();
-    } else if (argOne) {
-      if (argOne->getType() == TType::REGISTER) continue;
-      var = argOne->getValue<std::string>();
-    } else if (argTwo) {
-      if (argTwo->getType() == TType::REGISTER) continue;
-      var = argTwo->getValue<std::string>();
+  // The temporaries that load and store the spilled variables are created from here on, and are
+  // never spilled themselves
+  const auto firstSpillTemporary = static_cast<uint32_t>(m_virtualRegisters.size());
+  InstructionList function{instructions.begin(), instructions.end()};
+  int frameSize{0};
+  // The stack slots of the variables that have been split or spilled, and the variables split so far
+  std::unordered_map<VirtualRegister, int> slots{};
+  std::unordered_set<VirtualRegister> splitVariables{};
+  for (;;) {
+    const ControlFlowGraph graph{function};
+    const Liveness liveness{graph, function};
+    auto variables = getVariables(function, graph, liveness);
+    const auto getVariable = [&](const uint32_t index) {
+      return static_cast<VirtualRegister>(liveness.getFirstVariable() + index);
+    };
+    // Spilling a variable with a long interval frees its register for longer
+    const auto getSpillWeight = [&](const uint32_t index) {
+      const auto &var = variables[index];
+      return static_cast<uint32_t>(getVariable(index)) >= firstSpillTemporary
+        ? std::numeric_limits<double>::infinity()
+        : var.m_cost / static_cast<double>(var.m_end - var.m_start + 1);
+    };
+
+    std::vector<VirtualRegister> spilled{};
+    if (m_algorithm == Algorithm::GRAPH_COLORING) {
+      std::vector<GraphColoring::Node> nodes(variables.size());
+      for (uint32_t index = 0; index < variables.size(); index++) {
+        const bool spillTemporary = static_cast<uint32_t>(getVariable(index)) >= firstSpillTemporary;
+        nodes[index] = {spillTemporary ? std::numeric_limits<double>::infinity() : variables[index].m_cost,
+                        variables[index].m_hint};
+      }
+      const GraphColoring coloring{function, graph, liveness, std::move(nodes)};
+      for (const auto index : coloring.getSpilled()) {
+        if (std::isinf(getSpillWeight(index))) {
+          throw InstructionError{"Ran out of registers for the spilled variables"};
+        }
+        spilled.push_back(getVariable(index));
+      }
+      for (uint32_t index = 0; index < variables.size(); index++) {
+        variables[index].m_register = coloring.getRegister(index);
+      }
     } else {
+      // List of live intervals, ordered by their starting points
+      std::vector<uint32_t> liveIntervals{};
+      for (uint32_t index = 0; index < variables.size(); index++) {
+        if (variables[index].m_start != SIZE_MAX) {
+          liveIntervals.push_back(index);
+        }
+      }
+      std::ranges::stable_sort(liveIntervals, {}, [&](const uint32_t index) { return variables[index].m_start; });
+
+      // List of available registers
+      Registers availableRegisters{};
+
+      // List of the intervals that have been given a register and overlap with the current interval,
+      // and of the ones that are in a lifetime hole there, which lend their register out until their
+      // next range starts. Each interval's ranges before the current interval are skipped for good
+      std::vector<uint32_t> activeIntervals{};
+      std::vector<uint32_t> inactiveIntervals{};
+      std::vector<size_t> nextRanges(variables.size(), 0);
+      const auto intersects = [&](const uint32_t other, const Variable &interval) {
+        const auto &ranges = variables[other].m_ranges;
+        for (size_t i = nextRanges[other], j = 0; i < ranges.size() && j < interval.m_ranges.size();) {
+          const auto [from, to] = ranges[i];
+          const auto [start, end] = interval.m_ranges[j];
+          if ((from < end && start < to) || from == start) {
+            return true;
+          }
+          to <= end ? i++ : j++;
+        }
+        return false;
+      };
+
+      // The intervals that were spilled, and where they ran out of registers
+      std::vector<std::pair<uint32_t, size_t>> evicted{};
+
+      // Process each interval in the list in order
+      for (const auto index : liveIntervals) {
+        auto &interval = variables[index];
+        const auto position = interval.m_start;
+
+        // Remove all expired intervals, and move the ones that enter or leave a hole
+        const auto skipRanges = [&](const uint32_t other) {
+          const auto &ranges = variables[other].m_ranges;
+          auto &next = nextRanges[other];
+          while (next < ranges.size() && ranges[next].m_to <= position) {
+            next++;
+          }
+          return next < ranges.size() ? std::optional{ranges[next].m_from <= position} : std::nullopt;
+        };
+        std::erase_if(activeIntervals, [&](const auto active) {
+          const auto covers = skipRanges(active);
+          if (covers && !*covers) {
+            inactiveIntervals.push_back(active);
+          }
+          return !covers || !*covers;
+        });
+        std::erase_if(inactiveIntervals, [&](const auto inactive) {
+          const auto covers = skipRanges(inactive);
+          if (covers && *covers) {
+            activeIntervals.push_back(inactive);
+          }
+          return !covers || *covers;
+        });
+
+        RegisterSet lent{};
+        for (const auto inactive : inactiveIntervals) {
+          if (intersects(inactive, interval)) {
+            lent.set(*variables[inactive].m_register);
+          }
+        }
+        for (auto &state : availableRegisters.m_registers) {
+          state.m_assigned = lent.test(state.m_register);
+        }
+        for (const auto active : activeIntervals) {
+          availableRegisters[*variables[active].m_register].m_assigned = true;
+        }
+
+        // Search for an unassigned register, trying the variable's hint first
+        const auto availableRegister = [&]() -> std::optional<Basic::register_t> {
+          auto it = std::find_if(availableRegisters.m_registers.begin(), availableRegisters.m_registers.end(),
+            [&](const Registers::RegisterState r) { return !r.m_assigned && r.m_register == interval.m_hint; }
+          );
+          if (it == availableRegisters.m_registers.end()) {
+            it = std::find_if(availableRegisters.m_registers.begin(), availableRegisters.m_registers.end(),
+              [](const Registers::RegisterState r) { return !r.m_assigned; }
+            );
+          }
+          if (it != availableRegisters.m_registers.end()) {
+            it->m_assigned = true;
+            return it->m_register;
+          }
+          return {};
+        };
+
+        if (const auto &reg = availableRegister(); reg.has_value()) {
+          // Allocate the register to the current interval
+          // and add the current interval to the active list
+          interval.m_register = reg.value();
+          activeIntervals.push_back(index);
+          continue;
+        }
+
+        // We ran out of registers - spill the interval that's the cheapest to keep on the stack,
+        // which may be the current one or one that has already been given a register. The register
+        // of an interval is only freed if no interval in a hole needs it later on
+        const auto cheapest = std::ranges::min_element(activeIntervals, [&](const auto lhs, const auto rhs) {
+          const bool lhsLent = lent.test(*variables[lhs].m_register);
+          const bool rhsLent = lent.test(*variables[rhs].m_register);
+          return lhsLent != rhsLent ? rhsLent : getSpillWeight(lhs) < getSpillWeight(rhs);
+        });
+        if (cheapest != activeIntervals.end() && !lent.test(*variables[*cheapest].m_register) &&
+            getSpillWeight(*cheapest) < getSpillWeight(index)) {
+          interval.m_register = std::exchange(variables[*cheapest].m_register, std::nullopt);
+          evicted.emplace_back(*cheapest, position);
+          *cheapest = index;
+        } else if (std::isinf(getSpillWeight(index))) {
+          throw InstructionError{"Ran out of registers for the spilled variables"};
+        } else {
+          evicted.emplace_back(index, position);
+        }
+      }
+
+      // A variable that isn't used in the blocks around where it ran out of registers only moves to
+      // the stack through them, if storing it when entering them and loading it when leaving them
+      // costs less than loading it at each use. Each variable is split like that once at most, so
+      // that it can't go on forever, and the variables left over are spilled once no more of them
+      // can be split, since a split may well have made room for them
+      if (!evicted.empty()) {
+        const auto &blocks = graph.getBlocks();
+        // The blocks each variable is used in, in order, and an operand to load and store it with
+        std::vector<std::vector<ControlFlowGraph::Index>> used(variables.size());
+        std::vector<Operand> operands(variables.size());
+        for (ControlFlowGraph::Index block = 0; block < blocks.size(); block++) {
+          for (size_t i = blocks[block].m_begin; i < blocks[block].m_end; i++) {
+            for (size_t j = 0; j < Instruction::kOperands; j++) {
+              if (const auto operand = function[i].getOperand(j); operand.isIdentifierType()) {
+                const auto index = static_cast<uint32_t>(operand.getVirtualRegister()) - liveness.getFirstVariable();
+                if (used[index].empty() || used[index].back() != block) {
+                  used[index].push_back(block);
+                }
+                operands[index] = operand;
+              }
+            }
+          }
+        }
+        const auto depths = getLoopDepths(graph, function.size());
+        const auto getEdgeWeight = [&](const ControlFlowGraph::Index from, const ControlFlowGraph::Index to) {
+          return getWeight(std::min(depths[blocks[from].m_begin], depths[blocks[to].m_begin]));
+        };
+
+        std::map<std::pair<ControlFlowGraph::Index, ControlFlowGraph::Index>, InstructionList> insertions{};
+        for (const auto &[index, position] : evicted) {
+          const auto variable = getVariable(index);
+          const auto block = static_cast<ControlFlowGraph::Index>(
+            std::ranges::upper_bound(blocks, position, {}, &ControlFlowGraph::BasicBlock::m_begin) - blocks.begin() - 1);
+          // A constant costs no more to move into a register again than to load
+          const auto region = splitVariables.contains(variable) || variables[index].m_constant
+            ? std::vector<ControlFlowGraph::Index>{}
+            : getUnusedRegion(graph, liveness, variable, block, used[index]);
+          const auto inRegion = [&](const ControlFlowGraph::Index other) {
+            return std::ranges::binary_search(region, other);
+          };
+
+          std::vector<std::pair<ControlFlowGraph::Index, ControlFlowGraph::Index>> entries{}, exits{};
+          double cost{0};
+          for (const auto inside : region) {
+            for (const auto predecessor : blocks[inside].m_predecessors) {
+              if (!inRegion(predecessor)) {
+                entries.emplace_back(predecessor, inside);
+                cost += getEdgeWeight(predecessor, inside);
+              }
+            }
+            for (const auto successor : blocks[inside].m_successors) {
+              if (!inRegion(successor) && liveness.isLiveIn(successor, variable)) {
+                exits.emplace_back(inside, successor);
+                cost += getEdgeWeight(inside, successor);
+              }
+            }
+          }
+          if (region.empty() || cost >= variables[index].m_cost) {
+            spilled.push_back(variable);
+            continue;
+          }
+
+          splitVariables.insert(variable);
+          if (!slots.contains(variable)) {
+            frameSize += 8;
+            slots.emplace(variable, -frameSize);
+          }
+          const Operand offset{TType::LIT_INT, slots.at(variable)};
+          for (const auto &edge : entries) {
+            insertions[edge].emplace_back(Operation::STORE, offset, operands[index]);
+          }
+          for (const auto &edge : exits) {
+            insertions[edge].emplace_back(Operation::LOAD, operands[index], offset);
+          }
+        }
+        if (!insertions.empty()) {
+          function = insertOnEdges(function, graph, insertions, m_labelCount);
+          continue;
+        }
+      }
+    }
+
+    if (!spilled.empty()) {
+      // The spilled variables are moved to the stack, and the registers are assigned anew
+      std::unordered_map<VirtualRegister, Operand> constants{};
+      for (const auto variable : spilled) {
+        const auto index = static_cast<uint32_t>(variable) - liveness.getFirstVariable();
+        if (const auto &constant = variables[index].m_constant; constant) {
+          constants.emplace(variable, *constant);
+        }
+      }
+      spill(function, spilled, constants, slots, frameSize);
       continue;
     }
 
-    const size_t start = i;
-    size_t end = i;
+    // The calls are lowered once it's known what each function overwrites
+    auto &lowering = m_functions.emplace_back(Function{m_instructions.size(), {}, frameSize}).m_lowering;
+    lowering.resize(function.size());
+    for (size_t i = 0; i < function.size(); i++) {
+      lowering[i].m_parallelCopy = isFixedRegisterCopy(function[i]);
+    }
+    if (liveness.hasVariables()) {
+      // The registers of the variables that are still needed after a call are saved around it, if
+      // the called function overwrites them. Walking each block backwards from the variables live
+      // when leaving it gives the variables live after each call, and the RESTOREs met on the way
+      // are matched with their SAVEs by how they nest
+      SparseSet live{variables.size()};
+      const auto insert = [&](const VirtualRegister reg) {
+        live.insert(static_cast<uint32_t>(reg) - liveness.getFirstVariable());
+      };
+      const auto erase = [&](const VirtualRegister reg) {
+        live.erase(static_cast<uint32_t>(reg) - liveness.getFirstVariable());
+      };
+      for (ControlFlowGraph::Index block = 0; block < graph.getBlocks().size(); block++) {
+        live.clear();
+        liveness.forEachLiveOut(block, insert);
 
-    for (size_t j = i + 1; j < instructions.size(); j++) {
-      if (checkVariable(instructions[j]->getTarget(), var) ||
-          checkVariable(instructions[j]->getArg1(), var) ||
-          checkVariable(instructions[j]->getArg2(), var)) {
-        end = j;
+        struct Pending {
+          size_t m_restore;
+          bool m_called;
+        };
+        std::vector<Pending> pending{};
+        for (size_t i = graph.getBlock(block).m_end; i-- > graph.getBlock(block).m_begin;) {
+          const auto &instruction = function[i];
+          switch (instruction.getOperation()) {
+            case Operation::RESTORE:
+              pending.push_back({i, false});
+              break;
+            case Operation::CALL:
+            case Operation::SYSCALL:
+              if (!pending.empty() && !pending.back().m_called) {
+                pending.back().m_called = true;
+                lowering[pending.back().m_restore].m_call = i;
+                auto &registers = lowering[pending.back().m_restore].m_saved;
+                for (const auto index : live) {
+                  if (const auto &reg = variables[index].m_register; reg) {
+                    registers.set(*reg);
+                  }
+                }
+              }
+              break;
+            case Operation::SAVE:
+              if (pending.empty()) {
+                throw InstructionError{"Unmatched save of the registers"};
+              }
+              lowering[i] = lowering[pending.back().m_restore];
+              pending.pop_back();
+              break;
+            default:
+              break;
+          }
+          for (size_t j = 0; j < Instruction::kOperands; j++) {
+            if (const auto operand = instruction.getOperand(j); operand.isIdentifierType() &&
+                                                                instruction.isDefinition(j) && !instruction.isUse(j)) {
+              erase(operand.getVirtualRegister());
+            }
+          }
+          for (size_t j = 0; j < Instruction::kOperands; j++) {
+            if (const auto operand = instruction.getOperand(j); operand.isIdentifierType() && instruction.isUse(j)) {
+              insert(operand.getVirtualRegister());
+            }
+          }
+        }
       }
     }
 
-    liveIntervals.emplace(Live{.m_variable = var, .m_start = start, .m_end = end});
+    // Assign registers to instructions
+    for (auto &instruction : function) {
+      for (size_t i = 0; i < Instruction::kOperands; i++) {
+        if (const auto operand = instruction.getOperand(i); operand.isIdentifierType()) {
+          const auto index = static_cast<uint32_t>(operand.getVirtualRegister()) - liveness.getFirstVariable();
+          instruction.setOperand(i, Operand{TType::REGISTER, *variables[index].m_register});
+        }
+      }
+    }
+    m_instructions.insert(m_instructions.end(), function.begin(), function.end());
+    return;
   }
+}
 
-  // List of available registers
-  Registers availableRegisters{};
-
-  // List of the intervals that have been given a register and overlap with the current interval
-  const auto overlapComparison = [](const auto &a, const auto &b) { return a.m_start > b.m_start; };
-  std::set<Live, decltype(overlapComparison)> activeIntervals{};
+// Spilled variables live in the stack frame of the function: each instruction that uses one loads
+// it into a new temporary first, and each that defines one stores the temporary afterwards. The
+// moves of a parallel copy happen all at once, so their loads and stores surround the whole copy.
+// A variable that has been split before keeps its slot, and the loads and stores of the split are
+// dropped, since the slot always holds its value now
+void RegisterAllocator::spill(InstructionList &function, const std::span<const VirtualRegister> spilled,
+                              const std::unordered_map<VirtualRegister, Operand> &constants,
+                              std::unordered_map<VirtualRegister, int> &allSlots, int &frameSize) {
+  std::unordered_map<VirtualRegister, int> slots{};
+  for (const auto variable : spilled) {
+    if (constants.contains(variable)) {
+      continue;
+    }
+    if (!allSlots.contains(variable)) {
+      frameSize += 8;
+      allSlots.emplace(variable, -frameSize);
+    }
+    slots.emplace(variable, allSlots.at(variable));
+  }
+  const auto isSplit = [&](const Instruction &instruction) {
+    const auto &[variable, offset] = instruction.getOperation() == Operation::STORE
+      ? std::pair{instruction.getArg1(), instruction.getTarget()}
+      : std::pair{instruction.getTarget(), instruction.getArg1()};
+    if (!variable.isIdentifierType()) {
+      return false;
+    }
+    const auto slot = slots.find(variable.getVirtualRegister());
+    return slot != slots.end() && offset == Operand{TType::LIT_INT, slot->second};
+  };
+  const auto isConstant = [&](const Instruction &instruction) {
+    const auto target = instruction.getTarget();
+    return instruction.getOperation() == Operation::MOV && target.isIdentifierType() &&
+           constants.contains(target.getVirtualRegister());
+  };
+  std::erase_if(function, [&](const Instruction &instruction) {
+    return ((instruction.getOperation() == Operation::STORE || instruction.getOperation() == Operation::LOAD) &&
+            isSplit(instruction)) || isConstant(instruction);
+  });
+  // Constants that nothing reads anymore are dropped too, e.g. the literals that the dropped
+  // definitions were copied from
+  std::unordered_set<VirtualRegister> read{};
+  for (const auto &instruction : function) {
+    for (size_t j = 0; j < Instruction::kOperands; j++) {
+      if (const auto operand = instruction.getOperand(j); operand.isIdentifierType() && instruction.isUse(j)) {
+        read.insert(operand.getVirtualRegister());
+      }
+    }
+  }
+  std::erase_if(function, [&](const Instruction &instruction) {
+    const auto target = instruction.getTarget();
+    return instruction.getOperation() == Operation::MOV && target.isIdentifierType() &&
+           isRematerializable(instruction.getArg1()) && !read.contains(target.getVirtualRegister());
+  });
 
-  // Process each interval in the list in order
-  for (const auto &interval : liveIntervals) {
-    // Remove all expired intervals
-    std::erase_if(activeIntervals, [&](const auto &active) {
-      if (active.m_end <= interval.m_start) {
-        auto &r = availableRegisters[active.m_register];
-        r.m_assigned = false;
-        return true;
+  InstructionList output{};
+  output.reserve(function.size() + 2 * spilled.size());
+  // The temporary of each spilled variable in the instructions at hand, and whether it has been loaded
+  std::unordered_map<VirtualRegister, std::pair<Operand, bool>> temporaries{};
+  InstructionList stores{};
+  for (size_t i = 0; i < function.size();) {
+    size_t end = i + 1;
+    if (isFixedRegisterCopy(function[i])) {
+      while (end < function.size() && isFixedRegisterCopy(function[end])) {
+        end++;
       }
-      return false;
-    });
+    }
+    temporaries.clear();
+    stores.clear();
+    const auto begin = output.size();
+    for (; i < end; i++) {
+      auto instruction = function[i];
+      for (size_t j = 0; j < Instruction::kOperands; j++) {
+        const auto operand = instruction.getOperand(j);
+        if (!operand.isIdentifierType()) {
+          continue;
+        }
+        const auto constant = constants.find(operand.getVirtualRegister());
+        if (constant != constants.end() && canFoldLiteral(instruction, j, constant->second)) {
+          instruction.setOperand(j, constant->second);
+          continue;
+        }
+        const auto slot = slots.find(operand.getVirtualRegister());
+        if (slot == slots.end() && constant == constants.end()) {
+          continue;
+        }
+        auto [temporary, created] = temporaries.try_emplace(operand.getVirtualRegister());
+        auto &[reg, loaded] = temporary->second;
+        if (created) {
+          reg = Operand{operand.getType(), m_virtualRegisters.createTemporary()};
+        }
+        // The target of a copy comes before its source, e.g. when a variable is copied into itself
+        if (instruction.isUse(j) && !loaded) {
+          loaded = true;
+          output.emplace(output.begin() + static_cast<std::ptrdiff_t>(begin),
+                         constant != constants.end() ? Instruction{Operation::MOV, reg, constant->second}
+                                                     : Instruction{Operation::LOAD, reg, Operand{TType::LIT_INT,
+                                                                                                 slot->second}});
+        }
+        if (instruction.isDefinition(j)) {
+          stores.emplace_back(Operation::STORE, Operand{TType::LIT_INT, slot->second}, reg);
+        }
+        instruction.setOperand(j, reg);
+      }
+      output.push_back(instruction);
+    }
+    output.insert(output.end(), stores.begin(), stores.end());
+  }
+  function = std::move(output);
+}
+
+// Each function's registers were assigned on their own, so the registers it overwrites are found
+// bottom-up over the call graph: a function overwrites the registers it writes itself, and those
+// overwritten by the functions it calls. Recursive functions depend on their own sets, which start
+// out empty and grow until none of them changes
+void RegisterAllocator::lowerCalls() {
+  const auto functionCount = m_functions.size();
+  const auto getFunction = [&](const size_t index) {
+    const auto end = index + 1 < functionCount ? m_functions[index + 1].m_begin : m_instructions.size();
+    return std::span<const Instruction>{m_instructions}.subspan(m_functions[index].m_begin,
+                                                                end - m_functions[index].m_begin);
+  };
 
-    // Search for an unassigned register
-    const auto availableRegister = [&]() -> std::optional<Basic::register_t> {
-      auto it = std::find_if(availableRegisters.m_registers.begin(), availableRegisters.m_registers.end(),
-        [](const Registers::RegisterState r) { return !r.m_assigned; }
-      );
-      if (it != availableRegisters.m_registers.end()) {
-        it->m_assigned = true;
-        return it->m_register;
+  // Functions are called by the label they start with, which the main function doesn't have
+  std::unordered_map<std::string, size_t> labels{};
+  for (size_t index = 0; index < functionCount; index++) {
+    if (const auto function = getFunction(index);
+        !function.empty() && function.front().getOperation() == Operation::LABEL) {
+      labels.emplace(function.front().getArg1().getValue<std::string>(), index);
+    }
+  }
+  const auto getCallee = [&](const Instruction &call) -> std::optional<size_t> {
+    const auto it = labels.find(call.getTarget().getValue<std::string>());
+    return it != labels.end() ? std::optional{it->second} : std::nullopt;
+  };
+
+  std::vector<RegisterSet> clobbers(functionCount), kept(functionCount);
+  std::vector<std::vector<size_t>> callees(functionCount);
+  for (size_t index = 0; index < functionCount; index++) {
+    const auto function = getFunction(index);
+    clobbers[index] = getWrittenRegisters(function);
+    kept[index] = ~getPreservedRegisters(function);
+    for (const auto &instruction : function) {
+      if (instruction.getOperation() != Operation::CALL) {
+        continue;
       }
-      return {};
-    };
+      if (const auto callee = getCallee(instruction); callee) {
+        callees[index].push_back(*callee);
+      } else {
+        // Nothing is known about it, so it may overwrite any register
+        clobbers[index] |= getAllocatableSet();
+      }
+    }
+    clobbers[index] &= kept[index];
+  }
 
-    if (const auto &reg = availableRegister(); reg.has_value()) {
-      // Allocate the register to the current interval
-      // and add the current interval to the active list
-      auto node = liveIntervals.extract(interval);
-      node.value().m_register = reg.value();
-      liveIntervals.insert(std::move(node));
-      activeIntervals.insert(interval);
-    } else {
-      // We ran out of registers - spill it
-      auto node = liveIntervals.extract(interval);
-      node.value().m_register = SPILLED;
-      liveIntervals.insert(std::move(node));
+  // Visiting the callees before their callers settles the functions without recursion in a single
+  // sweep; a recursive cycle takes another sweep for each time its sets grow
+  std::vector<size_t> postorder{};
+  std::vector<bool> visited(functionCount, false);
+  for (size_t root = 0; root < functionCount; root++) {
+    if (visited[root]) {
+      continue;
+    }
+    visited[root] = true;
+    std::vector<std::pair<size_t, size_t>> stack{{root, 0}};
+    while (!stack.empty()) {
+      auto &[index, next] = stack.back();
+      if (next < callees[index].size()) {
+        if (const auto callee = callees[index][next++]; !visited[callee]) {
+          visited[callee] = true;
+          stack.emplace_back(callee, 0);
+        }
+        continue;
+      }
+      postorder.push_back(index);
+      stack.pop_back();
+    }
+  }
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (const auto index : postorder) {
+      for (const auto callee : callees[index]) {
+        if (const auto merged = (clobbers[index] | clobbers[callee]) & kept[index]; merged != clobbers[index]) {
+          clobbers[index] = merged;
+          changed = true;
+        }
+      }
     }
   }
 
-  // Assign registers to instructions
-  for (const auto &instr : instructions) {
-    for (const auto &[liveVar, liveReg, ignored1, ignored2] : liveIntervals) {
-      if (const auto &var = instr->getTarget(); var && checkVariable(var, liveVar)) {
-        var->setType(TType::REGISTER);
-        var->setValue(liveReg);
+  // Only the live registers that the called function overwrites need saving, along with the ones
+  // that the arguments are moved into before the call
+  InstructionList instructions{};
+  instructions.reserve(m_instructions.size());
+  for (size_t index = 0; index < functionCount; index++) {
+    const auto function = getFunction(index);
+    auto &lowering = m_functions[index].m_lowering;
+    // Indexed by the position of the call, as each SAVE comes before its RESTORE
+    std::vector<RegisterSet> overwritten(function.size());
+    for (size_t i = 0; i < function.size(); i++) {
+      if (!lowering[i].m_saved.any()) {
+        continue;
+      }
+      const auto call = lowering[i].m_call;
+      if (function[i].getOperation() == Operation::SAVE) {
+        // A system call overwrites only the registers it's known to, which the span includes
+        overwritten[call] = getWrittenRegisters(function.subspan(i + 1, call - i));
+        if (function[call].getOperation() == Operation::CALL) {
+          const auto callee = getCallee(function[call]);
+          overwritten[call] |= callee ? clobbers[*callee] : getAllocatableSet();
+        }
       }
-      if (const auto &var = instr->getArg1(); var && checkVariable(var, liveVar)) {
-        var->setType(TType::REGISTER);
-        var->setValue(liveReg);
+      if (function[i].getOperation() == Operation::SAVE || function[i].getOperation() == Operation::RESTORE) {
+        lowering[i].m_saved &= overwritten[call];
       }
-      if (const auto &var = instr->getArg2(); var && checkVariable(var, liveVar)) {
-        var->setType(TType::REGISTER);
-        var->setValue(liveReg);
+    }
+    lower(function, m_functions[index], instructions);
+  }
+  for (const auto &[label, index] : labels) {
+    m_clobbers[label] = clobbers[index];
+  }
+  m_instructions = std::move(instructions);
+  m_functions.clear();
+}
+
+void RegisterAllocator::lower(const std::span<const Instruction> function, const Function &layout,
+                              InstructionList &output) {
+  const auto &lowering = layout.m_lowering;
+  const auto begin = output.size();
+  const Operand stackPointer{TType::REGISTER, RSP};
+  const Operand frameSize{TType::LIT_INT, layout.m_frameSize};
+  constexpr auto registers = getAllocatableRegisters;
+  for (size_t i = 0; i < function.size(); i++) {
+    if (layout.m_frameSize > 0 && i == (function.front().getOperation() == Operation::LABEL ? 1 : 0)) {
+      output.emplace_back(Operation::ISUB, stackPointer, frameSize);
+    }
+    if (lowering[i].m_parallelCopy) {
+      size_t end = i + 1;
+      while (end < function.size() && lowering[end].m_parallelCopy) {
+        end++;
       }
+      emitParallelCopy(function.subspan(i, end - i), output);
+      i = end - 1;
+      continue;
+    }
+    switch (function[i].getOperation()) {
+      case Operation::SAVE:
+        for (const auto reg : registers) {
+          if (lowering[i].m_saved.test(reg)) {
+            output.emplace_back(Operation::PUSH, Operand{}, Operand{TType::REGISTER, reg});
+          }
+        }
+        break;
+      case Operation::RESTORE:
+        for (const auto reg : std::ranges::reverse_view(registers)) {
+          if (lowering[i].m_saved.test(reg)) {
+            output.emplace_back(Operation::POP, Operand{}, Operand{TType::REGISTER, reg});
+          }
+        }
+        break;
+      case Operation::RET:
+        if (layout.m_frameSize > 0) {
+          output.emplace_back(Operation::IADD, stackPointer, frameSize);
+        }
+        output.push_back(function[i]);
+        break;
+      default:
+        output.push_back(function[i]);
+        break;
     }
   }
 
-  m_instructions.insert(m_instructions.end(), instructions.begin(), instructions.end());
+  // Pushes and pops are balanced within each block, so following them in order gives how far below
+  // its value on entry the stack pointer is at each instruction. Every block other than the entry
+  // starts with just the frame set up, even if it's laid out after a return, like the blocks split
+  // off the edges are
+  int depth{0};
+  for (auto &instruction : std::span{output}.subspan(begin)) {
+    const auto target = instruction.getTarget();
+    const auto arg1 = instruction.getArg1();
+    switch (instruction.getOperation()) {
+      case Operation::LABEL:
+        if (&instruction != &output[begin]) {
+          depth = layout.m_frameSize;
+        }
+        break;
+      case Operation::PUSH:
+        depth += 8;
+        break;
+      case Operation::POP:
+        depth -= 8;
+        break;
+      case Operation::ISUB:
+      case Operation::IADD:
+        if (target == stackPointer && arg1.isLiteralIntegerType()) {
+          depth += instruction.getOperation() == Operation::ISUB ? arg1.getValue<int>() : -arg1.getValue<int>();
+        }
+        break;
+      case Operation::LOAD:
+        instruction.setOperand(Instruction::kArgOne, Operand{TType::LIT_INT, arg1.getValue<int>() + depth});
+        break;
+      case Operation::STORE:
+        instruction.setOperand(Instruction::kTarget, Operand{TType::LIT_INT, target.getValue<int>() + depth});
+        break;
+      default:
+        break;
+    }
+  }
 }
@@ -6,16 +6,28 @@
 
 #include <algorithm>
 #include <array>
-#include <memory>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
 // Wisnia
 #include "IRPrintHelper.hpp"
+#include "Instruction.hpp"
 #include "Register.hpp"
 
 namespace Wisnia {
-class Instruction;
 
 class RegisterAllocator {
-  using InstructionList = std::vector<std::shared_ptr<Instruction>>;
+ public:
+  // Indexed by `Basic::register_t`
+  using RegisterSet = std::bitset<16>;
+
+ private:
+  using InstructionList = std::vector<Instruction>;
 
   struct Registers {
     struct RegisterState {
@@ -48,16 +60,53 @@ class RegisterAllocator {
     }};
   };
 
-  struct Live {
-    std::string m_variable;
-    Basic::register_t m_register;
-    size_t m_start, m_end;
+  // How an instruction of a function is lowered once its registers have been assigned
+  struct Lowering {
+    // The registers that a SAVE pushes and its RESTORE pops: the ones of the variables live across
+    // the call, until it's known which of them the called function overwrites
+    RegisterSet m_saved{};
+    // Where the call that a SAVE and its RESTORE surround is
+    size_t m_call{0};
+    // Consecutive moves between a variable and a fixed register, e.g. the arguments of a call,
+    // happen all at once, and are reordered so that none overwrites a register another one reads
+    bool m_parallelCopy{false};
+  };
+
+  struct Function {
+    // Where the function starts in `m_instructions`
+    size_t m_begin;
+    std::vector<Lowering> m_lowering;
+    // The bytes of the stack that the function's spilled variables take
+    int m_frameSize{0};
   };
 
  public:
+  enum class Algorithm : uint8_t {
+    // Fast, and good enough for straight-line code
+    LINEAR_SCAN,
+    // Slower, but removes most of the moves between variables by giving them the same register
+    GRAPH_COLORING
+  };
+
+  // The temporaries that load and store spilled variables are created along with the rest of them
+  explicit RegisterAllocator(VirtualRegisters &virtualRegisters, const Algorithm algorithm = Algorithm::LINEAR_SCAN)
+      : m_virtualRegisters{virtualRegisters}, m_algorithm{algorithm} {}
+
   const InstructionList &getInstructions() const { return m_instructions; }
   void print(std::ostream &output) const { IRPrintHelper::print(output, m_instructions); }
-  void allocate(InstructionList &&instructions, bool allocateRegisters = true);
+  void allocate(std::span<const Instruction> instructions, bool allocateRegisters = true);
+
+  // Once all the functions have been allocated, finds the registers each of them overwrites,
+  // including through the functions it calls, and saves only those of them that are live across
+  // each call
+  void lowerCalls();
+
+  // The registers a function overwrites, known once the calls have been lowered. Unknown functions
+  // may overwrite any register
+  RegisterSet getClobberedRegisters(const std::string &function) const {
+    const auto it = m_clobbers.find(function);
+    return it != m_clobbers.end() ? it->second : RegisterSet{}.set();
+  }
 
   // All the allocatable registers excluding `RSP`
   static constexpr std::array<Basic::register_t, 15> getAllocatableRegisters {
@@ -78,11 +127,45 @@ class RegisterAllocator {
     Basic::register_t::R15,
   };
 
+  // The registers that pass the first arguments of a function call, in order. The rest of the
+  // arguments are passed on the stack
+  static constexpr std::array<Basic::register_t, 6> getArgumentRegisters {
+    Basic::register_t::RDI, Basic::register_t::RSI, Basic::register_t::RDX,
+    Basic::register_t::RCX, Basic::register_t::R8,  Basic::register_t::R9,
+  };
+
+  // The register that passes the return value of a function
+  static constexpr Basic::register_t getReturnRegister {Basic::register_t::RAX};
+
+  // The registers that a system call overwrites besides the ones it's given
+  static constexpr std::array<Basic::register_t, 3> getSystemCallClobbers {
+    Basic::register_t::RAX, Basic::register_t::RCX, Basic::register_t::R11,
+  };
+
   static constexpr auto getFullRegisters() { return getAllRegisters.size(); }
   static constexpr auto getHalfRegisters() { return getAllRegisters.size() / 2; }
 
  private:
+  // Moves the variables to their stack slots in `slots`, giving the ones without a slot yet a new
+  // one below the others. The ones in `constants` are rematerialized instead: their definitions are
+  // dropped, and their literals are read in their place, or moved into a register right before
+  void spill(InstructionList &function, std::span<const VirtualRegister> spilled,
+             const std::unordered_map<VirtualRegister, Operand> &constants,
+             std::unordered_map<VirtualRegister, int> &slots, int &frameSize);
+
+  // Appends the function to `output`, with each SAVE and RESTORE turned into pushes and pops, and
+  // each parallel copy into a sequence of moves. The function's stack frame is set up when it's
+  // entered and torn down before each return, and the offsets of the stack slots are counted from
+  // the stack pointer at the instruction instead of on entry
+  static void lower(std::span<const Instruction> function, const Function &layout, InstructionList &output);
+
+  VirtualRegisters &m_virtualRegisters;
+  Algorithm m_algorithm;
   InstructionList m_instructions;
+  std::vector<Function> m_functions;
+  std::unordered_map<std::string, RegisterSet> m_clobbers;
+  // Numbers the blocks that the loads and stores of split variables are put in
+  size_t m_labelCount{0};
 };
 
 }  // namespace Wisnia
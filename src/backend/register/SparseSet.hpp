@@ -0,0 +1,53 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_SPARSE_SET_HPP
+#define WISNIALANG_SPARSE_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Wisnia {
+
+// A set of the variables of a function, numbered from zero, e.g. the ones live at an instruction.
+// Clearing the set and visiting its members take time proportional to how many of them there are,
+// not to how many variables the function has ("An Efficient Representation for Sparse Sets" by
+// Briggs and Torczon)
+class SparseSet {
+ public:
+  explicit SparseSet(const size_t size) : m_positions(size) {}
+
+  bool contains(const uint32_t value) const {
+    const auto position = m_positions[value];
+    return position < m_members.size() && m_members[position] == value;
+  }
+
+  void insert(const uint32_t value) {
+    if (!contains(value)) {
+      m_positions[value] = static_cast<uint32_t>(m_members.size());
+      m_members.push_back(value);
+    }
+  }
+
+  void erase(const uint32_t value) {
+    if (contains(value)) {
+      const auto position = m_positions[value];
+      m_members[position] = m_members.back();
+      m_positions[m_members[position]] = position;
+      m_members.pop_back();
+    }
+  }
+
+  void clear() { m_members.clear(); }
+  auto begin() const { return m_members.begin(); }
+  auto end() const { return m_members.end(); }
+
+ private:
+  std::vector<uint32_t> m_positions;
+  std::vector<uint32_t> m_members;
+};
+
+}  // namespace Wisnia
+
+#endif  // WISNIALANG_SPARSE_SET_HPP
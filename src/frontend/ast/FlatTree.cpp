@@ -0,0 +1,252 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+// Wisnia
+#include "FlatTree.hpp"
+#include "Visitor.hpp"
+
+using namespace Wisnia;
+using namespace AST;
+
+// Fills in the slot of every node it visits. A node gets the slots of all its children reserved
+// at once, so that they end up next to each other, and only then are the children visited
+class FlatTree::Builder final : public Visitor {
+ public:
+  explicit Builder(FlatTree &tree) : m_tree{tree} {}
+
+  void build(Root &root) {
+    // The nodes in the arena are about as many as the tree will have, only the types are left out
+    if (const NodeArena *arena = NodeArena::current()) {
+      const size_t expected = arena->getAllocations();
+      m_tree.m_kinds.reserve(expected);
+      m_tree.m_tokenIndices.reserve(expected);
+      m_tree.m_firstChildren.reserve(expected);
+      m_tree.m_childCounts.reserve(expected);
+      m_tree.m_tokens.reserve(expected);
+      m_tree.m_nodes.reserve(expected);
+    }
+    reserve(1);
+    m_tree.m_nodes[kRoot] = &root;
+    root.accept(*this);
+  }
+
+ private:
+  template <typename T>
+  static uint32_t count(const std::unique_ptr<T> &child) {
+    return child ? 1 : 0;
+  }
+
+  template <typename T>
+  static uint32_t count(const std::vector<std::unique_ptr<T>> &children) {
+    return static_cast<uint32_t>(children.size());
+  }
+
+  NodeId reserve(const uint32_t count) {
+    const auto first = static_cast<NodeId>(m_tree.m_kinds.size());
+    const size_t size = first + count;
+    m_tree.m_kinds.resize(size);
+    m_tree.m_tokenIndices.resize(size);
+    m_tree.m_firstChildren.resize(size);
+    m_tree.m_childCounts.resize(size);
+    m_tree.m_nodes.resize(size);
+    return first;
+  }
+
+  template <typename T>
+  void assign(NodeId &slot, const std::unique_ptr<T> &child) {
+    if (child) {
+      m_tree.m_nodes[slot++] = child.get();
+    }
+  }
+
+  template <typename T>
+  void assign(NodeId &slot, const std::vector<std::unique_ptr<T>> &children) {
+    for (const auto &child : children) {
+      m_tree.m_nodes[slot++] = child.get();
+    }
+  }
+
+  template <typename T, typename... Children>
+  void place(T &node, const Children &...children) {
+    const NodeId id = m_slot;
+    m_tree.m_kinds[id] = kNodeKind<T>;
+    if (const auto &token = node.getToken()) {
+      m_tree.m_tokenIndices[id] = static_cast<uint32_t>(m_tree.m_tokens.size());
+      m_tree.m_tokens.push_back(token.get());
+    } else {
+      m_tree.m_tokenIndices[id] = kNoToken;
+    }
+
+    const uint32_t childCount = (0 + ... + count(children));
+    const NodeId first = reserve(childCount);
+    m_tree.m_firstChildren[id] = first;
+    m_tree.m_childCounts[id] = childCount;
+
+    // Only read by the fold, which is empty for the nodes without children
+    [[maybe_unused]] NodeId slot = first;
+    (assign(slot, children), ...);
+    for (NodeId child = first; child < first + childCount; ++child) {
+      m_slot = child;
+      m_tree.m_nodes[child]->accept(*this);
+    }
+  }
+
+  void visit(Root &node) override {
+    place(node, node.getGlobalClasses(), node.getGlobalFunctions());
+  }
+
+  void visit(PrimitiveType &node) override {
+    place(node);
+  }
+
+  void visit(VarExpr &node) override {
+    place(node);
+  }
+
+  void visit(BooleanExpr &node) override {
+    place(node, node.lhs(), node.rhs());
+  }
+
+  void visit(EqExpr &node) override {
+    place(node, node.lhs(), node.rhs());
+  }
+
+  void visit(CompExpr &node) override {
+    place(node, node.lhs(), node.rhs());
+  }
+
+  void visit(AddExpr &node) override {
+    place(node, node.lhs(), node.rhs());
+  }
+
+  void visit(SubExpr &node) override {
+    place(node, node.lhs(), node.rhs());
+  }
+
+  void visit(MultExpr &node) override {
+    place(node, node.lhs(), node.rhs());
+  }
+
+  void visit(DivExpr &node) override {
+    place(node, node.lhs(), node.rhs());
+  }
+
+  void visit(UnaryExpr &node) override {
+    place(node, node.lhs());
+  }
+
+  void visit(FnCallExpr &node) override {
+    place(node, node.getVariable(), node.getArguments());
+  }
+
+  void visit(ClassInitExpr &node) override {
+    place(node, node.getVariable(), node.getArguments());
+  }
+
+  void visit(IntExpr &node) override {
+    place(node);
+  }
+
+  void visit(FloatExpr &node) override {
+    place(node);
+  }
+
+  void visit(BoolExpr &node) override {
+    place(node);
+  }
+
+  void visit(StringExpr &node) override {
+    place(node);
+  }
+
+  void visit(StmtBlock &node) override {
+    place(node, node.getStatements());
+  }
+
+  void visit(ReturnStmt &node) override {
+    place(node, node.getReturnValue());
+  }
+
+  void visit(BreakStmt &node) override {
+    place(node);
+  }
+
+  void visit(ContinueStmt &node) override {
+    place(node);
+  }
+
+  void visit(VarDeclStmt &node) override {
+    place(node, node.getVariable(), node.getValue());
+  }
+
+  void visit(VarAssignStmt &node) override {
+    place(node, node.getVariable(), node.getValue());
+  }
+
+  void visit(ExprStmt &node) override {
+    place(node, node.getExpression());
+  }
+
+  void visit(ReadStmt &node) override {
+    place(node, node.getVariableList());
+  }
+
+  void visit(WriteStmt &node) override {
+    place(node, node.getExpressions());
+  }
+
+  void visit(Param &node) override {
+    place(node, node.getVariable());
+  }
+
+  void visit(FnDef &node) override {
+    place(node, node.getVariable(), node.getParameters(), node.getBody());
+  }
+
+  void visit(CtorDef &node) override {
+    place(node);
+  }
+
+  void visit(DtorDef &node) override {
+    place(node);
+  }
+
+  void visit(Field &node) override {
+    place(node, node.getVariable(), node.getValue());
+  }
+
+  void visit(ClassDef &node) override {
+    place(node, node.getVariable(), node.getFields(), node.getConstructor(), node.getDestructor(), node.getMethods());
+  }
+
+  void visit(WhileLoop &node) override {
+    place(node, node.getCondition(), node.getBody());
+  }
+
+  void visit(ForLoop &node) override {
+    place(node, node.getInitial(), node.getCondition(), node.getIncrement(), node.getBody());
+  }
+
+  void visit(ForEachLoop &node) override {
+    place(node, node.getElement(), node.getCollection(), node.getBody());
+  }
+
+  void visit(IfStmt &node) override {
+    place(node, node.getCondition(), node.getBody(), node.getElseStatements());
+  }
+
+  void visit(ElseStmt &node) override {
+    place(node, node.getBody());
+  }
+
+  void visit(ElseIfStmt &node) override {
+    place(node, node.getCondition(), node.getBody());
+  }
+
+  FlatTree &m_tree;
+  NodeId m_slot{kRoot};
+};
+
+FlatTree::FlatTree(Root &root) {
+  Builder{*this}.build(root);
+}
@@ -0,0 +1,190 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_AST_FLAT_TREE_HPP
+#define WISNIALANG_AST_FLAT_TREE_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <vector>
+// Wisnia
+#include "AST.hpp"
+
+namespace Wisnia {
+namespace AST {
+
+// One for each of the node types the visitor knows of, in the same order
+enum class NodeKind : uint8_t {
+  ROOT,
+  PRIMITIVE_TYPE,
+  VAR_EXPR,
+  BOOLEAN_EXPR,
+  EQ_EXPR,
+  COMP_EXPR,
+  ADD_EXPR,
+  SUB_EXPR,
+  MULT_EXPR,
+  DIV_EXPR,
+  UNARY_EXPR,
+  FN_CALL_EXPR,
+  CLASS_INIT_EXPR,
+  INT_EXPR,
+  FLOAT_EXPR,
+  BOOL_EXPR,
+  STRING_EXPR,
+  STMT_BLOCK,
+  RETURN_STMT,
+  BREAK_STMT,
+  CONTINUE_STMT,
+  VAR_DECL_STMT,
+  VAR_ASSIGN_STMT,
+  EXPR_STMT,
+  READ_STMT,
+  WRITE_STMT,
+  PARAM,
+  FN_DEF,
+  CTOR_DEF,
+  DTOR_DEF,
+  FIELD,
+  CLASS_DEF,
+  WHILE_LOOP,
+  FOR_LOOP,
+  FOR_EACH_LOOP,
+  IF_STMT,
+  ELSE_STMT,
+  ELSE_IF_STMT
+};
+
+template <typename T>
+constexpr NodeKind kNodeKind = NodeKind::ROOT;
+template <> inline constexpr NodeKind kNodeKind<PrimitiveType> = NodeKind::PRIMITIVE_TYPE;
+template <> inline constexpr NodeKind kNodeKind<VarExpr> = NodeKind::VAR_EXPR;
+template <> inline constexpr NodeKind kNodeKind<BooleanExpr> = NodeKind::BOOLEAN_EXPR;
+template <> inline constexpr NodeKind kNodeKind<EqExpr> = NodeKind::EQ_EXPR;
+template <> inline constexpr NodeKind kNodeKind<CompExpr> = NodeKind::COMP_EXPR;
+template <> inline constexpr NodeKind kNodeKind<AddExpr> = NodeKind::ADD_EXPR;
+template <> inline constexpr NodeKind kNodeKind<SubExpr> = NodeKind::SUB_EXPR;
+template <> inline constexpr NodeKind kNodeKind<MultExpr> = NodeKind::MULT_EXPR;
+template <> inline constexpr NodeKind kNodeKind<DivExpr> = NodeKind::DIV_EXPR;
+template <> inline constexpr NodeKind kNodeKind<UnaryExpr> = NodeKind::UNARY_EXPR;
+template <> inline constexpr NodeKind kNodeKind<FnCallExpr> = NodeKind::FN_CALL_EXPR;
+template <> inline constexpr NodeKind kNodeKind<ClassInitExpr> = NodeKind::CLASS_INIT_EXPR;
+template <> inline constexpr NodeKind kNodeKind<IntExpr> = NodeKind::INT_EXPR;
+template <> inline constexpr NodeKind kNodeKind<FloatExpr> = NodeKind::FLOAT_EXPR;
+template <> inline constexpr NodeKind kNodeKind<BoolExpr> = NodeKind::BOOL_EXPR;
+template <> inline constexpr NodeKind kNodeKind<StringExpr> = NodeKind::STRING_EXPR;
+template <> inline constexpr NodeKind kNodeKind<StmtBlock> = NodeKind::STMT_BLOCK;
+template <> inline constexpr NodeKind kNodeKind<ReturnStmt> = NodeKind::RETURN_STMT;
+template <> inline constexpr NodeKind kNodeKind<BreakStmt> = NodeKind::BREAK_STMT;
+template <> inline constexpr NodeKind kNodeKind<ContinueStmt> = NodeKind::CONTINUE_STMT;
+template <> inline constexpr NodeKind kNodeKind<VarDeclStmt> = NodeKind::VAR_DECL_STMT;
+template <> inline constexpr NodeKind kNodeKind<VarAssignStmt> = NodeKind::VAR_ASSIGN_STMT;
+template <> inline constexpr NodeKind kNodeKind<ExprStmt> = NodeKind::EXPR_STMT;
+template <> inline constexpr NodeKind kNodeKind<ReadStmt> = NodeKind::READ_STMT;
+template <> inline constexpr NodeKind kNodeKind<WriteStmt> = NodeKind::WRITE_STMT;
+template <> inline constexpr NodeKind kNodeKind<Param> = NodeKind::PARAM;
+template <> inline constexpr NodeKind kNodeKind<FnDef> = NodeKind::FN_DEF;
+template <> inline constexpr NodeKind kNodeKind<CtorDef> = NodeKind::CTOR_DEF;
+template <> inline constexpr NodeKind kNodeKind<DtorDef> = NodeKind::DTOR_DEF;
+template <> inline constexpr NodeKind kNodeKind<Field> = NodeKind::FIELD;
+template <> inline constexpr NodeKind kNodeKind<ClassDef> = NodeKind::CLASS_DEF;
+template <> inline constexpr NodeKind kNodeKind<WhileLoop> = NodeKind::WHILE_LOOP;
+template <> inline constexpr NodeKind kNodeKind<ForLoop> = NodeKind::FOR_LOOP;
+template <> inline constexpr NodeKind kNodeKind<ForEachLoop> = NodeKind::FOR_EACH_LOOP;
+template <> inline constexpr NodeKind kNodeKind<IfStmt> = NodeKind::IF_STMT;
+template <> inline constexpr NodeKind kNodeKind<ElseStmt> = NodeKind::ELSE_STMT;
+template <> inline constexpr NodeKind kNodeKind<ElseIfStmt> = NodeKind::ELSE_IF_STMT;
+
+// The tree in struct-of-arrays form: every node is an index into columns holding its kind, its
+// token and the range of its children, which are always laid out next to each other. Children
+// come in the order the visitors walk them, leaving out the nodes they skip (types, and the
+// insides of constructors and destructors)
+//
+// Passes only reading the tree walk the dense columns and never touch the nodes. The nodes are
+// still reachable through `node()`, for the passes that have to write into them
+//
+// No compilation pass runs over it yet; benchmarks/flat-ast compares walking it against walking
+// the nodes. The tree is built from the parsed nodes and leaves them in place
+class FlatTree {
+ public:
+  using NodeId = uint32_t;
+  static constexpr NodeId kRoot{0};
+  static constexpr uint32_t kNoToken{std::numeric_limits<uint32_t>::max()};
+
+  explicit FlatTree(Root &root);
+
+  size_t size() const {
+    return m_kinds.size();
+  }
+
+  NodeKind kind(const NodeId id) const {
+    return m_kinds[id];
+  }
+
+  // Returns nullptr for the nodes without a token, e.g. the root or statement blocks
+  Basic::Token *token(const NodeId id) const {
+    return m_tokenIndices[id] == kNoToken ? nullptr : m_tokens[m_tokenIndices[id]];
+  }
+
+  auto children(const NodeId id) const {
+    return std::views::iota(m_firstChildren[id], m_firstChildren[id] + m_childCounts[id]);
+  }
+
+  NodeId child(const NodeId id, const uint32_t nth) const {
+    assert(nth < m_childCounts[id] && "No such child");
+    return m_firstChildren[id] + nth;
+  }
+
+  uint32_t childCount(const NodeId id) const {
+    return m_childCounts[id];
+  }
+
+  template <typename T>
+  T &node(const NodeId id) const {
+    assert(m_kinds[id] == kNodeKind<T> && "Node is of a different kind");
+    return static_cast<T &>(*m_nodes[id]);
+  }
+
+  // Calls `fn` on the nodes under `from` (itself included) in the order the visitors would
+  template <typename Fn>
+  void walk(Fn &&fn, const NodeId from = kRoot) const {
+    std::vector<NodeId> pending{from};
+    while (!pending.empty()) {
+      const NodeId id = pending.back();
+      pending.pop_back();
+      fn(id);
+      for (NodeId next = m_firstChildren[id] + m_childCounts[id]; next-- > m_firstChildren[id];) {
+        pending.push_back(next);
+      }
+    }
+  }
+
+  // Gathers the nodes of type T like NodeCollector does
+  template <typename T>
+  std::vector<const T *> collect() const {
+    std::vector<const T *> nodes{};
+    walk([&](const NodeId id) {
+      if (m_kinds[id] == kNodeKind<T>) {
+        nodes.push_back(&node<T>(id));
+      }
+    });
+    return nodes;
+  }
+
+ private:
+  class Builder;
+
+  std::vector<NodeKind> m_kinds;
+  std::vector<uint32_t> m_tokenIndices;
+  std::vector<NodeId> m_firstChildren;
+  std::vector<uint32_t> m_childCounts;
+  std::vector<Basic::Token *> m_tokens;
+  std::vector<Root *> m_nodes;
+};
+
+}  // namespace AST
+}  // namespace Wisnia
+
+#endif  // WISNIALANG_AST_FLAT_TREE_HPP
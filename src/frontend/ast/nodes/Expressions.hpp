@@ -68,7 +68,13 @@ class VarExpr final : public BaseExpr {
   }
 
   void addType(TypePtr type) {
-    m_type = std::move(type);
+    m_ownedType = std::move(type);
+    shareType(m_ownedType.get());
+  }
+
+  // Refers to the type owned by another node, e.g. by the variable's declaration
+  void shareType(const BaseType *type) {
+    m_type = type;
     Basic::TType tokenType;
 
     switch (m_type->getType()) {
@@ -93,12 +99,13 @@ class VarExpr final : public BaseExpr {
     m_token->setType(tokenType);
   }
 
-  const TypePtr &getType() const {
+  const BaseType *getType() const {
     return m_type;
   }
 
  private:
-  TypePtr m_type;
+  TypePtr m_ownedType;
+  const BaseType *m_type{nullptr};
 };
 
 class BinaryExpr : public BaseExpr {
@@ -0,0 +1,110 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_AST_NODE_ARENA_HPP
+#define WISNIALANG_AST_NODE_ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Wisnia {
+namespace AST {
+
+// Bump allocator for the AST nodes of a single compilation. The nodes are still destroyed by
+// their owners as usual, but their memory is given back all at once, when the arena goes away,
+// so the arena has to outlive the tree. Nodes created while no arena is in scope on the thread
+// are allocated on the heap
+class NodeArena {
+  // Precedes every node, telling where its memory came from
+  struct alignas(std::max_align_t) Header {
+    bool m_inArena;
+  };
+
+ public:
+  // Makes the nodes created on the current thread go into `arena` for as long as it lasts
+  class Scope {
+   public:
+    explicit Scope(NodeArena &arena) : m_previous{std::exchange(inScope(), &arena)} {}
+    ~Scope() { inScope() = m_previous; }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+   private:
+    NodeArena *m_previous;
+  };
+
+  // Returns the arena in scope on the current thread, if any
+  static NodeArena *current() { return inScope(); }
+
+  NodeArena() = default;
+  NodeArena(NodeArena &&) = default;
+  NodeArena &operator=(NodeArena &&) = default;
+
+  static void *allocateNode(const size_t size) {
+    NodeArena *arena = current();
+    void *memory = arena ? arena->allocate(sizeof(Header) + size) : ::operator new(sizeof(Header) + size);
+    return new (memory) Header{arena != nullptr} + 1;
+  }
+
+  static void deallocateNode(void *node) noexcept {
+    if (auto *header = static_cast<Header *>(node) - 1; !header->m_inArena) {
+      ::operator delete(header);
+    }
+  }
+
+  // Takes over the memory of another arena, e.g. the one a worker thread has built nodes in
+  void adopt(NodeArena &&other) {
+    for (auto &block : other.m_blocks) {
+      m_blocks.push_back(std::move(block));
+    }
+    m_allocations += other.m_allocations;
+    m_bytes += other.m_bytes;
+    other = NodeArena{};
+  }
+
+  size_t getAllocations() const { return m_allocations; }
+  size_t getBytes() const { return m_bytes; }
+  size_t getBlocks() const { return m_blocks.size(); }
+
+ private:
+  static constexpr size_t kBlockSize{64 * 1024};
+  static constexpr size_t kAlignment{alignof(std::max_align_t)};
+
+  static NodeArena *&inScope() {
+    thread_local NodeArena *arena{nullptr};
+    return arena;
+  }
+
+  void *allocate(size_t size) {
+    size = (size + kAlignment - 1) & ~(kAlignment - 1);
+    if (size > m_left) {
+      // Nodes that don't fit into a block get one of their own
+      const size_t blockSize = std::max(size, kBlockSize);
+      m_blocks.push_back(std::make_unique_for_overwrite<std::byte[]>(blockSize));
+      m_next = m_blocks.back().get();
+      m_left = blockSize;
+    }
+    void *memory = m_next;
+    m_next += size;
+    m_left -= size;
+    ++m_allocations;
+    m_bytes += size;
+    return memory;
+  }
+
+  std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+  std::byte *m_next{nullptr};
+  size_t m_left{0};
+  size_t m_allocations{0};
+  size_t m_bytes{0};
+};
+
+}  // namespace AST
+}  // namespace Wisnia
+
+#endif  // WISNIALANG_AST_NODE_ARENA_HPP
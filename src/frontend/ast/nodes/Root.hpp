@@ -4,10 +4,13 @@
 #ifndef WISNIALANG_AST_ROOT_HPP
 #define WISNIALANG_AST_ROOT_HPP
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <utility>
 #include <vector>
 // Wisnia
+#include "NodeArena.hpp"
 #include "Visitor.hpp"
 
 namespace Wisnia {
@@ -31,6 +34,10 @@ class Root : public IVisitable {
   Root() = default;
   virtual ~Root() = default;
 
+  // Nodes are placed into the node arena in scope, if there's one
+  static void *operator new(const size_t size) { return NodeArena::allocateNode(size); }
+  static void operator delete(void *node) { NodeArena::deallocateNode(node); }
+
   void accept(Visitor &v) override {
     v.visit(*this);
   }
@@ -57,6 +64,20 @@ class Root : public IVisitable {
     m_globalFunctions.push_back(std::move(function));
   }
 
+  // Moves over the global definitions of `other`, placing them after the ones already here
+  void append(Root &&other) {
+    std::move(other.m_globalClasses.begin(), other.m_globalClasses.end(), std::back_inserter(m_globalClasses));
+    std::move(other.m_globalFunctions.begin(), other.m_globalFunctions.end(), std::back_inserter(m_globalFunctions));
+    other.m_globalClasses.clear();
+    other.m_globalFunctions.clear();
+  }
+
+  // Drops the global functions for which `predicate` holds, returning how many there were
+  template <typename Predicate>
+  size_t removeGlobalFunctions(Predicate predicate) {
+    return std::erase_if(m_globalFunctions, [&](const RootPtr &function) { return predicate(*function); });
+  }
+
   const TokenPtr &getToken() const {
     return m_token;
   }
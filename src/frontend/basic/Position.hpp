@@ -4,22 +4,24 @@
 #ifndef WISNIALANG_POSITION_HPP
 #define WISNIALANG_POSITION_HPP
 
-#include <utility>
+#include <string>
+// Wisnia
+#include "SourceManager.hpp"
 
 namespace Wisnia::Basic {
 
+// Position of a token in the source file, decoded from its location on demand
 class Position {
  public:
-  Position(std::string file, const size_t line)
-      : m_fileName{std::move(file)}
-      , m_lineNo{line}
-  {}
-  std::string getFileName() const { return m_fileName; }
-  size_t getLineNo() const { return m_lineNo; }
+  Position() = default;
+  explicit Position(const SourceLocation location) : m_location{location} {}
+  const std::string &getFileName() const { return SourceManager::getFileName(m_location); }
+  size_t getLineNo() const { return m_location.isValid() ? SourceManager::getLineNo(m_location) : 0; }
+  size_t getColumnNo() const { return m_location.isValid() ? SourceManager::getColumnNo(m_location) : 0; }
+  SourceLocation getLocation() const { return m_location; }
 
  private:
-  std::string m_fileName;
-  size_t m_lineNo;
+  SourceLocation m_location;
 };
 
 }  // namespace Wisnia::Basic
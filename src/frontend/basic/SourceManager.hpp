@@ -0,0 +1,143 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_SOURCE_MANAGER_HPP
+#define WISNIALANG_SOURCE_MANAGER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <fmt/format.h>
+// Wisnia
+#include "Exceptions.hpp"
+#include "SourceBuffer.hpp"
+
+namespace Wisnia::Basic {
+
+// Where in the source a token starts: the ID of its file and the byte offset into it. Lines and
+// columns aren't stored, the source manager works them out from the offset when asked for
+class SourceLocation {
+ public:
+  static constexpr uint32_t kNoFile{std::numeric_limits<uint32_t>::max()};
+
+  constexpr SourceLocation() = default;
+  constexpr SourceLocation(const uint32_t fileId, const uint32_t offset) : m_fileId{fileId}, m_offset{offset} {}
+
+  constexpr uint32_t getFileId() const { return m_fileId; }
+  constexpr uint32_t getOffset() const { return m_offset; }
+
+  constexpr bool isValid() const { return m_fileId != kNoFile; }
+
+ private:
+  uint32_t m_fileId{kNoFile};
+  uint32_t m_offset{0};
+};
+
+static_assert(sizeof(SourceLocation) == 8);
+
+// Registers every source file of a compilation once and resolves locations back into file names,
+// lines and columns. The files are shared by all the threads, as the top-level definitions of a
+// file are lexed in parallel, and the IDs are only meaningful until the compilation's scope ends
+class SourceManager {
+  struct File {
+    SourceBuffer::SourcePtr m_source;
+    // Offsets the lines start at, found on the first lookup into the file
+    std::vector<uint32_t> m_lineStarts;
+  };
+
+  static inline std::deque<File> m_files{};
+  static inline std::mutex m_mutex{};
+
+  // Returns the file the location is in, with its lines found. Has to be called with the mutex held
+  static const File &fileOf(const SourceLocation location) {
+    auto &file = m_files.at(location.getFileId());
+    if (file.m_lineStarts.empty()) {
+      const auto data = file.m_source->getData();
+      file.m_lineStarts.push_back(0);
+      for (size_t pos = data.find('\n'); pos != std::string_view::npos; pos = data.find('\n', pos + 1)) {
+        file.m_lineStarts.push_back(static_cast<uint32_t>(pos + 1));
+      }
+      // The lexer makes up the newline the data lacks, which ends the last line all the same
+      if (!file.m_source->hasTrailingNewline()) {
+        file.m_lineStarts.push_back(static_cast<uint32_t>(data.size() + 1));
+      }
+    }
+    return file;
+  }
+
+  // Returns the index of the line the location is on. Has to be called with the mutex held
+  static size_t lineOf(const File &file, const SourceLocation location) {
+    const auto next = std::upper_bound(file.m_lineStarts.begin(), file.m_lineStarts.end(), location.getOffset());
+    return static_cast<size_t>(next - file.m_lineStarts.begin()) - 1;
+  }
+
+ public:
+  // Starts the file IDs over for a compilation, and brings back the ones before it once it's done
+  class Scope {
+   public:
+    Scope() {
+      std::scoped_lock lock{m_mutex};
+      m_previous = std::exchange(m_files, {});
+    }
+    ~Scope() {
+      std::scoped_lock lock{m_mutex};
+      m_files = std::move(m_previous);
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+   private:
+    std::deque<File> m_previous;
+  };
+
+  // Returns the ID of the source, registering it on the first call. The source is kept alive
+  // for as long as the scope lasts, so that its locations can still be resolved
+  static uint32_t registerFile(const SourceBuffer::SourcePtr &source) {
+    std::scoped_lock lock{m_mutex};
+    const auto it = std::find_if(m_files.begin(), m_files.end(), [&](const File &file) {
+      return file.m_source == source;
+    });
+    if (it != m_files.end()) {
+      return static_cast<uint32_t>(it - m_files.begin());
+    }
+    // One past the end has to fit too, that's where the newline the lexer makes up is
+    if (source->size() >= std::numeric_limits<uint32_t>::max()) {
+      throw LexerError{fmt::format("Cannot register {}: source files are limited to 4 GiB", source->getFileName())};
+    }
+    m_files.push_back({source, {}});
+    return static_cast<uint32_t>(m_files.size() - 1);
+  }
+
+  static const std::string &getFileName(const SourceLocation location) {
+    static const std::string kNoFileName{};
+    if (!location.isValid()) {
+      return kNoFileName;
+    }
+    std::scoped_lock lock{m_mutex};
+    return m_files.at(location.getFileId()).m_source->getFileName();
+  }
+
+  // Lines start from 1
+  static size_t getLineNo(const SourceLocation location) {
+    std::scoped_lock lock{m_mutex};
+    return lineOf(fileOf(location), location) + 1;
+  }
+
+  // Columns start from 1
+  static size_t getColumnNo(const SourceLocation location) {
+    std::scoped_lock lock{m_mutex};
+    const auto &file = fileOf(location);
+    return location.getOffset() - file.m_lineStarts[lineOf(file, location)] + 1;
+  }
+};
+
+}  // namespace Wisnia::Basic
+
+#endif  // WISNIALANG_SOURCE_MANAGER_HPP
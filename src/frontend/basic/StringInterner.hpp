@@ -0,0 +1,62 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_STRING_INTERNER_HPP
+#define WISNIALANG_STRING_INTERNER_HPP
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Wisnia::Basic {
+
+// Names are compared and looked up by their symbol, handed out in the order they're first seen
+using SymbolId = uint32_t;
+
+// Keeps a single copy of every name and gives each a symbol. Symbols stay valid for as long as
+// the program runs, so that they can be kept anywhere. Names are interned by the semantic
+// analysis and the IR generator, which run on a single thread, so the interner doesn't lock
+class StringInterner {
+ public:
+  static StringInterner &global() {
+    static StringInterner interner{};
+    return interner;
+  }
+
+  SymbolId intern(const std::string_view text) {
+    if (const auto it = m_symbols.find(text); it != m_symbols.end()) {
+      return it->second;
+    }
+    const auto symbol = static_cast<SymbolId>(m_strings.size());
+    m_symbols.emplace(m_strings.emplace_back(text), symbol);
+    return symbol;
+  }
+
+  // Returns the symbol of the text, or nothing if it was never interned
+  std::optional<SymbolId> find(const std::string_view text) const {
+    if (const auto it = m_symbols.find(text); it != m_symbols.end()) {
+      return it->second;
+    }
+    return std::nullopt;
+  }
+
+  std::string_view lookup(const SymbolId symbol) const {
+    return m_strings[symbol];
+  }
+
+  size_t size() const {
+    return m_strings.size();
+  }
+
+ private:
+  // A deque never moves its elements, so the keys of `m_symbols` can point into them
+  std::deque<std::string> m_strings;
+  std::unordered_map<std::string_view, SymbolId> m_symbols;
+};
+
+}  // namespace Wisnia::Basic
+
+#endif  // WISNIALANG_STRING_INTERNER_HPP
@@ -4,7 +4,10 @@
 #ifndef WISNIALANG_TOKEN_TYPE_HPP
 #define WISNIALANG_TOKEN_TYPE_HPP
 
+#include <array>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 
 namespace Wisnia::Basic {
 
@@ -157,7 +160,8 @@ static inline std::unordered_map<TType, std::string> TokenType2Str {
   {TType::TOK_EOF, "TOK_EOF"}
 };
 
-static inline std::unordered_map<std::string_view, TType> Str2TokenKw {
+// The lexer builds its perfect hash out of this table at compile time (see KeywordHash.hpp)
+static constexpr auto Str2TokenKw = std::to_array<std::pair<std::string_view, TType>>({
   {"fn", TType::KW_FN},          {"class", TType::KW_CLASS},
   {"new", TType::KW_CLASS_INIT}, {"def", TType::KW_CLASS_DEF},
   {"rem", TType::KW_CLASS_REM},  {"return", TType::KW_RETURN},
@@ -170,7 +174,7 @@ static inline std::unordered_map<std::string_view, TType> Str2TokenKw {
   {"print", TType::KW_PRINT},    {"void", TType::KW_VOID},
   {"int", TType::KW_INT},        {"bool", TType::KW_BOOL},
   {"float", TType::KW_FLOAT},    {"string", TType::KW_STRING}
-};
+});
 
 static inline std::unordered_map<std::string_view, TType> Str2TokenOp {
   {"=", TType::OP_ASSN},        {"->", TType::OP_FN_ARROW},
@@ -26,10 +26,10 @@ template<class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
 class Token {
  public:
   Token(const TType type, TokenValue value, std::unique_ptr<Position> pif = nullptr)
-      : m_type{type}, m_value{std::move(value)}, m_position{std::move(pif)} {}
+      : m_type{type}, m_value{std::move(value)}, m_position{pif ? *pif : Position{}} {}
 
   Token(const TType type, TokenValue value, const Position &pif)
-      : m_type{type}, m_value{std::move(value)}, m_position{std::make_unique<Position>(pif)} {}
+      : m_type{type}, m_value{std::move(value)}, m_position{pif} {}
 
   template <typename T>
   T getValue() const {
@@ -106,12 +106,12 @@ class Token {
   void setType(const TType type) { m_type = type; }
   void setValue(const TokenValue &value) { m_value = value; }
   std::string &getName() const { return TokenType2Str[m_type]; }
-  Position &getPosition() const { return *m_position; }
+  const Position &getPosition() const { return m_position; }
 
  private:
   TType m_type;
   TokenValue m_value;
-  std::unique_ptr<Position> m_position;
+  Position m_position;
 };
 
 }  // namespace Wisnia::Basic
@@ -0,0 +1,97 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_KEYWORD_HASH_HPP
+#define WISNIALANG_KEYWORD_HASH_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+// Wisnia
+#include "TType.hpp"
+
+// Perfect hash over the keywords in `Str2TokenKw`, generated at compile time. An identifier is
+// hashed by its length and its first, second and last characters, so telling whether it's a
+// keyword takes a single table lookup and one string comparison
+namespace Wisnia::KeywordHash {
+
+namespace Impl {
+constexpr uint32_t kBits{6};
+constexpr size_t kSize{1u << kBits};
+
+constexpr size_t kMinLength = std::ranges::min(Basic::Str2TokenKw, {}, [](const auto &kw) {
+  return kw.first.size();
+}).first.size();
+constexpr size_t kMaxLength = std::ranges::max(Basic::Str2TokenKw, {}, [](const auto &kw) {
+  return kw.first.size();
+}).first.size();
+
+static_assert(kMinLength >= 2, "keywords are hashed by their first two characters");
+static_assert(Basic::Str2TokenKw.size() <= kSize / 2, "too many keywords for the hash table");
+
+struct Slot {
+  std::string_view m_text{};
+  Basic::TType m_type{Basic::TType::IDENT};
+};
+
+constexpr uint32_t hash(const std::string_view text, const uint64_t seed) {
+  const uint64_t key = static_cast<uint64_t>(static_cast<unsigned char>(text[0])) |
+                       static_cast<uint64_t>(static_cast<unsigned char>(text[1])) << 8 |
+                       static_cast<uint64_t>(static_cast<unsigned char>(text.back())) << 16 |
+                       static_cast<uint64_t>(text.size()) << 24;
+  return static_cast<uint32_t>((key * seed) >> (64 - kBits));
+}
+
+constexpr bool isPerfect(const uint64_t seed) {
+  std::array<bool, kSize> taken{};
+  for (const auto &[text, type] : Basic::Str2TokenKw) {
+    if (std::exchange(taken[hash(text, seed)], true)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The first multiplier (out of a pseudo-random sequence) that maps every keyword into its own slot
+constexpr uint64_t kSeed = [] {
+  uint64_t seed = 0x9e3779b97f4a7c15;
+  for (size_t attempt = 0; attempt < (1u << 14); ++attempt) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    if (isPerfect(seed | 1)) {
+      return seed | 1;
+    }
+  }
+  return uint64_t{0};
+}();
+
+static_assert(kSeed != 0, "no perfect hash found for the keywords, consider hashing more characters");
+
+constexpr std::array<Slot, kSize> kSlots = [] {
+  std::array<Slot, kSize> slots{};
+  for (const auto &[text, type] : Basic::Str2TokenKw) {
+    slots[hash(text, kSeed)] = {text, type};
+  }
+  return slots;
+}();
+
+}  // namespace Impl
+
+// Returns the type of the keyword, or `TType::IDENT` if the text isn't one
+constexpr Basic::TType lookup(const std::string_view text) {
+  using namespace Impl;
+  if (text.size() < kMinLength || text.size() > kMaxLength) {
+    return Basic::TType::IDENT;
+  }
+  const Slot &slot = kSlots[hash(text, kSeed)];
+  return slot.m_text == text ? slot.m_type : Basic::TType::IDENT;
+}
+
+static_assert(std::ranges::all_of(Basic::Str2TokenKw, [](const auto &kw) { return lookup(kw.first) == kw.second; }));
+
+}  // namespace Wisnia::KeywordHash
+
+#endif  // WISNIALANG_KEYWORD_HASH_HPP
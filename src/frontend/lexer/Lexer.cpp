@@ -4,382 +4,306 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
-#include <fstream>
+#include <charconv>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <fmt/format.h>
 // Wisnia
 #include "Exceptions.hpp"
+#include "KeywordHash.hpp"
 #include "Lexer.hpp"
 #include "SemanticAnalysis.hpp"
+#include "SimdScan.hpp"
 #include "Token.hpp"
 
 using namespace Wisnia;
 using namespace Basic;
 
-constexpr std::array kSimpleOperands{'.', '*', '(', ')', '{', '}', ',', ':', ';'};
+namespace {
+// Typical sources have a token every few bytes, which is how much the arena reserves up front
+constexpr size_t kBytesPerTokenEstimate{4};
+
+// Operators are looked up in `Str2TokenOp`, the single character ones through a table built out of it
+TType operatorType(const std::string_view op) {
+  static const auto kSingleCharOps = [] {
+    std::array<TType, 256> table{};
+    table.fill(TType::TOK_INVALID);
+    for (const auto &[text, type] : Str2TokenOp) {
+      if (text.size() == 1) {
+        table[static_cast<unsigned char>(text[0])] = type;
+      }
+    }
+    return table;
+  }();
+  return op.size() == 1 ? kSingleCharOps[static_cast<unsigned char>(op[0])] : Str2TokenOp.at(op);
+}
+
+// Resolves escape sequences the same way they are recognized by the lexer
+std::string unescape(const std::string_view text) {
+  std::string result{};
+  result.reserve(text.size());
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (text[i] != '\\' || i + 1 == text.size()) {
+      result += text[i];
+      continue;
+    }
+    switch (const char ch = text[++i]) {
+      case 'f':  result += '\f'; break;
+      case 'r':  result += '\r'; break;
+      case 't':  result += '\t'; break;
+      case 'v':  result += '\v'; break;
+      case 'n':  result += '\n'; break;
+      case '\"': result += '\"'; break;
+      default:
+        result += '\\';
+        result += ch;
+        break;
+    }
+  }
+  return result;
+}
+}  // namespace
+
+CompactToken Lexer::finishTok(const TType &type, const bool goBack) {
+  // Operators end with the current character, while numbers (and anything we step back from)
+  // end right before it
+  const bool excludeCurrent = goBack || type == TType::LIT_INT || type == TType::LIT_FLT;
+  const size_t tokEnd = m_tokenState.m_index + (excludeCurrent ? 0 : 1);
 
-Lexer::TokenPtr Lexer::finishTok(const TType &type, const bool goBack) {
   // We've over-gone by 1 character further by returning the token earlier, so step back
   if (goBack) {
-    --m_tokenState.m_iterator;
+    --m_tokenState.m_index;
   }
 
   m_tokenState.m_state = State::START;
-  const size_t lineNo = (type == TType::LIT_STR) ? m_tokenState.m_strStart : m_tokenState.m_lineNo;
-  auto pif = std::make_unique<Position>(m_tokenState.m_fileName, lineNo);
+  const bool isString = type == TType::LIT_STR;
+  const auto offset = static_cast<uint32_t>(m_tokenState.m_tokOffset);
 
-  auto TokValue = [&]() -> TokenValue {
-    switch (type) {
-      // Integer
-      case TType::LIT_INT:
-        int value;
-        try {
-          value = std::stoi(m_tokenState.m_buff);
-        } catch (const std::out_of_range &) {
-          throw TokenError{fmt::format("Value '{}' is out of supported range ('{}') in {}:{}",
-                                       m_tokenState.m_buff,
-                                       kMaxIntValue,
-                                       pif->getFileName(),
-                                       pif->getLineNo())};
-        }
-        return value;
-      // Float
-      case TType::LIT_FLT:
-        return std::stof(m_tokenState.m_buff);
-      // Bool
-      case TType::KW_TRUE:
-      case TType::KW_FALSE:
-        return m_tokenState.m_buff == "true";
-      default:
-        return m_tokenState.m_buff;
-    }
-  };
+  // The closing quote isn't a part of the string
+  auto text = m_tokenState.m_data.substr(m_tokenState.m_tokStart, tokEnd - m_tokenState.m_tokStart - (isString ? 1 : 0));
+  if (isString && m_tokenState.m_strEscaped) {
+    text = m_arena.store(unescape(text));
+  }
 
-  auto token = std::make_shared<Token>(type, TokValue(), std::move(pif));
-  m_tokenState.m_buff.clear();
+  CompactToken token{type, offset, text.data(), static_cast<uint32_t>(text.size()), {0}};
+  switch (type) {
+    // Integer
+    case TType::LIT_INT:
+      if (const auto [ptr, ec] = std::from_chars(text.begin(), text.end(), token.m_int); ec == std::errc::result_out_of_range) {
+        throw TokenError{fmt::format("Value '{}' is out of supported range ('{}') in {}:{}",
+                                     text,
+                                     kMaxIntValue,
+                                     m_tokenState.m_fileName,
+                                     lineAt(offset))};
+      }
+      break;
+    // Float
+    case TType::LIT_FLT:
+      std::from_chars(text.begin(), text.end(), token.m_float);
+      break;
+    default:
+      break;
+  }
   return token;
 }
 
-Lexer::TokenPtr Lexer::finishIdent() {
-  if (const auto it = Str2TokenKw.find(m_tokenState.m_buff); it != Str2TokenKw.end()) {
-    return finishTok(it->second, true);
+CompactToken Lexer::finishIdent() {
+  const auto text = m_tokenState.m_data.substr(m_tokenState.m_tokStart, m_tokenState.m_index - m_tokenState.m_tokStart);
+  return finishTok(KeywordHash::lookup(text), true);
+}
+
+void Lexer::tokNext(const char ch) {
+  if (m_tokenState.m_state == State::START) {
+    m_tokenState.m_tokStart = m_tokenState.m_index;
+    m_tokenState.m_tokOffset = m_tokenState.m_index;
+  }
+
+  const auto &transition = transitionOf(m_tokenState.m_state, classOf(ch));
+  m_tokenState.m_state = transition.m_next;
+  switch (transition.m_action) {
+    case LexerAction::NONE:
+      break;
+    case LexerAction::EMIT:
+      m_arena.push(finishTok(transition.m_type));
+      break;
+    case LexerAction::EMIT_BACK:
+      m_arena.push(finishTok(transition.m_type, true));
+      break;
+    case LexerAction::EMIT_OP:
+      m_arena.push(finishTok(operatorType(m_tokenState.m_data.substr(
+        m_tokenState.m_tokStart, m_tokenState.m_index + 1 - m_tokenState.m_tokStart))));
+      break;
+    case LexerAction::EMIT_OP_BACK:
+      m_arena.push(finishTok(operatorType(m_tokenState.m_data.substr(
+        m_tokenState.m_tokStart, m_tokenState.m_index - m_tokenState.m_tokStart)), true));
+      break;
+    case LexerAction::EMIT_IDENT:
+      m_arena.push(finishIdent());
+      break;
+    case LexerAction::STRING_START:
+      m_tokenState.m_strEscaped = false;
+      m_tokenState.m_tokStart = m_tokenState.m_index + 1;
+      break;
+    case LexerAction::STRING_ESCAPE:
+      m_tokenState.m_strEscaped = true;
+      break;
+    case LexerAction::SUFFIX:
+      m_tokenState.m_errType = transition.m_detail;
+      break;
+    case LexerAction::INVALID:
+      throw LexerError{fmt::format("Invalid suffix for {} in {}:{}",
+                                   transition.m_detail.empty() ? m_tokenState.m_errType : transition.m_detail,
+                                   m_tokenState.m_fileName,
+                                   lineAt(m_tokenState.m_index))};
+    case LexerAction::UNRECOGNIZED:
+      throw LexerError{fmt::format("Unrecognized character '{}' in {}:{}",
+                                   ch,
+                                   m_tokenState.m_fileName,
+                                   lineAt(m_tokenState.m_index))};
+    case LexerAction::UNTERMINATED_STR:
+      throw LexerError{fmt::format("String was not terminated in {}:{}",
+                                   m_tokenState.m_fileName,
+                                   lineAt(m_tokenState.m_index))};
+    case LexerAction::UNCLOSED_CMT:
+      throw LexerError{fmt::format("Multi-line comment was not closed in {}:{}",
+                                   m_tokenState.m_fileName,
+                                   lineAt(m_tokenState.m_index))};
   }
-  return finishTok(TType::IDENT, true);
 }
 
-std::optional<Lexer::TokenPtr> Lexer::tokNext(const char ch) {
+void Lexer::skipAhead() {
+  const auto data = m_tokenState.m_data;
+  auto &index = m_tokenState.m_index;
   switch (m_tokenState.m_state) {
-    /* ~~~ CASE: START ~~~ */
     case State::START:
-      if (isalpha(ch) || ch == '_') {
-        m_tokenState.m_state = State::IDENT;
-        m_tokenState.m_buff += ch;
+      if (index < data.size() && isSpaceClass(classOf(data[index]))) {
+        index = Simd::skipWhitespace(data, index);
       }
-      else if (ch == '!' || ch == '<' || ch == '>' || ch == '=') {
-        m_tokenState.m_state = State::OP_COMPARE;
-        m_tokenState.m_buff += ch;
-      }
-      else if (ch == '\"') {
-        m_tokenState.m_strStart = m_tokenState.m_lineNo;
-        m_tokenState.m_state = State::STRING;
-      }
-      else if (isdigit(ch)) {
-        m_tokenState.m_state = State::INTEGER;
-        m_tokenState.m_buff += ch;
-      }
-      else if (ch == '&') {
-        m_tokenState.m_state = State::LOGIC_AND;
-        m_tokenState.m_buff += ch;
-      }
-      else if (ch == '|') {
-        m_tokenState.m_state = State::LOGIC_OR;
-        m_tokenState.m_buff += ch;
-      }
-      else if (ch == '+') {
-        m_tokenState.m_state = State::OP_PP;
-        m_tokenState.m_buff += ch;
-      }
-      else if (ch == '-') {
-        m_tokenState.m_state = State::OP_MM;
-        m_tokenState.m_buff += ch;
-      }
-      else if (ch == '/') {
-        m_tokenState.m_state = State::CMT_I;
-      }
-      else if (std::any_of(kSimpleOperands.begin(), kSimpleOperands.end(), [&](const char op) { return ch == op; })) {
-        m_tokenState.m_buff = ch;
-        return finishTok(Str2TokenOp[m_tokenState.m_buff]);
-      }
-      else if (isspace(ch)) {
-        if (ch == '\n') {
-          ++m_tokenState.m_lineNo;
-        }
-      }
-      else {
-        throw LexerError{fmt::format("Unrecognized character '{}' in {}:{}",
-                                     ch,
-                                     m_tokenState.m_fileName,
-                                     m_tokenState.m_lineNo)};
-      }
-      return {};
-
-    /* ~~~ CASE: IDENT ~~~ */
+      break;
     case State::IDENT:
-      if (isspace(ch)) {
-        return finishIdent();
-      }
-      if (!isalpha(ch) && !isdigit(ch) && ch != '_') {
-        return finishIdent();
-      }
-      m_tokenState.m_buff += ch;
-      return {};
-
-    /* ~~~ CASE: OP_COMPARE ~~~ */
-    case State::OP_COMPARE:
-      if (ch == '=') {
-        // (!=, <=, >=, ==)
-        m_tokenState.m_buff += '=';
-        return finishTok(Str2TokenOp[m_tokenState.m_buff]);
-      }
-      // (!, <, >, =)
-      return finishTok(Str2TokenOp[m_tokenState.m_buff], true);
-
-    /* ~~~ CASE: STRING ~~~ */
-    case State::STRING:
-      if (ch == '\\') {
-        m_tokenState.m_state = State::ESCAPE_SEQ;
-      }
-      else {
-        if (ch == '\n') {
-          ++m_tokenState.m_lineNo;
-        } else if (ch == '\"') {
-          return finishTok(TType::LIT_STR);
-        } else if (ch == -1) {
-          throw LexerError{fmt::format("String was not terminated in {}:{}",
-                                       m_tokenState.m_fileName,
-                                       m_tokenState.m_lineNo)};
-        }
-        m_tokenState.m_buff += ch;
-      }
-      return {};
-
-    /* ~~~ CASE: ESCAPE_SEQ ~~~ */
-    case State::ESCAPE_SEQ:
-      switch (ch) {
-        case 'f':
-          m_tokenState.m_buff += '\f';
-          break;
-        case 'r':
-          m_tokenState.m_buff += '\r';
-          break;
-        case 't':
-          m_tokenState.m_buff += '\t';
-          break;
-        case 'v':
-          m_tokenState.m_buff += '\v';
-          break;
-        case 'n':
-          m_tokenState.m_buff += '\n';
-          break;
-        case '\"':
-          m_tokenState.m_buff += '\"';
-          break;
-        default:
-          m_tokenState.m_buff += "\\";
-          m_tokenState.m_buff += ch;
-          break;
-      }
-      // Continue parsing
-      m_tokenState.m_state = State::STRING;
-      return {};
-
-    /* ~~~ CASE: INTEGER ~~~ */
-    case State::INTEGER:
-      if (isspace(ch)) {
-        return finishTok(TType::LIT_INT);
-      }
-      if (ch == '.') {
-        m_tokenState.m_state = State::FLOAT;
-      } else if (isalpha(ch)) {
-        m_tokenState.m_state = State::ERRONEOUS_NUMBER;
-        m_tokenState.m_errType = "integer";
-      } else if (!isdigit(ch)) {
-        return finishTok(TType::LIT_INT, true);
-      }
-      m_tokenState.m_buff += ch;
-      return {};
-
-    /* ~~~ CASE: FLOAT ~~~ */
-    case State::FLOAT:
-      if (isspace(ch)) {
-        return finishTok(TType::LIT_FLT);
-      }
-      if (isalpha(ch) || ch == '.') {
-        m_tokenState.m_state = State::ERRONEOUS_NUMBER;
-        m_tokenState.m_errType = "float";
-      } else if (!isdigit(ch)) {
-        return finishTok(TType::LIT_FLT, true);
-      }
-      m_tokenState.m_buff += ch;
-      return {};
-
-    /* ~~~ CASE: ERRONEOUS_NUMBER ~~~ */
-    case State::ERRONEOUS_NUMBER:
-      if (isspace(ch)) {
-        if (ch == '\n') {
-          ++m_tokenState.m_lineNo;
-        }
-        return finishTok(TType::TOK_INVALID);
-      }
-      m_tokenState.m_buff += ch;
-      return {};
-
-    /* ~~~ CASE: LOGIC_AND ~~~ */
-    case State::LOGIC_AND:
-      if (ch == '&') {
-        return finishTok(TType::OP_AND);
-      }
-      m_tokenState.m_errType = "ampersand";
-      return finishTok(TType::TOK_INVALID, true);
-
-    /* ~~~ CASE: LOGIC_OR ~~~ */
-    case State::LOGIC_OR:
-      if (ch == '|') {
-        return finishTok(TType::OP_OR);
-      }
-      m_tokenState.m_errType = "tilde";
-      return finishTok(TType::TOK_INVALID, true);
-
-    /* ~~~ CASE: OP_PP ~~~ */
-    case State::OP_PP:
-      if (ch == '+') {
-        return finishTok(TType::OP_UADD);
-      }
-      return finishTok(TType::OP_ADD, true);
-
-    /* ~~~ CASE: OP_MM ~~~ */
-    case State::OP_MM:
-      if (ch == '-') {
-        m_tokenState.m_buff += ch;
-        return finishTok(TType::OP_USUB);
-      }
-      if (ch == '>') {
-        m_tokenState.m_buff += ch;
-        return finishTok(TType::OP_FN_ARROW);
-      }
-      return finishTok(TType::OP_SUB, true);
-
-    /* ~~~ CASE: CMT_SINGLE ~~~ */
+      index = Simd::skipIdentifier(data, index);
+      break;
     case State::CMT_SINGLE:
-      if (ch == '\n') {
-        m_tokenState.m_state = State::START;
-        ++m_tokenState.m_lineNo;
-      }
-      return {};
-
-    /* ~~~ CASE: CMT_I ~~~ */
-    case State::CMT_I:
-      if (ch == '*') {
-        m_tokenState.m_state = State::CMT_II;
-        return {};
-      }
-      if (ch == '/') {
-        m_tokenState.m_state = State::CMT_SINGLE;
-        return {};
-      }
-      // It was just a division symbol
-      m_tokenState.m_state = State::START;
-      return finishTok(TType::OP_DIV, true);
-
-    /* ~~~ CASE: CMT_II ~~~ */
+      index = Simd::skipLineComment(data, index);
+      break;
     case State::CMT_II:
-      if (ch == '*') {
-        m_tokenState.m_state = State::CMT_III;
-      } else if (ch == '\n') {
-        ++m_tokenState.m_lineNo;
-      } else if (ch == -1) {
-        // Reached EOF
-        throw LexerError{fmt::format("Multi-line comment was not closed in {}:{}",
-                                     m_tokenState.m_fileName,
-                                     m_tokenState.m_lineNo)};
-      }
-      return {};
-
-    /* ~~~ CASE: CMT_III ~~~ */
-    case State::CMT_III:
-      if (ch == '/') {
-        m_tokenState.m_state = State::START;
-      } else if (ch == -1) {
-        // Reached EOF
-        throw LexerError{fmt::format("Multi-line comment was not closed in {}:{}",
-                                     m_tokenState.m_fileName,
-                                     m_tokenState.m_lineNo)};
-      } else if (ch != '*') {
-        m_tokenState.m_state = State::CMT_II;
-      }
-      return {};
-
-    /* ~~~ CASE: ERRONEOUS ~~~ */
+      index = Simd::skipBlockComment(data, index);
+      break;
     default:
-      throw LexerError{fmt::format("Reached an unexpected state in {}:{}",
-                                   m_tokenState.m_fileName,
-                                   m_tokenState.m_lineNo)};
+      break;
   }
 }
 
 void Lexer::tokenize(std::string_view filename) {
-  std::ifstream sourceFile{filename.data()};
-  m_tokenState.m_data = {std::istreambuf_iterator(sourceFile), std::istreambuf_iterator<char>()};
-  m_tokenState.m_fileName = filename;
-  tokenizeInput();
+  auto source = SourceBuffer::fromFile(filename);
+  const Range range{0, source->size()};
+  tokenize(std::move(source), range);
 }
 
 void Lexer::tokenize(std::istringstream &stream) {
-  m_tokenState.m_data = {std::istreambuf_iterator(stream), std::istreambuf_iterator<char>()};
-  m_tokenState.m_fileName = "in-memory";
-  tokenizeInput();
+  auto source = SourceBuffer::fromStream(stream);
+  const Range range{0, source->size()};
+  tokenize(std::move(source), range);
 }
 
-void Lexer::tokenizeInput() {
+void Lexer::tokenize(SourceBuffer::SourcePtr source, const Range &range) {
+  const uint32_t fileId = SourceManager::registerFile(source);
+  m_arena.setSource(std::move(source), fileId);
+  beginInput(range);
+  if (!m_streaming) {
+    tokenizeInput();
+  }
+}
+
+void Lexer::beginInput(const Range &range) {
+  const auto &source = m_arena.getSource();
+  m_tokenState.m_data = source->getData().substr(0, range.m_end);
+  m_tokenState.m_fileName = source->getFileName();
+  m_tokenState.m_fileId = m_arena.getFileId();
   assert(!m_tokenState.m_data.empty() && !m_tokenState.m_fileName.empty() &&
          "the provided input was either empty or Lexer::tokenize wasn't called");
 
-  // Add a newline at the end of the data if there's none already.
+  // Walk one character past the end of the data if there's no newline there already.
   // This comes in handy to save the last token from getting dismissed
-  // when we reach the end of file and escape the condition `if(currState == MAIN)`
-  if (m_tokenState.m_data.back() != '\n') {
-    m_tokenState.m_data += '\n';
+  // when we reach the end of file and escape the condition `if(currState == MAIN)`.
+  // The newline itself is made up by `charAt`, so the (possibly mapped) data is never copied
+  m_tokenState.m_index = range.m_begin;
+  m_tokenState.m_end = m_tokenState.m_data.size() + (m_tokenState.m_data.ends_with('\n') ? 0 : 1);
+}
+
+void Lexer::tokenizeInput() {
+  m_arena.reserve((m_tokenState.m_end - m_tokenState.m_index) / kBytesPerTokenEstimate);
+  while (m_tokenState.m_index != m_tokenState.m_end) {
+    skipAhead();
+    if (m_tokenState.m_index == m_tokenState.m_end) {
+      break;
+    }
+    tokNext(charAt(m_tokenState.m_index));
+    ++m_tokenState.m_index;
   }
+  finishInput();
+}
 
-  // Set an iterator to the beginning of the data
-  // And file name for the file being tokenized at the moment
-  m_tokenState.m_iterator = m_tokenState.m_data.begin();
-  while (m_tokenState.m_iterator != m_tokenState.m_data.end()) {
-    if (auto result = tokNext(*m_tokenState.m_iterator); result.has_value()) {
-      if (result.value()->getType() != TType::TOK_INVALID) {
-        m_tokens.push_back(*result);
-      } else {
-        throw LexerError{fmt::format("Invalid suffix for {} in {}:{}",
-                                     m_tokenState.m_errType,
-                                     m_tokenState.m_fileName,
-                                     m_tokenState.m_lineNo)};
-      }
+void Lexer::tokenizeNext() {
+  // Every character produces at most a single token
+  const size_t count = m_arena.size();
+  while (m_tokenState.m_index != m_tokenState.m_end && m_arena.size() == count) {
+    skipAhead();
+    if (m_tokenState.m_index == m_tokenState.m_end) {
+      break;
     }
-    ++m_tokenState.m_iterator;
+    tokNext(charAt(m_tokenState.m_index));
+    ++m_tokenState.m_index;
+  }
+  if (m_arena.size() == count) {
+    finishInput();
+  }
+}
+
+void Lexer::finishInput() {
+  constexpr std::string_view eof{"[EOF]"};
+  const auto offset = static_cast<uint32_t>(m_tokenState.m_index);
+  m_arena.push({TType::TOK_EOF, offset, eof.data(), eof.size(), {0}});
+}
+
+size_t Lexer::lineAt(const size_t index) const {
+  return SourceManager::getLineNo(SourceLocation{m_tokenState.m_fileId, static_cast<uint32_t>(index)});
+}
+
+Lexer::TokenPtr Lexer::next() {
+  if (!m_streaming) {
+    const auto &tokens = getTokens();
+    return tokens[std::min(m_nextToken++, tokens.size() - 1)];
+  }
+  if (m_arena.size() == 0) {
+    tokenizeNext();
   }
+  auto token = m_arena.materialize(m_arena.getTokens().front());
+  // The EOF token stays, so that it's handed out on every following call
+  if (token->getType() != TType::TOK_EOF) {
+    m_arena.clear();
+  }
+  return token;
+}
 
-  // Add the EOF token to mark the file's ending
-  auto pif = std::make_unique<Position>(m_tokenState.m_fileName, m_tokenState.m_lineNo);
-  m_tokens.emplace_back(std::make_shared<Token>(TType::TOK_EOF, "[EOF]", std::move(pif)));
+const std::vector<Lexer::TokenPtr> &Lexer::getTokens() const {
+  assert(!m_streaming && "a streaming lexer doesn't keep its tokens");
+  if (m_tokens.empty()) {
+    m_tokens.reserve(m_arena.size());
+    for (const auto &token : m_arena.getTokens()) {
+      m_tokens.emplace_back(m_arena.materialize(token));
+    }
+  }
+  return m_tokens;
 }
 
 void Lexer::print(std::ostream &output) const {
   size_t index = 0;
   output << fmt::format("{:^6}|{:^6}|{:^17}|{:^17}\n", "ID", "LN", "TYPE", "VALUE");
   output << fmt::format("------+------+-----------------+-----------------\n");
-  for (const auto &token : m_tokens) {
+  for (const auto &token : getTokens()) {
     output << fmt::format(
       "{:^6}|{:^6}|{:^17}|{:^17}\n",
       index,
@@ -393,3 +317,9 @@ void Lexer::print(std::ostream &output) const {
 
 Lexer::Lexer(const std::string_view filename) { tokenize(filename); }
 Lexer::Lexer(std::istringstream &stream) { tokenize(stream); }
+Lexer::Lexer(const std::string_view filename, Streaming) : m_streaming{true} { tokenize(filename); }
+Lexer::Lexer(std::istringstream &stream, Streaming) : m_streaming{true} { tokenize(stream); }
+Lexer::Lexer(SourceBuffer::SourcePtr source, const Range &range) { tokenize(std::move(source), range); }
+Lexer::Lexer(SourceBuffer::SourcePtr source, const Range &range, Streaming) : m_streaming{true} {
+  tokenize(std::move(source), range);
+}
@@ -5,9 +5,12 @@
 #define WISNIALANG_LEXER_HPP
 
 #include <memory>
-#include <optional>
 #include <string>
 #include <vector>
+// Wisnia
+#include "LexerTables.hpp"
+#include "SourceBuffer.hpp"
+#include "TokenArena.hpp"
 
 namespace Wisnia {
 namespace Basic {
@@ -18,75 +21,117 @@ enum class TType;
 class Lexer {
   using TokenPtr = std::shared_ptr<Basic::Token>;
 
-  enum class State {
-    START,             // Start state
-    IDENT,             // Identifier
-    OP_COMPARE,        // Either a single operand (!, <, >, =) or (!=, <=, >=, ==)
-    STRING,            // String literal
-    INTEGER,           // Integer literal
-    FLOAT,             // Float literal
-    ERRONEOUS_NUMBER,  // Invalid number
-    LOGIC_AND,         // Logical AND: &&
-    LOGIC_OR,          // Logical OR: ||
-    OP_PP,             // Unary prefix: ++
-    OP_MM,             // Unary prefix: --
-    ESCAPE_SEQ,        // Escapes \t, \n, etc.
-    CMT_SINGLE,        // Single line comment: //
-    CMT_I,             // Escape multi-line comment (1)
-    CMT_II,            // Escape multi-line comment (2)
-    CMT_III,           // Escape multi-line comment (3)
+ public:
+  // Tag for the constructors that make the lexer tokenize on demand, as `next` gets called,
+  // instead of all at once
+  struct Streaming {};
+
+  // Part of the source to tokenize, which has to start in between tokens
+  struct Range {
+    size_t m_begin{0};
+    size_t m_end{0};
   };
 
+ private:
+  using State = LexerState;
+
   struct TokenState {
     // Info needed to construct a token and to tokenize a letter
     State m_state{State::START};
-    std::string m_buff;
+    size_t m_tokStart{0};
+    size_t m_tokOffset{0};  // Where the token starts, which for strings is their opening quote
 
     // Accessors to the actual data of the source file
-    std::string m_data;
-    std::string::iterator m_iterator;
+    std::string_view m_data;
+    size_t m_index{0};
+    size_t m_end{0};
 
     // Vague info about the source file
     std::string m_fileName;
-    size_t m_lineNo{1};
+    uint32_t m_fileId{0};
 
     // String info
-    size_t m_strStart{0};
+    bool m_strEscaped{false};
 
     // Temp info
     std::string m_errType;
   };
 
   // Having provided the TType, it constructs and returns a token
-  TokenPtr finishTok(const Basic::TType &type, bool goBack = false);
+  CompactToken finishTok(const Basic::TType &type, bool goBack = false);
+
+  // From the characters read since the token start constructs and returns a token of
+  // identifier (or keyword) type
+  CompactToken finishIdent();
+
+  // Continues to tokenize the next letter by looking up the transition for its class
+  void tokNext(char ch);
+
+  // Skips over the characters that wouldn't change the current state (whitespace, comment
+  // bodies and identifier tails) in bulk
+  void skipAhead();
+
+  // Returns the character at `index`, including the newline that is made up past the end of
+  // data lacking one
+  char charAt(size_t index) const {
+    return index < m_tokenState.m_data.size() ? m_tokenState.m_data[index] : '\n';
+  }
 
-  // From an existing token buffer constructs and returns a token of identifier
-  // (or keyword) type
-  TokenPtr finishIdent();
+  // Returns the line of the character at `index`, for the error messages
+  size_t lineAt(size_t index) const;
 
-  // Continues to tokenize the next letter
-  std::optional<TokenPtr> tokNext(char ch);
+  // Prepares to tokenize whatever was passed to the tokenize function
+  void beginInput(const Range &range);
 
-  // Tokenizes whatever was passed to the tokenize function
+  // Tokenizes the whole input at once
   void tokenizeInput();
 
+  // Tokenizes the input up until the next token is produced, or until its end
+  void tokenizeNext();
+
+  // Adds the EOF token to mark the file's ending
+  void finishInput();
+
   // Preps up tokenization
   void tokenize(std::string_view filename);
   void tokenize(std::istringstream &stream);
+  void tokenize(SourceBuffer::SourcePtr source, const Range &range);
 
  public:
   explicit Lexer(std::string_view filename);
   explicit Lexer(std::istringstream &stream);
+  Lexer(std::string_view filename, Streaming);
+  Lexer(std::istringstream &stream, Streaming);
+  Lexer(SourceBuffer::SourcePtr source, const Range &range);
+  Lexer(SourceBuffer::SourcePtr source, const Range &range, Streaming);
+
+  // Returns the next token, or the EOF token over and over again once there are no more.
+  // A streaming lexer tokenizes just enough input to produce it and keeps no tokens around
+  TokenPtr next();
+
+  bool isStreaming() const { return m_streaming; }
 
   // Returns tokens
-  const std::vector<TokenPtr> &getTokens() const { return m_tokens; }
+  // They are built out of the compact ones on the first call
+  // Not available in the streaming mode
+  const std::vector<TokenPtr> &getTokens() const;
+
+  // Returns tokens in the layout the lexer produces them
+  const TokenArena &getArena() const { return m_arena; }
+
+  // Returns the source buffer the tokens were read from
+  // Holding onto it keeps the underlying file mapping alive
+  const SourceBuffer::SourcePtr &getSource() const { return m_arena.getSource(); }
 
   // Prints out tokens in a pretty table
   void print(std::ostream &output) const;
 
  private:
-  std::vector<TokenPtr> m_tokens;
+  TokenArena m_arena;
+  mutable std::vector<TokenPtr> m_tokens;
   TokenState m_tokenState;
+  bool m_streaming{false};
+  size_t m_nextToken{0};
 };
 
 }  // namespace Wisnia
@@ -0,0 +1,233 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_LEXER_TABLES_HPP
+#define WISNIALANG_LEXER_TABLES_HPP
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+// Wisnia
+#include "TType.hpp"
+
+namespace Wisnia {
+
+enum class LexerState : uint8_t {
+  START,             // Start state
+  IDENT,             // Identifier
+  OP_COMPARE,        // Either a single operand (!, <, >, =) or (!=, <=, >=, ==)
+  STRING,            // String literal
+  INTEGER,           // Integer literal
+  FLOAT,             // Float literal
+  ERRONEOUS_NUMBER,  // Invalid number
+  LOGIC_AND,         // Logical AND: &&
+  LOGIC_OR,          // Logical OR: ||
+  OP_PP,             // Unary prefix: ++
+  OP_MM,             // Unary prefix: --
+  ESCAPE_SEQ,        // Escapes \t, \n, etc.
+  CMT_SINGLE,        // Single line comment: //
+  CMT_I,             // Escape multi-line comment (1)
+  CMT_II,            // Escape multi-line comment (2)
+  CMT_III,           // Escape multi-line comment (3)
+  COUNT
+};
+
+// Characters the lexer tells apart, all the others are unrecognized
+enum class CharClass : uint8_t {
+  OTHER,      // Anything not recognized
+  ALPHA,      // a-z, A-Z
+  UNDERSCORE, // _
+  DIGIT,      // 0-9
+  SPACE,      // ' ', \t, \v, \f, \r
+  NEWLINE,    // \n
+  QUOTE,      // "
+  BACKSLASH,  // \ (backslash)
+  EQ,         // =
+  GT,         // >
+  CMP,        // !, <
+  AMP,        // &
+  PIPE,       // |
+  PLUS,       // +
+  MINUS,      // -
+  SLASH,      // /
+  STAR,       // *
+  DOT,        // .
+  SIMPLE,     // (, ), {, }, ,, :, ;
+  EOF_BYTE,   // 0xff, that is char(-1)
+  COUNT
+};
+
+// What the lexer does upon reading a character, before it moves to the next state
+enum class LexerAction : uint8_t {
+  NONE,             // Just read the character
+  EMIT,             // Finish the token of a known type with the current character
+  EMIT_BACK,        // Finish the token of a known type before the current character
+  EMIT_OP,          // Finish the operator with the current character
+  EMIT_OP_BACK,     // Finish the operator before the current character
+  EMIT_IDENT,       // Finish the identifier (or keyword) before the current character
+  STRING_START,     // Start the string literal after the current character
+  STRING_ESCAPE,    // Remember that the string literal needs unescaping
+  SUFFIX,           // Remember what kind of number has an invalid suffix
+  INVALID,          // Fail with an invalid suffix
+  UNRECOGNIZED,     // Fail with an unrecognized character
+  UNTERMINATED_STR, // Fail with an unterminated string
+  UNCLOSED_CMT,     // Fail with an unclosed multi-line comment
+};
+
+struct Transition {
+  LexerState m_next{LexerState::START};
+  LexerAction m_action{LexerAction::NONE};
+  Basic::TType m_type{Basic::TType::TOK_INVALID};
+  std::string_view m_detail{};
+};
+
+constexpr auto kCharClass = [] {
+  std::array<CharClass, 256> table{};
+  for (int ch = 'a'; ch <= 'z'; ++ch) table[ch] = CharClass::ALPHA;
+  for (int ch = 'A'; ch <= 'Z'; ++ch) table[ch] = CharClass::ALPHA;
+  for (int ch = '0'; ch <= '9'; ++ch) table[ch] = CharClass::DIGIT;
+  for (const unsigned char ch : std::string_view{"(){},:;"}) table[ch] = CharClass::SIMPLE;
+  for (const unsigned char ch : std::string_view{" \t\v\f\r"}) table[ch] = CharClass::SPACE;
+  table['_']  = CharClass::UNDERSCORE;
+  table['\n'] = CharClass::NEWLINE;
+  table['"']  = CharClass::QUOTE;
+  table['\\'] = CharClass::BACKSLASH;
+  table['=']  = CharClass::EQ;
+  table['>']  = CharClass::GT;
+  table['!']  = CharClass::CMP;
+  table['<']  = CharClass::CMP;
+  table['&']  = CharClass::AMP;
+  table['|']  = CharClass::PIPE;
+  table['+']  = CharClass::PLUS;
+  table['-']  = CharClass::MINUS;
+  table['/']  = CharClass::SLASH;
+  table['*']  = CharClass::STAR;
+  table['.']  = CharClass::DOT;
+  table[0xff] = CharClass::EOF_BYTE;
+  return table;
+}();
+
+constexpr CharClass classOf(const char ch) { return kCharClass[static_cast<unsigned char>(ch)]; }
+
+constexpr bool isSpaceClass(const CharClass cls) { return cls == CharClass::SPACE || cls == CharClass::NEWLINE; }
+
+constexpr bool isIdentClass(const CharClass cls) {
+  return cls == CharClass::ALPHA || cls == CharClass::UNDERSCORE || cls == CharClass::DIGIT;
+}
+
+using TransitionTable =
+    std::array<std::array<Transition, static_cast<size_t>(CharClass::COUNT)>, static_cast<size_t>(LexerState::COUNT)>;
+
+// For every state tells what to do with the character of each class
+constexpr TransitionTable kTransitions = [] {
+  using enum LexerState;
+  using enum LexerAction;
+  using Basic::TType;
+  TransitionTable table{};
+  auto row = [&](const LexerState state) -> auto & { return table[static_cast<size_t>(state)]; };
+  auto fill = [&](const LexerState state, const Transition &tr) { row(state).fill(tr); };
+  auto set = [&](const LexerState state, const CharClass cls, const Transition &tr) {
+    row(state)[static_cast<size_t>(cls)] = tr;
+  };
+
+  // START
+  fill(START, {START, UNRECOGNIZED});
+  set(START, CharClass::ALPHA,      {IDENT});
+  set(START, CharClass::UNDERSCORE, {IDENT});
+  set(START, CharClass::DIGIT,      {INTEGER});
+  set(START, CharClass::SPACE,      {START});
+  set(START, CharClass::NEWLINE,    {START});
+  set(START, CharClass::QUOTE,      {STRING, STRING_START});
+  set(START, CharClass::EQ,         {OP_COMPARE});
+  set(START, CharClass::GT,         {OP_COMPARE});
+  set(START, CharClass::CMP,        {OP_COMPARE});
+  set(START, CharClass::AMP,        {LOGIC_AND});
+  set(START, CharClass::PIPE,       {LOGIC_OR});
+  set(START, CharClass::PLUS,       {OP_PP});
+  set(START, CharClass::MINUS,      {OP_MM});
+  set(START, CharClass::SLASH,      {CMT_I});
+  set(START, CharClass::STAR,       {START, EMIT_OP});
+  set(START, CharClass::DOT,        {START, EMIT_OP});
+  set(START, CharClass::SIMPLE,     {START, EMIT_OP});
+
+  // IDENT
+  fill(IDENT, {START, EMIT_IDENT});
+  set(IDENT, CharClass::ALPHA,      {IDENT});
+  set(IDENT, CharClass::UNDERSCORE, {IDENT});
+  set(IDENT, CharClass::DIGIT,      {IDENT});
+
+  // OP_COMPARE
+  fill(OP_COMPARE, {START, EMIT_OP_BACK});
+  set(OP_COMPARE, CharClass::EQ, {START, EMIT_OP});
+
+  // STRING
+  fill(STRING, {STRING});
+  set(STRING, CharClass::BACKSLASH, {ESCAPE_SEQ, STRING_ESCAPE});
+  set(STRING, CharClass::QUOTE,     {START, EMIT, TType::LIT_STR});
+  set(STRING, CharClass::EOF_BYTE,  {STRING, UNTERMINATED_STR});
+
+  // ESCAPE_SEQ: the escaped character is resolved once the string is finished
+  fill(ESCAPE_SEQ, {STRING});
+
+  // INTEGER
+  fill(INTEGER, {START, EMIT_BACK, TType::LIT_INT});
+  set(INTEGER, CharClass::DIGIT,   {INTEGER});
+  set(INTEGER, CharClass::DOT,     {FLOAT});
+  set(INTEGER, CharClass::ALPHA,   {ERRONEOUS_NUMBER, SUFFIX, TType::TOK_INVALID, "integer"});
+  set(INTEGER, CharClass::SPACE,   {START, EMIT, TType::LIT_INT});
+
+  // FLOAT
+  fill(FLOAT, {START, EMIT_BACK, TType::LIT_FLT});
+  set(FLOAT, CharClass::DIGIT,   {FLOAT});
+  set(FLOAT, CharClass::DOT,     {ERRONEOUS_NUMBER, SUFFIX, TType::TOK_INVALID, "float"});
+  set(FLOAT, CharClass::ALPHA,   {ERRONEOUS_NUMBER, SUFFIX, TType::TOK_INVALID, "float"});
+  set(FLOAT, CharClass::SPACE,   {START, EMIT, TType::LIT_FLT});
+
+  // ERRONEOUS_NUMBER
+  fill(ERRONEOUS_NUMBER, {ERRONEOUS_NUMBER});
+  set(ERRONEOUS_NUMBER, CharClass::SPACE,   {START, INVALID});
+  set(ERRONEOUS_NUMBER, CharClass::NEWLINE, {START, INVALID});
+
+  // LOGIC_AND, LOGIC_OR
+  fill(LOGIC_AND, {START, INVALID, TType::TOK_INVALID, "ampersand"});
+  set(LOGIC_AND, CharClass::AMP, {START, EMIT, TType::OP_AND});
+  fill(LOGIC_OR, {START, INVALID, TType::TOK_INVALID, "tilde"});
+  set(LOGIC_OR, CharClass::PIPE, {START, EMIT, TType::OP_OR});
+
+  // OP_PP, OP_MM
+  fill(OP_PP, {START, EMIT_BACK, TType::OP_ADD});
+  set(OP_PP, CharClass::PLUS, {START, EMIT, TType::OP_UADD});
+  fill(OP_MM, {START, EMIT_BACK, TType::OP_SUB});
+  set(OP_MM, CharClass::MINUS, {START, EMIT, TType::OP_USUB});
+  set(OP_MM, CharClass::GT,    {START, EMIT, TType::OP_FN_ARROW});
+
+  // CMT_SINGLE
+  fill(CMT_SINGLE, {CMT_SINGLE});
+  set(CMT_SINGLE, CharClass::NEWLINE, {START});
+
+  // CMT_I: it was either a comment, or just a division symbol
+  fill(CMT_I, {START, EMIT_BACK, TType::OP_DIV});
+  set(CMT_I, CharClass::STAR,  {CMT_II});
+  set(CMT_I, CharClass::SLASH, {CMT_SINGLE});
+
+  // CMT_II
+  fill(CMT_II, {CMT_II});
+  set(CMT_II, CharClass::STAR,     {CMT_III});
+  set(CMT_II, CharClass::EOF_BYTE, {CMT_II, UNCLOSED_CMT});
+
+  // CMT_III
+  fill(CMT_III, {CMT_II});
+  set(CMT_III, CharClass::SLASH,    {START});
+  set(CMT_III, CharClass::STAR,     {CMT_III});
+  set(CMT_III, CharClass::EOF_BYTE, {CMT_III, UNCLOSED_CMT});
+
+  return table;
+}();
+
+constexpr const Transition &transitionOf(const LexerState state, const CharClass cls) {
+  return kTransitions[static_cast<size_t>(state)][static_cast<size_t>(cls)];
+}
+
+}  // namespace Wisnia
+
+#endif  // WISNIALANG_LEXER_TABLES_HPP
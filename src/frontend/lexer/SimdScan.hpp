@@ -0,0 +1,122 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_SIMD_SCAN_HPP
+#define WISNIALANG_SIMD_SCAN_HPP
+
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+// Wisnia
+#include "LexerTables.hpp"
+
+// Fast paths for the lexer that skip over runs of characters the state machine would only stay
+// in the same state for. AVX2 is used if the compiler targets it, SSE2 (which every x86-64 CPU
+// has) otherwise, and a plain loop over the character class table on other architectures
+namespace Wisnia::Simd {
+
+#if defined(__AVX2__)
+using Vec = __m256i;
+constexpr size_t kWidth{32};
+inline Vec load(const char *ptr) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr)); }
+inline Vec splat(const char ch) { return _mm256_set1_epi8(ch); }
+inline Vec cmpEq(const Vec lhs, const Vec rhs) { return _mm256_cmpeq_epi8(lhs, rhs); }
+inline Vec cmpGt(const Vec lhs, const Vec rhs) { return _mm256_cmpgt_epi8(lhs, rhs); }
+inline Vec bitAnd(const Vec lhs, const Vec rhs) { return _mm256_and_si256(lhs, rhs); }
+inline Vec bitOr(const Vec lhs, const Vec rhs) { return _mm256_or_si256(lhs, rhs); }
+inline uint32_t toMask(const Vec vec) { return static_cast<uint32_t>(_mm256_movemask_epi8(vec)); }
+#elif defined(__SSE2__)
+using Vec = __m128i;
+constexpr size_t kWidth{16};
+inline Vec load(const char *ptr) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr)); }
+inline Vec splat(const char ch) { return _mm_set1_epi8(ch); }
+inline Vec cmpEq(const Vec lhs, const Vec rhs) { return _mm_cmpeq_epi8(lhs, rhs); }
+inline Vec cmpGt(const Vec lhs, const Vec rhs) { return _mm_cmpgt_epi8(lhs, rhs); }
+inline Vec bitAnd(const Vec lhs, const Vec rhs) { return _mm_and_si128(lhs, rhs); }
+inline Vec bitOr(const Vec lhs, const Vec rhs) { return _mm_or_si128(lhs, rhs); }
+inline uint32_t toMask(const Vec vec) { return static_cast<uint32_t>(_mm_movemask_epi8(vec)); }
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+constexpr uint32_t kFullMask{kWidth == 32 ? ~0u : (1u << kWidth) - 1};
+
+// Signed comparison, so bytes above 0x7f never fall into the range
+inline Vec inRange(const Vec vec, const char lo, const char hi) {
+  return bitAnd(cmpGt(vec, splat(static_cast<char>(lo - 1))), cmpGt(splat(static_cast<char>(hi + 1)), vec));
+}
+
+inline uint32_t identMask(const Vec vec) {
+  const Vec letters = bitOr(inRange(vec, 'a', 'z'), inRange(vec, 'A', 'Z'));
+  return toMask(bitOr(bitOr(letters, inRange(vec, '0', '9')), cmpEq(vec, splat('_'))));
+}
+
+inline uint32_t spaceMask(const Vec vec) { return toMask(bitOr(cmpEq(vec, splat(' ')), inRange(vec, '\t', '\r'))); }
+
+inline uint32_t newlineMask(const Vec vec) { return toMask(cmpEq(vec, splat('\n'))); }
+
+// Skips the characters as long as `keep` marks them
+template <typename Keep>
+size_t skipBlocks(const std::string_view data, size_t pos, Keep keep) {
+  while (pos + kWidth <= data.size()) {
+    const uint32_t stop = ~keep(load(data.data() + pos)) & kFullMask;
+    if (stop) {
+      return pos + std::countr_zero(stop);
+    }
+    pos += kWidth;
+  }
+  return pos;
+}
+#endif
+
+// Returns the position of the first character that can't be a part of an identifier
+inline size_t skipIdentifier(const std::string_view data, size_t pos) {
+#if defined(__AVX2__) || defined(__SSE2__)
+  pos = skipBlocks(data, pos, identMask);
+#endif
+  while (pos < data.size() && isIdentClass(classOf(data[pos]))) {
+    ++pos;
+  }
+  return pos;
+}
+
+// Returns the position of the first non-whitespace character
+inline size_t skipWhitespace(const std::string_view data, size_t pos) {
+#if defined(__AVX2__) || defined(__SSE2__)
+  pos = skipBlocks(data, pos, spaceMask);
+#endif
+  while (pos < data.size() && isSpaceClass(classOf(data[pos]))) {
+    ++pos;
+  }
+  return pos;
+}
+
+// Returns the position of the newline ending a single line comment
+inline size_t skipLineComment(const std::string_view data, size_t pos) {
+#if defined(__AVX2__) || defined(__SSE2__)
+  pos = skipBlocks(data, pos, [](const Vec vec) { return ~newlineMask(vec); });
+#endif
+  while (pos < data.size() && data[pos] != '\n') {
+    ++pos;
+  }
+  return pos;
+}
+
+// Returns the position of the first '*' (or the 0xff byte) in a multi-line comment
+inline size_t skipBlockComment(const std::string_view data, size_t pos) {
+#if defined(__AVX2__) || defined(__SSE2__)
+  pos = skipBlocks(data, pos, [](const Vec vec) {
+    return ~toMask(bitOr(cmpEq(vec, splat('*')), cmpEq(vec, splat(static_cast<char>(0xff)))));
+  });
+#endif
+  while (pos < data.size() && data[pos] != '*' && classOf(data[pos]) != CharClass::EOF_BYTE) {
+    ++pos;
+  }
+  return pos;
+}
+
+}  // namespace Wisnia::Simd
+
+#endif  // WISNIALANG_SIMD_SCAN_HPP
@@ -0,0 +1,53 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <iterator>
+// Wisnia
+#include "SourceBuffer.hpp"
+
+using namespace Wisnia;
+
+SourceBuffer::SourcePtr SourceBuffer::fromFile(std::string_view filename) {
+  std::shared_ptr<SourceBuffer> buffer{new SourceBuffer{}};
+  buffer->m_fileName = filename;
+
+  const int fd = ::open(buffer->m_fileName.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return buffer;
+  }
+
+  struct stat info {};
+  if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+    const auto size = static_cast<size_t>(info.st_size);
+    if (void *addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0); addr != MAP_FAILED) {
+      // The lexer walks the file front to back exactly once
+      ::madvise(addr, size, MADV_SEQUENTIAL);
+      buffer->m_data = static_cast<const char *>(addr);
+      buffer->m_size = size;
+      buffer->m_mapped = true;
+    }
+  }
+
+  // The mapping stays valid after the descriptor is closed
+  ::close(fd);
+  return buffer;
+}
+
+SourceBuffer::SourcePtr SourceBuffer::fromStream(std::istream &stream) {
+  std::shared_ptr<SourceBuffer> buffer{new SourceBuffer{}};
+  buffer->m_fileName = "in-memory";
+  buffer->m_storage = {std::istreambuf_iterator(stream), std::istreambuf_iterator<char>()};
+  buffer->m_data = buffer->m_storage.data();
+  buffer->m_size = buffer->m_storage.size();
+  return buffer;
+}
+
+SourceBuffer::~SourceBuffer() {
+  if (m_mapped) {
+    ::munmap(const_cast<char *>(m_data), m_size);
+  }
+}
@@ -0,0 +1,52 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_SOURCE_BUFFER_HPP
+#define WISNIALANG_SOURCE_BUFFER_HPP
+
+#include <istream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace Wisnia {
+
+// Read-only view of the source file contents. Files are memory-mapped and read in place,
+// while in-memory streams are copied once into an owned buffer. The buffer is shared, so
+// that the later compilation phases can keep the mapping alive for as long as they need it
+class SourceBuffer {
+ public:
+  using SourcePtr = std::shared_ptr<const SourceBuffer>;
+
+  // Maps the file into memory; an empty buffer is returned if the file can't be read
+  static SourcePtr fromFile(std::string_view filename);
+
+  // Copies the contents of the stream
+  static SourcePtr fromStream(std::istream &stream);
+
+  SourceBuffer(const SourceBuffer &) = delete;
+  SourceBuffer &operator=(const SourceBuffer &) = delete;
+  ~SourceBuffer();
+
+  std::string_view getData() const { return {m_data, m_size}; }
+  const std::string &getFileName() const { return m_fileName; }
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+  bool isMapped() const { return m_mapped; }
+
+  // Whether the data ends with a newline; if it doesn't, the lexer has to make one up
+  bool hasTrailingNewline() const { return m_size > 0 && m_data[m_size - 1] == '\n'; }
+
+ private:
+  SourceBuffer() = default;
+
+  const char *m_data{nullptr};
+  size_t m_size{0};
+  bool m_mapped{false};
+  std::string m_storage;
+  std::string m_fileName;
+};
+
+}  // namespace Wisnia
+
+#endif  // WISNIALANG_SOURCE_BUFFER_HPP
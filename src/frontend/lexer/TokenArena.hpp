@@ -0,0 +1,95 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_TOKEN_ARENA_HPP
+#define WISNIALANG_TOKEN_ARENA_HPP
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+// Wisnia
+#include "SourceBuffer.hpp"
+#include "Token.hpp"
+
+namespace Wisnia {
+
+// Plain token produced by the lexer. Its text points either into the source buffer or into
+// the string storage of the arena that owns it, so it never allocates on its own
+struct CompactToken {
+  Basic::TType m_type;
+  uint32_t m_offset;  // Where the token starts in the arena's source
+  const char *m_text;
+  uint32_t m_length;
+  union {
+    int32_t m_int;
+    float m_float;
+  };
+
+  std::string_view getText() const { return {m_text, m_length}; }
+
+  // Converts into the value the parser expects to find in `Basic::Token`
+  Basic::TokenValue getValue() const {
+    switch (m_type) {
+      case Basic::TType::LIT_INT:
+        return m_int;
+      case Basic::TType::LIT_FLT:
+        return m_float;
+      case Basic::TType::KW_TRUE:
+      case Basic::TType::KW_FALSE:
+        return m_type == Basic::TType::KW_TRUE;
+      default:
+        return std::string{getText()};
+    }
+  }
+};
+
+static_assert(std::is_trivially_copyable_v<CompactToken> && sizeof(CompactToken) <= 24);
+
+// Stores tokens contiguously, together with the source buffer and the strings their text
+// refers to
+class TokenArena {
+  using TokenPtr = std::shared_ptr<Basic::Token>;
+
+ public:
+  void setSource(SourceBuffer::SourcePtr source, const uint32_t fileId) {
+    m_source = std::move(source);
+    m_fileId = fileId;
+  }
+  const SourceBuffer::SourcePtr &getSource() const { return m_source; }
+  uint32_t getFileId() const { return m_fileId; }
+
+  void reserve(const size_t tokens) { m_tokens.reserve(tokens); }
+  void push(const CompactToken &token) { m_tokens.push_back(token); }
+
+  // Keeps text that can't be pointed to in the source buffer (e.g. unescaped strings)
+  std::string_view store(std::string text) { return m_strings.emplace_back(std::move(text)); }
+
+  const std::vector<CompactToken> &getTokens() const { return m_tokens; }
+  size_t size() const { return m_tokens.size(); }
+
+  // Drops the tokens (and the strings they refer to) once they are no longer needed
+  void clear() {
+    m_tokens.clear();
+    m_strings.clear();
+  }
+
+  // Builds a `Basic::Token` out of the compact one
+  TokenPtr materialize(const CompactToken &token) const {
+    return std::make_shared<Basic::Token>(token.m_type, token.getValue(), Basic::Position{{m_fileId, token.m_offset}});
+  }
+
+ private:
+  SourceBuffer::SourcePtr m_source;
+  uint32_t m_fileId{Basic::SourceLocation::kNoFile};
+  std::vector<CompactToken> m_tokens;
+  std::deque<std::string> m_strings;
+};
+
+}  // namespace Wisnia
+
+#endif  // WISNIALANG_TOKEN_ARENA_HPP
@@ -0,0 +1,123 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <optional>
+// Wisnia
+#include "ParallelParser.hpp"
+#include "AST.hpp"
+#include "Parser.hpp"
+
+using namespace Wisnia;
+
+ParallelParser::ParallelParser(SourceBuffer::SourcePtr source, const size_t threads)
+    : m_source{std::move(source)}, m_threads{std::max<size_t>(threads, 1)} {}
+
+std::vector<Lexer::Range> ParallelParser::split(const std::string_view data, const size_t chunks) {
+  const std::vector<Lexer::Range> whole{{0, data.size()}};
+  if (chunks <= 1) {
+    return whole;
+  }
+
+  const size_t chunkSize = std::max<size_t>(data.size() / chunks, 1);
+  std::vector<Lexer::Range> ranges{};
+  Lexer::Range current{};
+  size_t depth{0};
+
+  for (size_t i = 0; i < data.size(); ++i) {
+    switch (data[i]) {
+      case '"':
+        for (++i; i < data.size() && data[i] != '"'; ++i) {
+          if (data[i] == '\\') {
+            ++i;
+          }
+        }
+        if (i >= data.size()) {
+          return whole;
+        }
+        break;
+      case '/':
+        if (i + 1 < data.size() && data[i + 1] == '/') {
+          i = std::min(data.find('\n', i), data.size()) - 1;
+        } else if (i + 1 < data.size() && data[i + 1] == '*') {
+          const size_t end = data.find("*/", i + 2);
+          if (end == std::string_view::npos) {
+            return whole;
+          }
+          i = end + 1;
+        }
+        break;
+      case '{':
+        ++depth;
+        break;
+      case '}':
+        if (depth == 0) {
+          return whole;
+        }
+        if (--depth == 0 && i + 1 - current.m_begin >= chunkSize) {
+          current.m_end = i + 1;
+          ranges.push_back(current);
+          current = {i + 1, 0};
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  if (depth != 0) {
+    return whole;
+  }
+  current.m_end = data.size();
+  ranges.push_back(current);
+  return ranges;
+}
+
+std::unique_ptr<AST::Root> ParallelParser::parse() {
+  const auto ranges = split(m_source->getData(), m_threads * kChunksPerThread);
+  std::vector<std::unique_ptr<AST::Root>> roots(ranges.size());
+  std::vector<std::exception_ptr> errors(ranges.size());
+
+  // Nodes go into the node arena of the calling thread, if there's one. As arenas aren't shared
+  // between threads, every thread gets its own, which the calling thread's arena then takes over
+  AST::NodeArena *const arena = AST::NodeArena::current();
+  const size_t threads = std::min(m_threads, ranges.size());
+  std::vector<AST::NodeArena> arenas(arena ? threads : 0);
+
+  std::atomic<size_t> nextChunk{0};
+  auto work = [&](const size_t thread) {
+    std::optional<AST::NodeArena::Scope> scope{};
+    if (arena) {
+      scope.emplace(arenas[thread]);
+    }
+    for (size_t chunk = nextChunk++; chunk < ranges.size(); chunk = nextChunk++) {
+      try {
+        Lexer lexer{m_source, ranges[chunk], Lexer::Streaming{}};
+        Parser parser{lexer};
+        roots[chunk] = parser.parse();
+      } catch (...) {
+        errors[chunk] = std::current_exception();
+      }
+    }
+  };
+  {
+    std::vector<std::jthread> workers{};
+    for (size_t thread = 1; thread < threads; ++thread) {
+      workers.emplace_back(work, thread);
+    }
+    work(0);
+  }
+  for (auto &threadArena : arenas) {
+    arena->adopt(std::move(threadArena));
+  }
+
+  auto root = std::make_unique<AST::Root>();
+  for (size_t chunk = 0; chunk < ranges.size(); ++chunk) {
+    if (errors[chunk]) {
+      std::rethrow_exception(errors[chunk]);
+    }
+    root->append(std::move(*roots[chunk]));
+  }
+  return root;
+}
@@ -0,0 +1,45 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_PARALLEL_PARSER_HPP
+#define WISNIALANG_PARALLEL_PARSER_HPP
+
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+// Wisnia
+#include "Lexer.hpp"
+#include "SourceBuffer.hpp"
+
+namespace Wisnia {
+namespace AST {
+class Root;
+}  // namespace AST
+
+// Splits the source file into chunks of top-level definitions, which are then lexed and parsed
+// on separate threads and put back together into a single tree in the order of the source
+class ParallelParser {
+ public:
+  explicit ParallelParser(SourceBuffer::SourcePtr source, size_t threads = std::thread::hardware_concurrency());
+
+  // Starts parsing and returns the root node
+  // Should several chunks fail, the error of the one found first in the source is reported
+  std::unique_ptr<AST::Root> parse();
+
+  // Splits the source into at most `chunks` ranges that end right after a top-level `}`,
+  // telling strings and comments apart like the lexer does. If the braces don't add up,
+  // the source is left in one piece for the parser to report on
+  static std::vector<Lexer::Range> split(std::string_view data, size_t chunks);
+
+ private:
+  // Chunks per thread, so that the threads that happen to get the shorter chunks don't idle
+  static constexpr size_t kChunksPerThread{4};
+
+  SourceBuffer::SourcePtr m_source;
+  size_t m_threads;
+};
+
+}  // namespace Wisnia
+
+#endif  // WISNIALANG_PARALLEL_PARSER_HPP
@@ -13,16 +13,29 @@ using namespace Wisnia;
 using namespace AST;
 using namespace Basic;
 
-Parser::Parser(const Lexer &lexer)
-    : m_tokens{lexer.getTokens()} {}
+Parser::Parser(Lexer &lexer)
+    : m_lexer{lexer} {}
+
+const Parser::TokenPtr &Parser::at(const int pos) const {
+  assert(pos >= 0 && pos + static_cast<int>(m_window.size()) > m_pulled && "the token has left the window");
+  assert(pos <= m_pos + kLookahead && "looking too far ahead");
+  for (; m_pulled <= pos; ++m_pulled) {
+    m_window[m_pulled % m_window.size()] = m_lexer.next();
+  }
+  return m_window[pos % m_window.size()];
+}
+
+bool Parser::hasNext() const {
+  return m_pos < 0 || curr()->getType() != TType::TOK_EOF;
+}
 
 bool Parser::has(const TType &token) const {
   return peek()->getType() == token;
 }
 
 bool Parser::has2(const TType &token) const {
-  assert(m_pos + 2 < m_tokens.size());
-  return m_tokens[m_pos + 2]->getType() == token;
+  assert(hasNext());
+  return at(m_pos + 2)->getType() == token;
 }
 
 void Parser::expect(const TType &token) {
@@ -221,124 +234,75 @@ std::unique_ptr<BaseStmt> Parser::parseReturnStmt() {
   return returnStmt;
 }
 
-// <EXPRESSION> ::= <AND_EXPR> | <EXPRESSION> <OR_SYMB> <AND_EXPR>
-// <EXPRESSION> ::= <AND_EXPR> { <OR_SYMB> <AND_EXPR> }
-std::unique_ptr<BaseExpr> Parser::parseExpr() {
-  auto lhs = parseAndExpr();
-  while (has(TType::OP_OR)) {  // ... <OR_SYMB> <AND_EXPR>
-    const auto &token = peek();
-    consume();                 // eat "||"
-    auto rhs = parseAndExpr();
-    // Make a temporary copy of the lhs
-    auto tempLhs = std::unique_ptr(std::move(lhs));
-    // Move rhs and tempLhs nodes
-    lhs = std::make_unique<BooleanExpr>(token);
-    lhs->addChild(std::move(tempLhs));
-    lhs->addChild(std::move(rhs));
-  }
-  return lhs;
-}
-
-// <AND_EXPR> ::= <EQUAL_EXPR> | <AND_EXPR> <AND_SYMB> <EQUAL_EXPR>
-// <AND_EXPR> ::= <EQUAL_EXPR> { <AND_SYMB> <EQUAL_EXPR> }
-std::unique_ptr<BaseExpr> Parser::parseAndExpr() {
-  auto lhs = parseEqExpr();
-  while (has(TType::OP_AND)) {  // ... <AND_SYMB> <EQUAL_EXPR>
-    const auto &token = peek();
-    consume();                  // eat "&&"
-    auto rhs = parseEqExpr();
-    // Make a temporary copy of the lhs
-    auto tempLhs = std::unique_ptr(std::move(lhs));
-    // Move rhs and tempLhs nodes
-    lhs = std::make_unique<BooleanExpr>(token);
-    lhs->addChild(std::move(tempLhs));
-    lhs->addChild(std::move(rhs));
-  }
-  return lhs;
-}
-
-// <EQUAL_EXPR> ::= <COMPARE_EXPR> | <EQUAL_EXPR> <EQUALITY_SYMB> <COMPARE_EXPR>
-// <EQUAL_EXPR> ::= <COMPARE_EXPR> { <EQUALITY_SYMB> <COMPARE_EXPR> }
-std::unique_ptr<BaseExpr> Parser::parseEqExpr() {
-  auto lhs = parseCompExpr();
-  // ... <EQUALITY_SYMB> <COMPARE_EXPR>
-  while (hasAnyOf(TType::OP_EQ, TType::OP_NE)) {
-    const auto &token = peek();
-    consume(); // eat either "==" or "!="
-    auto rhs = parseCompExpr();
-    // Make a temporary copy of the lhs
-    auto tempLhs = std::unique_ptr(std::move(lhs));
-    // Move rhs and tempLhs nodes
-    lhs = std::make_unique<EqExpr>(token);
-    lhs->addChild(std::move(tempLhs));
-    lhs->addChild(std::move(rhs));
-  }
-  return lhs;
+namespace {
+using ExprPtr = std::unique_ptr<BaseExpr>;
+
+// A binary operator: how tightly it binds its operands, and the node it makes of them
+struct BinaryOperator {
+  int m_power{0};
+  ExprPtr (*m_make)(TokenPtr){nullptr};
+};
+
+template <typename Expr>
+ExprPtr makeBinaryExpr(TokenPtr token) {
+  return std::make_unique<Expr>(std::move(token));
 }
 
-// <COMPARE_EXPR> ::= <ADD_EXPR> | <COMPARE_EXPR> <COMPARISON_SYMB> <ADD_EXPR>
+// Binary operators by token type, all of them being left-associative
+//   <OR_SYMB>       ::= "||"
+//   <AND_SYMB>      ::= "&&"
+//   <EQUALITY_SYMB> ::= "==" | "!="
+//   <COMPARISON_SYMB> ::= ">" | ">=" | "<" | "<="
+//   <ADD_OP>        ::= "+" | "-"
+//   <MULT_OP>       ::= "*" | "/"
+constexpr auto kBinaryOperators = [] {
+  std::array<BinaryOperator, static_cast<size_t>(TType::TOK_EOF) + 1> table{};
+  auto set = [&](const TType type, const int power, ExprPtr (*make)(TokenPtr)) {
+    table[static_cast<size_t>(type)] = {power, make};
+  };
+  set(TType::OP_OR,  1, makeBinaryExpr<BooleanExpr>);
+  set(TType::OP_AND, 2, makeBinaryExpr<BooleanExpr>);
+  set(TType::OP_EQ,  3, makeBinaryExpr<EqExpr>);
+  set(TType::OP_NE,  3, makeBinaryExpr<EqExpr>);
+  set(TType::OP_G,   4, makeBinaryExpr<CompExpr>);
+  set(TType::OP_GE,  4, makeBinaryExpr<CompExpr>);
+  set(TType::OP_L,   4, makeBinaryExpr<CompExpr>);
+  set(TType::OP_LE,  4, makeBinaryExpr<CompExpr>);
+  set(TType::OP_ADD, 5, makeBinaryExpr<AddExpr>);
+  set(TType::OP_SUB, 5, makeBinaryExpr<SubExpr>);
+  set(TType::OP_MUL, 6, makeBinaryExpr<MultExpr>);
+  set(TType::OP_DIV, 6, makeBinaryExpr<DivExpr>);
+  return table;
+}();
+}  // namespace
+
+// <EXPRESSION>   ::= <AND_EXPR> { <OR_SYMB> <AND_EXPR> }
+// <AND_EXPR>     ::= <EQUAL_EXPR> { <AND_SYMB> <EQUAL_EXPR> }
+// <EQUAL_EXPR>   ::= <COMPARE_EXPR> { <EQUALITY_SYMB> <COMPARE_EXPR> }
 // <COMPARE_EXPR> ::= <ADD_EXPR> { <COMPARISON_SYMB> <ADD_EXPR> }
-std::unique_ptr<BaseExpr> Parser::parseCompExpr() {
-  auto lhs = parseAddExpr();
-  // ... <COMPARISON_SYMB> <ADD_EXPR>
-  while (hasAnyOf(TType::OP_G, TType::OP_GE, TType::OP_L, TType::OP_LE)) {
-    const auto &token = peek();
-    consume(); // eat any of ">", ">=", "<", "<="
-    auto rhs = parseAddExpr();
-    // Make a temporary copy of the lhs
-    auto tempLhs = std::unique_ptr(std::move(lhs));
-    // Move rhs and tempLhs nodes
-    lhs = std::make_unique<CompExpr>(token);
-    lhs->addChild(std::move(tempLhs));
-    lhs->addChild(std::move(rhs));
-  }
-  return lhs;
-}
-
-// <ADD_EXPR> ::= <MULT_EXPR> | <ADD_EXPR> <ADD_OP> <MULT_EXPR>
-// <ADD_EXPR> ::= <MULT_EXPR> { <ADD_OP> <MULT_EXPR> }
-std::unique_ptr<BaseExpr> Parser::parseAddExpr() {
-  auto lhs = parseMultExpr();
-  // ... <ADD_OP> <MULT_EXPR>
-  while (hasAnyOf(TType::OP_ADD, TType::OP_SUB)) {
-    const auto &token = peek();
-    consume(); // eat either "+" or "-"
-    auto rhs = parseMultExpr();
-    // Make a temporary copy of the lhs
-    auto tempLhs = std::unique_ptr(std::move(lhs));
-    // Move rhs and tempLhs nodes
-    if (token->getType() == TType::OP_ADD) {
-      lhs = std::make_unique<AddExpr>(token);
-    } else {
-      lhs = std::make_unique<SubExpr>(token);
-    }
-    lhs->addChild(std::move(tempLhs));
-    lhs->addChild(std::move(rhs));
-  }
-  return lhs;
+// <ADD_EXPR>     ::= <MULT_EXPR> { <ADD_OP> <MULT_EXPR> }
+// <MULT_EXPR>    ::= <UNARY_EXPR> { <MULT_OP> <UNARY_EXPR> }
+std::unique_ptr<BaseExpr> Parser::parseExpr() {
+  return parseBinaryExpr(0);
 }
 
-// <MULT_EXPR> ::= <UNARY_EXPR> | <MULT_EXPR> <MULT_OP> <UNARY_EXPR>
-// <MULT_EXPR> ::= <UNARY_EXPR> { <MULT_OP> <UNARY_EXPR> }
-std::unique_ptr<BaseExpr> Parser::parseMultExpr() {
+// Precedence climbing: keeps on taking the operators that bind tighter than `minPower`,
+// leaving the rest to the caller
+std::unique_ptr<BaseExpr> Parser::parseBinaryExpr(const int minPower) {
   auto lhs = parseUnaryExpr();
-  // ... <MULT_OP> <UNARY_EXPR>
-  while (hasAnyOf(TType::OP_MUL, TType::OP_DIV)) {
-    const auto &token = peek();
-    consume(); // eat either "*" or "/"
-    auto rhs = parseUnaryExpr();
-    // Make a temporary copy of the lhs
-    auto tempLhs = std::unique_ptr(std::move(lhs));
-    // Move rhs and tempLhs nodes
-    if (token->getType() == TType::OP_MUL) {
-      lhs = std::make_unique<MultExpr>(token);
-    } else {
-      lhs = std::make_unique<DivExpr>(token);
+  while (true) {
+    const auto &op = kBinaryOperators[static_cast<size_t>(peek()->getType())];
+    if (op.m_power <= minPower) {
+      return lhs;
     }
+    auto token = peek();
+    consume(); // eat the operator
+    auto rhs = parseBinaryExpr(op.m_power);
+    auto tempLhs = std::move(lhs);
+    lhs = op.m_make(std::move(token));
     lhs->addChild(std::move(tempLhs));
     lhs->addChild(std::move(rhs));
   }
-  return lhs;
 }
 
 // <UNARY_EXPR> ::= <SOME_EXPR> | <UNARY_SYM> <UNARY_EXPR>
@@ -350,7 +314,7 @@ std::unique_ptr<BaseExpr> Parser::parseUnaryExpr() {
   if (isAnyOf()) {
     auto lhs = std::unique_ptr<BaseExpr>();
     while (isAnyOf()) {  // <UNARY_SYM> ...
-      const auto &token = peek();
+      const auto token = peek();
       consume(); // eat "!", "++", or "--"
       auto rhs = parseUnaryExpr();
       // Append the unary expression we've just found
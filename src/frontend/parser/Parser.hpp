@@ -4,9 +4,10 @@
 #ifndef WISNIALANG_PARSER_HPP
 #define WISNIALANG_PARSER_HPP
 
+#include <array>
+#include <cassert>
 #include <memory>
 #include <vector>
-#include <cassert>
 
 namespace Wisnia {
 class Lexer;
@@ -32,7 +33,9 @@ class Parser {
   using TokenPtr = std::shared_ptr<Basic::Token>;
 
  public:
-  explicit Parser(const Lexer &lexer);
+  // Pulls tokens from the lexer as parsing goes, which works with both the batch and the
+  // streaming lexers
+  explicit Parser(Lexer &lexer);
 
   // Starts parsing and returns the root node
   std::unique_ptr<AST::Root> parse();
@@ -56,8 +59,8 @@ class Parser {
 
   // Returns an instance of the current token
   const TokenPtr &curr() const {
-    assert(m_pos < m_tokens.size());
-    return m_tokens[m_pos];
+    assert(m_pos >= 0);
+    return at(m_pos);
   }
 
   // Consumes and returns current token
@@ -65,23 +68,31 @@ class Parser {
   const TokenPtr &getNextToken() {
     assert(hasNext());
     consume();
-    return m_tokens[m_pos];
+    return curr();
   }
 
   // Returns an instance of the following token (peeks)
   const TokenPtr &peek() const {
     assert(hasNext());
-    return m_tokens[m_pos + 1];
+    return at(m_pos + 1);
   }
 
   // Consumes token (skips current token position by 1)
   void consume() { m_pos++; }
 
   // Checks if we haven't reached the end of token stream
-  bool hasNext() const { return m_pos + 1 < m_tokens.size(); }
+  bool hasNext() const;
+
+  // Returns the token at position `pos`, pulling the tokens up to it from the lexer
+  const TokenPtr &at(int pos) const;
+
+  // How many tokens past the current one can be looked at
+  static constexpr int kLookahead{3};
 
-  // Tokens stream copied from Lexer through constructor call
-  std::vector<TokenPtr> m_tokens;
+  // Ring buffer holding the current token and the ones looked ahead at
+  Lexer &m_lexer;
+  mutable std::array<TokenPtr, kLookahead + 1> m_window;
+  mutable int m_pulled{0};
 
  private:
   // Parses identifier
@@ -150,20 +161,8 @@ class Parser {
   // Parses expression -- start of the expression parsing
   std::unique_ptr<AST::BaseExpr> parseExpr();
 
-  // Parses logical AND (&&) expression
-  std::unique_ptr<AST::BaseExpr> parseAndExpr();
-
-  // Parses logical Equality (==, !=) expression
-  std::unique_ptr<AST::BaseExpr> parseEqExpr();
-
-  // Parses comparison (>, >=, <, <=) expression
-  std::unique_ptr<AST::BaseExpr> parseCompExpr();
-
-  // Parses addition and subtraction (+, -) expression
-  std::unique_ptr<AST::BaseExpr> parseAddExpr();
-
-  // Parses multiplication and division (*, /) expression
-  std::unique_ptr<AST::BaseExpr> parseMultExpr();
+  // Parses binary expressions whose operators bind tighter than `minPower`
+  std::unique_ptr<AST::BaseExpr> parseBinaryExpr(int minPower);
 
   // Parses unary (!, ++) expression
   std::unique_ptr<AST::BaseExpr> parseUnaryExpr();
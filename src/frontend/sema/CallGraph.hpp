@@ -0,0 +1,109 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_CALL_GRAPH_HPP
+#define WISNIALANG_CALL_GRAPH_HPP
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+// Wisnia
+#include "StringInterner.hpp"
+
+namespace Wisnia {
+namespace AST {
+class FnDef;
+}  // namespace AST
+
+// Functions of the program, in the order they're defined, and the calls between them. Functions
+// are found by their symbol, while the edges refer to functions by their index, so that walking
+// the graph doesn't need any hashing
+class CallGraph {
+ public:
+  using Index = size_t;
+
+  struct Function {
+    Basic::SymbolId m_symbol;
+    const AST::FnDef *m_definition;
+    // One edge per call site
+    std::vector<Index> m_callees{};
+    std::vector<Index> m_callers{};
+    // Calls made from outside of any function, e.g. in the initializers of class fields
+    size_t m_outsideCalls{0};
+
+    bool isCalled() const {
+      return !m_callers.empty() || m_outsideCalls > 0;
+    }
+  };
+
+  // Returns the index of the function, or nothing if a function with the same name is already
+  // defined, in which case the first definition stays
+  std::optional<Index> addFunction(const Basic::SymbolId symbol, const AST::FnDef *definition) {
+    const auto [it, inserted] = m_index.try_emplace(symbol, m_functions.size());
+    if (!inserted) {
+      return std::nullopt;
+    }
+    m_functions.push_back({symbol, definition});
+    return it->second;
+  }
+
+  void addCall(const std::optional<Index> caller, const Index callee) {
+    if (caller) {
+      m_functions[*caller].m_callees.push_back(callee);
+      m_functions[callee].m_callers.push_back(*caller);
+    } else {
+      m_functions[callee].m_outsideCalls++;
+    }
+  }
+
+  std::optional<Index> find(const Basic::SymbolId symbol) const {
+    if (const auto it = m_index.find(symbol); it != m_index.end()) {
+      return it->second;
+    }
+    return std::nullopt;
+  }
+
+  const Function &getFunction(const Index index) const {
+    return m_functions[index];
+  }
+
+  const std::vector<Function> &getFunctions() const {
+    return m_functions;
+  }
+
+  // Marks the functions that can be reached from `roots` by following the calls
+  std::vector<bool> findReachable(const std::vector<Index> &roots) const {
+    std::vector<bool> reachable(m_functions.size(), false);
+    std::vector<Index> pending{};
+    for (const auto root : roots) {
+      if (!reachable[root]) {
+        reachable[root] = true;
+        pending.push_back(root);
+      }
+    }
+    while (!pending.empty()) {
+      const Index caller = pending.back();
+      pending.pop_back();
+      for (const auto callee : m_functions[caller].m_callees) {
+        if (!reachable[callee]) {
+          reachable[callee] = true;
+          pending.push_back(callee);
+        }
+      }
+    }
+    return reachable;
+  }
+
+  void clear() {
+    m_functions.clear();
+    m_index.clear();
+  }
+
+ private:
+  std::vector<Function> m_functions;
+  std::unordered_map<Basic::SymbolId, Index> m_index;
+};
+
+}  // namespace Wisnia
+
+#endif  // WISNIALANG_CALL_GRAPH_HPP
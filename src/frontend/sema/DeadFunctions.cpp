@@ -0,0 +1,29 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+// Wisnia
+#include "DeadFunctions.hpp"
+#include "AST.hpp"
+
+using namespace Wisnia;
+using namespace AST;
+
+size_t Wisnia::eliminateDeadFunctions(Root &root, const CallGraph &graph) {
+  auto &interner = Basic::StringInterner::global();
+  std::vector<CallGraph::Index> roots{};
+  if (const auto main = graph.find(interner.intern("main"))) {
+    roots.push_back(*main);
+  }
+  for (CallGraph::Index index = 0; index < graph.getFunctions().size(); ++index) {
+    if (graph.getFunction(index).m_outsideCalls > 0) {
+      roots.push_back(index);
+    }
+  }
+
+  const auto reachable = graph.findReachable(roots);
+  return root.removeGlobalFunctions([&](const Root &function) {
+    const auto name = dynamic_cast<const FnDef &>(function).getVariable()->getToken()->getValue<std::string>();
+    const auto index = graph.find(interner.intern(name));
+    return index && !reachable[*index];
+  });
+}
@@ -0,0 +1,23 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#ifndef WISNIALANG_DEAD_FUNCTIONS_HPP
+#define WISNIALANG_DEAD_FUNCTIONS_HPP
+
+#include <cstddef>
+// Wisnia
+#include "CallGraph.hpp"
+
+namespace Wisnia {
+namespace AST {
+class Root;
+}  // namespace AST
+
+// Removes the global functions that no call made from `main`, or from outside of any function,
+// can lead to, so that no code is generated for them. Returns how many were removed
+// The call graph still lists the removed functions, which mustn't be looked into afterwards
+size_t eliminateDeadFunctions(AST::Root &root, const CallGraph &graph);
+
+}  // namespace Wisnia
+
+#endif  // WISNIALANG_DEAD_FUNCTIONS_HPP
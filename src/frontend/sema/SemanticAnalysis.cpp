@@ -3,7 +3,6 @@
 
 #include <algorithm>
 #include <iostream>
-#include <map>
 // Wisnia
 #include "AST.hpp"
 #include "SemanticAnalysis.hpp"
@@ -12,79 +11,96 @@ using namespace Wisnia;
 using namespace Basic;
 using namespace AST;
 
-struct Parameter {
-  std::string name;
-  TType type;
-};
-
-struct Function {
-  std::string name;
-  std::vector<Parameter> parameters;
-};
-
-struct ProgramSemanticChecks {
-  bool mainFunctionFound{false};
-  std::vector<Function> functionDefinitions;
-  std::vector<std::string> invokedFunctions;
-
-  void clear() {
-    mainFunctionFound = false;
-    functionDefinitions.clear();
-    invokedFunctions.clear();
-  }
-} programChecks;
-
-struct FunctionSemanticChecks {
-  enum class ReturnType {
-    NOT_FOUND,
-    NONE,
-    INT,
-    FLOAT,
-    STRING,
-    BOOLEAN
-  };
-
-  void clear() {
-    returnFound = false;
-    returnType = ReturnType::NOT_FOUND;
+namespace {
+[[noreturn]] void rejectSpecialMethod(const char *what, const Token &name) {
+  throw NotImplementedError{fmt::format("{} are not supported in {}:{}",
+                                        what,
+                                        name.getPosition().getFileName(),
+                                        name.getPosition().getLineNo())};
+}
+}  // namespace
+
+void SemanticAnalysis::beginProgram() {
+  m_callGraph.clear();
+  m_currentFunction.reset();
+  m_redefinedFunctions.clear();
+  m_mainFunctionFound = false;
+}
+
+void SemanticAnalysis::defineFunction(const FnDef &node) {
+  const auto &name = *node.getVariable()->getToken();
+  const auto functionName = name.getValue<std::string>();
+  if (functionName == "main") {
+    m_mainFunctionFound = true;
   }
 
-  bool returnFound{false};
-  ReturnType returnType{ReturnType::NOT_FOUND};
-} functionChecks;
+  const SymbolId symbol = StringInterner::global().intern(functionName);
+  if (const auto index = m_callGraph.addFunction(symbol, &node)) {
+    m_currentFunction = index;
+  } else {
+    m_currentFunction = m_callGraph.find(symbol);
+    m_redefinedFunctions.push_back(symbol);
+  }
+}
 
-void SemanticAnalysis::visit(Root &node) {
-  programChecks.clear();
+void SemanticAnalysis::checkReturning(const Token &name) const {
+  if (name.getType() != TType::IDENT_VOID && !m_functionChecks.returnFound) {
+    throw SemanticError{fmt::format("Non-void function '{}' is not returning in {}:{}",
+                                    name.getValue<std::string>(),
+                                    name.getPosition().getFileName(),
+                                    name.getPosition().getLineNo())};
+  }
+}
 
-  for (const auto &klass : node.getGlobalClasses()) {
-    klass->accept(*this);
+void SemanticAnalysis::checkFunctionCall(const Token &name, const size_t arguments) {
+  const auto functionName = name.getValue<std::string>();
+  const auto callee = m_callGraph.find(StringInterner::global().intern(functionName));
+  if (!callee) {
+    throw SemanticError{fmt::format("Failed to find function '{}' definition", functionName)};
   }
-  for (const auto &function : node.getGlobalFunctions()) {
-    functionChecks.clear();
-    function->accept(*this);
+  m_callGraph.addCall(m_currentFunction, *callee);
+
+  const auto &parameters = m_callGraph.getFunction(*callee).m_definition->getParameters();
+  if (arguments != parameters.size()) {
+    throw SemanticError{fmt::format("Function '{}' expects {} arguments but {} were provided in {}:{}",
+                                    functionName,
+                                    parameters.size(),
+                                    arguments,
+                                    name.getPosition().getFileName(),
+                                    name.getPosition().getLineNo())};
   }
+}
 
-  if (!programChecks.mainFunctionFound) {
+void SemanticAnalysis::checkProgram() const {
+  if (!m_mainFunctionFound) {
     throw SemanticError{"Function `main` not found"};
   }
 
-  for (const auto &[name, _] : programChecks.functionDefinitions) {
-    auto it = std::find(programChecks.invokedFunctions.begin(), programChecks.invokedFunctions.end(), name);
-    if (name != "main" && it == programChecks.invokedFunctions.end()) {
+  for (const auto &function : m_callGraph.getFunctions()) {
+    const auto name = StringInterner::global().lookup(function.m_symbol);
+    if (name != "main" && !function.isCalled()) {
       std::cout << fmt::format("[Warning] Function '{}' is defined but never used\n", name);
     }
   }
 
-  std::map<std::string, size_t> functionOccurrenceMap;
-  for (const auto &[name, _] : programChecks.functionDefinitions) {
-    functionOccurrenceMap[name]++;
+  if (!m_redefinedFunctions.empty()) {
+    throw SemanticError{fmt::format("Found multiple definitions for `{}` function",
+                                    StringInterner::global().lookup(m_redefinedFunctions.front()))};
   }
+}
 
-  for (const auto &[function, count] : functionOccurrenceMap) {
-    if (count > 1) {
-      throw SemanticError{fmt::format("Found multiple definitions for `{}` function", function)};
-    }
+void SemanticAnalysis::visit(Root &node) {
+  beginProgram();
+
+  for (const auto &klass : node.getGlobalClasses()) {
+    klass->accept(*this);
   }
+  for (const auto &function : node.getGlobalFunctions()) {
+    m_functionChecks.clear();
+    function->accept(*this);
+  }
+
+  checkProgram();
 }
 
 void SemanticAnalysis::visit(PrimitiveType &) {
@@ -93,7 +109,7 @@ void SemanticAnalysis::visit(PrimitiveType &) {
 
 void SemanticAnalysis::visit(VarExpr &node) {
   const auto *foundVar = m_table.findSymbol(node.getToken()->getValue<std::string>()); // VarExpr
-  node.addType(std::make_unique<PrimitiveType>(foundVar->getType()->getToken()));
+  node.shareType(foundVar->getType());
 }
 
 void SemanticAnalysis::visit(BooleanExpr &node) {
@@ -136,24 +152,7 @@ void SemanticAnalysis::visit(UnaryExpr &node) {
 }
 
 void SemanticAnalysis::visit(FnCallExpr &node) {
-  const auto functionName = node.getVariable()->getToken()->getValue<std::string>();
-  programChecks.invokedFunctions.emplace_back(functionName);
-
-  const auto fnDefinition = std::find_if(
-    programChecks.functionDefinitions.begin(), programChecks.functionDefinitions.end(),
-    [&](const auto &function) { return function.name == functionName; });
-  if (fnDefinition == programChecks.functionDefinitions.end()) {
-    throw SemanticError{fmt::format("Failed to find function '{}' definition", functionName)};
-  }
-
-  if (node.getArguments().size() != fnDefinition->parameters.size()) {
-    throw SemanticError{fmt::format("Function '{}' expects {} arguments but {} were provided in {}:{}",
-                                    fnDefinition->name,
-                                    fnDefinition->parameters.size(),
-                                    node.getArguments().size(),
-                                    node.getVariable()->getToken()->getPosition().getFileName(),
-                                    node.getVariable()->getToken()->getPosition().getLineNo())};
-  }
+  checkFunctionCall(*node.getVariable()->getToken(), node.getArguments().size());
 
   node.getVariable()->accept(*this);
   for (const auto &arg : node.getArguments()) {
@@ -193,7 +192,7 @@ void SemanticAnalysis::visit(StmtBlock &node) {
 }
 
 void SemanticAnalysis::visit(ReturnStmt &node) {
-  functionChecks.returnFound = true;
+  m_functionChecks.returnFound = true;
   node.getReturnValue()->accept(*this);
 }
 
@@ -238,23 +237,8 @@ void SemanticAnalysis::visit(Param &node) {
 }
 
 void SemanticAnalysis::visit(FnDef &node) {
-  const auto functionName = node.getVariable()->getToken()->getValue<std::string>();
-  if (functionName == "main") {
-    programChecks.mainFunctionFound = true;
-  }
-
-  std::vector<Parameter> parameters;
-  std::transform(node.getParameters().begin(), node.getParameters().end(), std::back_inserter(parameters), [](const auto &param) {
-    return Parameter {
-      param->getToken()->template getValue<std::string>(),
-      param->getToken()->getType()
-    };
-  });
-
-  programChecks.functionDefinitions.emplace_back(Function{
-    .name = functionName,
-    .parameters = std::move(parameters)
-  });
+  const auto enclosingFunction = m_currentFunction;
+  defineFunction(node);
 
   m_table.addSymbol(dynamic_cast<VarExpr *>(node.getVariable().get()));
   node.getVariable()->accept(*this);
@@ -263,24 +247,16 @@ void SemanticAnalysis::visit(FnDef &node) {
   }
   node.getBody()->accept(*this);
 
-  if (node.getVariable()->getToken()->getType() != TType::IDENT_VOID && !functionChecks.returnFound) {
-    throw SemanticError{fmt::format("Non-void function '{}' is not returning in {}:{}",
-                                    functionName,
-                                    node.getVariable()->getToken()->getPosition().getFileName(),
-                                    node.getVariable()->getToken()->getPosition().getLineNo())};
-  }
+  checkReturning(*node.getVariable()->getToken());
+  m_currentFunction = enclosingFunction;
 }
 
 void SemanticAnalysis::visit(CtorDef &node) {
-  throw NotImplementedError{fmt::format("Constructors are not supported in {}:{}",
-                                        node.getVariable()->getToken()->getPosition().getFileName(),
-                                        node.getVariable()->getToken()->getPosition().getLineNo())};
+  rejectSpecialMethod("Constructors", *node.getVariable()->getToken());
 }
 
 void SemanticAnalysis::visit(DtorDef &node) {
-  throw NotImplementedError{fmt::format("Destructors are not supported in {}:{}",
-                                        node.getVariable()->getToken()->getPosition().getFileName(),
-                                        node.getVariable()->getToken()->getPosition().getLineNo())};
+  rejectSpecialMethod("Destructors", *node.getVariable()->getToken());
 }
 
 void SemanticAnalysis::visit(Field &node) {
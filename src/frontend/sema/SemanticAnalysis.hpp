@@ -4,7 +4,10 @@
 #ifndef WISNIALANG_SEMANTIC_ANALYSIS_HPP
 #define WISNIALANG_SEMANTIC_ANALYSIS_HPP
 
+#include <optional>
+#include <vector>
 // Wisnia
+#include "CallGraph.hpp"
 #include "SymbolTable.hpp"
 #include "Visitor.hpp"
 
@@ -13,6 +16,13 @@ namespace Wisnia {
 constexpr auto kMaxIntValue{2147483647}; // mov rax, 0x7fffffff --> 48 c7 c0 | ff ff ff 7f
 
 class SemanticAnalysis final : public Visitor {
+ public:
+  // The functions of the program analyzed last and the calls between them
+  const CallGraph &getCallGraph() const {
+    return m_callGraph;
+  }
+
+ private:
   void visit(AST::Root &) override;
   void visit(AST::PrimitiveType &) override;
   void visit(AST::VarExpr &) override;
@@ -52,8 +62,38 @@ class SemanticAnalysis final : public Visitor {
   void visit(AST::ElseStmt &) override;
   void visit(AST::ElseIfStmt &) override;
 
- private:
+  void beginProgram();
+  void defineFunction(const AST::FnDef &node);
+  void checkReturning(const Basic::Token &name) const;
+  void checkFunctionCall(const Basic::Token &name, size_t arguments);
+  void checkProgram() const;
+
+  struct FunctionChecks {
+    enum class ReturnType {
+      NOT_FOUND,
+      NONE,
+      INT,
+      FLOAT,
+      STRING,
+      BOOLEAN
+    };
+
+    void clear() {
+      returnFound = false;
+      returnType = ReturnType::NOT_FOUND;
+    }
+
+    bool returnFound{false};
+    ReturnType returnType{ReturnType::NOT_FOUND};
+  };
+
   SymbolTable m_table;
+  CallGraph m_callGraph;
+  // The function whose body is being analyzed, if any
+  std::optional<CallGraph::Index> m_currentFunction;
+  std::vector<Basic::SymbolId> m_redefinedFunctions;
+  bool m_mainFunctionFound{false};
+  FunctionChecks m_functionChecks;
 };
 
 }  // namespace Wisnia
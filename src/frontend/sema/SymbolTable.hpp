@@ -5,61 +5,69 @@
 #define WISNIALANG_SYMBOL_TABLE_HPP
 
 #include <string>
-#include <memory>
-#include <unordered_map>
+#include <vector>
 #include <fmt/format.h>
 // Wisnia
 #include "AST.hpp"
 #include "Exceptions.hpp"
+#include "StringInterner.hpp"
 
 namespace Wisnia {
 namespace AST {
 class VarExpr;
 }  // namespace AST
 
+// Binds names to the variables declared under them. Every symbol has a slot holding the binding
+// currently in effect, so a lookup is a single index. A declaration records the binding it
+// shadows on a stack, which is unwound back to the scope's mark once the scope ends
 class SymbolTable {
  public:
-  SymbolTable() : m_table(std::make_unique<ScopedSymbolTable>()) {}
+  void addSymbol(const AST::VarExpr *var) {
+    addSymbol(Basic::StringInterner::global().intern(var->getToken()->getValue<std::string>()), var);
+  }
 
-  void addSymbol(const AST::VarExpr *var) const {
-    m_table->addSymbol(var->getToken()->getValue<std::string>(), var);
+  void addSymbol(const Basic::SymbolId symbol, const AST::VarExpr *var) {
+    if (symbol >= m_bindings.size()) {
+      m_bindings.resize(symbol + 1, nullptr);
+    }
+    m_shadowed.push_back({symbol, m_bindings[symbol]});
+    m_bindings[symbol] = var;
   }
 
   const AST::VarExpr *findSymbol(const std::string &name) const {
-    return m_table->findSymbol(name);
+    if (const auto symbol = Basic::StringInterner::global().find(name)) {
+      if (const auto *var = findSymbol(*symbol)) {
+        return var;
+      }
+    }
+    throw SemanticError{fmt::format("Name `{}` is not known in the current scope", name)};
+  }
+
+  // Returns nullptr if no variable is bound to the symbol
+  const AST::VarExpr *findSymbol(const Basic::SymbolId symbol) const {
+    return symbol < m_bindings.size() ? m_bindings[symbol] : nullptr;
   }
 
   void pushScope() {
-    auto tmp = std::make_unique<ScopedSymbolTable>();
-    tmp->m_parentScope = std::move(m_table);
-    m_table = std::move(tmp);
+    m_scopes.push_back(m_shadowed.size());
   }
 
   void popScope() {
-    m_table = std::move(m_table->m_parentScope);
+    for (size_t mark = m_scopes.back(); m_shadowed.size() > mark; m_shadowed.pop_back()) {
+      m_bindings[m_shadowed.back().m_symbol] = m_shadowed.back().m_previous;
+    }
+    m_scopes.pop_back();
   }
 
  private:
-  struct ScopedSymbolTable {
-    std::unordered_map<std::string, const AST::VarExpr *> m_info;
-    std::unique_ptr<ScopedSymbolTable> m_parentScope;
-
-    void addSymbol(const std::string &name, const AST::VarExpr *var) {
-      m_info[name] = var;
-    }
-
-    const AST::VarExpr *findSymbol(const std::string &name) const {
-      if (const auto it = m_info.find(name); it != m_info.end()) {
-        return it->second;
-      }
-      if (m_parentScope) {
-        return m_parentScope->findSymbol(name);
-      }
-      throw SemanticError{fmt::format("Name `{}` is not known in the current scope", name)};
-    }
+  struct Shadowed {
+    Basic::SymbolId m_symbol;
+    const AST::VarExpr *m_previous;
   };
 
-  std::unique_ptr<ScopedSymbolTable> m_table;
+  std::vector<const AST::VarExpr *> m_bindings;
+  std::vector<Shadowed> m_shadowed;
+  std::vector<size_t> m_scopes;
 };
 
 }  // namespace Wisnia
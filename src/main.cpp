@@ -6,12 +6,15 @@
 // Wisnia
 #include "AST.hpp"
 #include "CodeGenerator.hpp"
+#include "DeadFunctions.hpp"
 #include "ELF.hpp"
 #include "Exceptions.hpp"
 #include "IRGenerator.hpp"
 #include "Lexer.hpp"
+#include "ParallelParser.hpp"
 #include "Parser.hpp"
 #include "SemanticAnalysis.hpp"
+#include "SourceManager.hpp"
 
 using namespace Wisnia;
 using namespace lyra;
@@ -31,6 +34,9 @@ int main(int argc, char *argv[]) {
   struct Config {
     std::string file;
     std::string dump;
+    bool keepDeadFunctions{false};
+    bool optimize{false};
+    bool verbose{false};
   } config;
 
   auto cli = help(show_help)
@@ -41,6 +47,19 @@ int main(int argc, char *argv[]) {
       .name("--dump")
       .help("Dump information.")
       .choices("tokens", "ast", "ir", "code"));
+  cli.add_argument(
+    opt(config.keepDeadFunctions)
+      .name("--keep-dead-functions")
+      .help("Generate code for the functions that can't be reached from main."));
+  cli.add_argument(
+    opt(config.optimize)
+      .name("-O2")
+      .help("Allocate registers by graph coloring, which is slower but removes most of the moves."));
+  cli.add_argument(
+    opt(config.verbose)
+      .name("-v")
+      .name("--verbose")
+      .help("Report what the optimizations did."));
 
   const auto result = cli.parse({ argc, argv });
 
@@ -69,18 +88,35 @@ int main(int argc, char *argv[]) {
   }
 
   try {
-    Lexer lexer{config.file};
-    Parser parser{lexer};
-    const auto &root = parser.parse();
+    // Tokens are only kept around when they are about to be dumped, otherwise the top-level
+    // definitions are lexed and parsed in parallel
+    // All the nodes are freed at once, after the tree is gone
+    AST::NodeArena arena{};
+    AST::NodeArena::Scope arenaScope{arena};
+    Basic::SourceManager::Scope sourceScope{};
+    std::unique_ptr<AST::Root> root{};
     if (config.dump == "tokens") {
+      Lexer lexer{config.file};
+      Parser parser{lexer};
+      root = parser.parse();
       lexer.print(std::cout);
+    } else {
+      ParallelParser parser{SourceBuffer::fromFile(config.file)};
+      root = parser.parse();
     }
     SemanticAnalysis analysis{};
     root->accept(analysis);
     if (config.dump == "ast") {
       root->print(std::cout);
     }
-    IRGenerator irGenerator{};
+    if (!config.keepDeadFunctions) {
+      const size_t eliminated = eliminateDeadFunctions(*root, analysis.getCallGraph());
+      if (config.verbose) {
+        std::cout << fmt::format("Eliminated {} dead function(s)\n", eliminated);
+      }
+    }
+    IRGenerator irGenerator{true, config.optimize ? RegisterAllocator::Algorithm::GRAPH_COLORING
+                                                  : RegisterAllocator::Algorithm::LINEAR_SCAN};
     root->accept(irGenerator);
     if (config.dump == "ir") {
       irGenerator.printInstructions(std::cout, IRGenerator::Transformation::INSTRUCTION_OPTIMIZATION);
@@ -0,0 +1,152 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <gtest/gtest.h>
+#include <ranges>
+// Wisnia
+#include "AST.hpp"
+#include "ControlFlowGraph.hpp"
+#include "DominatorTree.hpp"
+#include "IRGenerator.hpp"
+#include "Lexer.hpp"
+#include "Liveness.hpp"
+#include "Modules.hpp"
+#include "Parser.hpp"
+#include "SemanticAnalysis.hpp"
+
+using namespace Wisnia;
+using namespace std::literals;
+
+class ControlFlowGraphTestFixture : public testing::Test {
+ protected:
+  void SetUp(std::string_view program) {
+    std::istringstream iss{program.data()};
+    Lexer lexer{iss};
+    Parser parser{lexer};
+    const auto &root = parser.parse();
+    root->accept(m_analysis);
+    root->accept(m_generator);
+  }
+
+  void TearDown() override {
+    Modules::markAllAsUnused();
+  }
+
+  const std::vector<Instruction> &getInstructions() const {
+    return m_generator.getInstructions(IRGenerator::Transformation::NONE);
+  }
+
+  // The first variable with the name
+  VirtualRegister variable(std::string_view name) const {
+    for (const auto &instruction : getInstructions()) {
+      if (const auto target = instruction.getTarget();
+          target.isIdentifierType() && m_generator.getVirtualRegisters().getName(target.getVirtualRegister()) == name) {
+        return target.getVirtualRegister();
+      }
+    }
+    ADD_FAILURE() << "No variable " << name;
+    return {};
+  }
+
+ protected:
+  IRGenerator m_generator{false};
+
+ private:
+  SemanticAnalysis m_analysis{};
+};
+
+using ControlFlowGraphTest = ControlFlowGraphTestFixture;
+
+TEST_F(ControlFlowGraphTest, StraightLineCodeIsASingleBlock) {
+  constexpr auto program = R"(
+  fn main() {
+    int a = 5 + 2;
+    print(a);
+  })"sv;
+  SetUp(program);
+  const ControlFlowGraph graph{getInstructions()};
+  const DominatorTree dominators{graph};
+
+  ASSERT_EQ(graph.getBlocks().size(), 1);
+  EXPECT_EQ(graph.getBlock(0).m_begin, 0);
+  EXPECT_EQ(graph.getBlock(0).m_end, getInstructions().size());
+  EXPECT_TRUE(graph.getBlock(0).m_successors.empty());
+  EXPECT_FALSE(dominators.getImmediateDominator(0).has_value());
+  EXPECT_TRUE(dominators.dominates(0, 0));
+}
+
+TEST_F(ControlFlowGraphTest, WhileLoop) {
+  constexpr auto program = R"(
+  fn main() {
+    int i = 0;
+    while (i < 3) {
+      i = i + 1;
+    }
+    print(i);
+  })"sv;
+  SetUp(program);
+  const ControlFlowGraph graph{getInstructions()};
+  const DominatorTree dominators{graph};
+
+  //  0: entry  ... jmp check
+  //  1: body   i = i + 1
+  //  2: check  cmp i, 3; jl body
+  //  3: end    print(i)
+  ASSERT_EQ(graph.getBlocks().size(), 4);
+  EXPECT_EQ(graph.getBlock(0).m_successors, (std::vector<size_t>{2}));
+  EXPECT_EQ(graph.getBlock(1).m_successors, (std::vector<size_t>{2}));
+  EXPECT_EQ(graph.getBlock(2).m_successors, (std::vector<size_t>{1, 3}));
+  EXPECT_EQ(graph.getBlock(2).m_predecessors, (std::vector<size_t>{0, 1}));
+  EXPECT_TRUE(graph.getBlock(3).m_successors.empty());
+  EXPECT_EQ(graph.getReversePostorder(), (std::vector<size_t>{0, 2, 3, 1}));
+  EXPECT_FALSE(graph.isCriticalEdge(0, 2));
+  EXPECT_FALSE(graph.isCriticalEdge(2, 1));
+
+  EXPECT_EQ(dominators.getImmediateDominator(1), 2);
+  EXPECT_EQ(dominators.getImmediateDominator(2), 0);
+  EXPECT_EQ(dominators.getImmediateDominator(3), 2);
+  EXPECT_TRUE(dominators.dominates(2, 1));
+  EXPECT_FALSE(dominators.dominates(1, 2));
+  EXPECT_FALSE(dominators.dominates(1, 3));
+  // The loop's definitions meet the ones from before it at the check
+  EXPECT_EQ(dominators.getFrontier(0), (std::vector<size_t>{}));
+  EXPECT_EQ(dominators.getFrontier(1), (std::vector<size_t>{2}));
+  EXPECT_EQ(dominators.getFrontier(2), (std::vector<size_t>{2}));
+
+  // `i` is carried around the loop, and is still needed after it
+  const Liveness liveness{graph, getInstructions()};
+  const auto i = variable("i");
+  EXPECT_TRUE(liveness.isLiveOut(0, i));
+  EXPECT_TRUE(liveness.isLiveIn(1, i));
+  EXPECT_TRUE(liveness.isLiveOut(1, i));
+  EXPECT_TRUE(liveness.isLiveIn(3, i));
+  EXPECT_FALSE(liveness.isLiveOut(3, i));
+  EXPECT_FALSE(liveness.isLiveIn(0, i));
+}
+
+TEST_F(ControlFlowGraphTest, CodeAfterBreakCantBeReached) {
+  constexpr auto program = R"(
+  fn main() {
+    int i = 0;
+    while (i < 10) {
+      if (i == 5) {
+        break;
+      }
+      i = i + 1;
+    }
+  })"sv;
+  SetUp(program);
+  const ControlFlowGraph graph{getInstructions()};
+  const DominatorTree dominators{graph};
+
+  // The jump to the end of the if statement comes right after the break
+  const auto &blocks = graph.getBlocks();
+  const auto unreachable = std::ranges::count_if(std::views::iota(size_t{0}, blocks.size()), [&](const auto block) {
+    return !graph.isReachable(block);
+  });
+  EXPECT_EQ(unreachable, 1);
+  EXPECT_EQ(graph.getReversePostorder().size(), blocks.size() - 1);
+  for (size_t block = 1; block < blocks.size(); block++) {
+    EXPECT_EQ(dominators.getImmediateDominator(block).has_value(), graph.isReachable(block)) << block;
+  }
+}
@@ -0,0 +1,215 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <gtest/gtest.h>
+#include <set>
+// Wisnia
+#include "Instruction.hpp"
+#include "SSAForm.hpp"
+#include "VirtualRegisters.hpp"
+
+using namespace Wisnia;
+using namespace Basic;
+
+class SSAFormTestFixture : public testing::Test {
+ protected:
+  Operand variable(std::string_view name) {
+    return Operand{TType::IDENT_INT, m_registers.createVariable(StringInterner::global().intern(name))};
+  }
+
+  std::string name(const Operand &operand) const {
+    return m_registers.getName(operand.getVirtualRegister());
+  }
+
+  static Operand label(std::string_view name) {
+    return Operand{TType::IDENT_VOID, name};
+  }
+
+  static Operand number(const int value) {
+    return Operand{TType::LIT_INT, value};
+  }
+
+  // Each virtual register is written by a single phi function or instruction
+  static void expectSingleDefinitions(const SSAForm &ssa) {
+    std::set<VirtualRegister> defined{};
+    for (const auto &block : ssa.getBlocks()) {
+      for (const auto &phi : block.m_phis) {
+        EXPECT_TRUE(defined.insert(phi.m_target.getVirtualRegister()).second);
+      }
+      for (const auto &instruction : block.m_instructions) {
+        for (size_t i = 0; i < Instruction::kOperands; i++) {
+          const auto operand = instruction.getOperand(i);
+          if (operand.isIdentifierType() && instruction.isDefinition(i) && !instruction.isUse(i)) {
+            EXPECT_TRUE(defined.insert(operand.getVirtualRegister()).second);
+          }
+        }
+      }
+    }
+  }
+
+  VirtualRegisters m_registers{};
+};
+
+using SSAFormTest = SSAFormTestFixture;
+
+TEST_F(SSAFormTest, StraightLineCodeNeedsNoPhis) {
+  const auto a = variable("a");
+  const std::vector instructions{
+    Instruction{Operation::MOV, a, number(1)},
+    Instruction{Operation::IADD, a, number(2)},
+    Instruction{Operation::PUSH, Operand{}, a},
+    Instruction{Operation::MOV, a, number(3)},
+    Instruction{Operation::PUSH, Operand{}, a},
+    Instruction{Operation::RET},
+  };
+  const SSAForm ssa{instructions, m_registers};
+  expectSingleDefinitions(ssa);
+
+  ASSERT_EQ(ssa.getBlocks().size(), 1);
+  const auto &block = ssa.getBlocks()[0];
+  EXPECT_TRUE(block.m_phis.empty());
+  // Updating `a` in place keeps its version, while writing it anew doesn't
+  EXPECT_EQ(name(block.m_instructions[1].getTarget()), "a");
+  EXPECT_EQ(name(block.m_instructions[2].getArg1()), "a");
+  EXPECT_EQ(name(block.m_instructions[3].getTarget()), "a.1");
+  EXPECT_EQ(name(block.m_instructions[4].getArg1()), "a.1");
+
+  size_t labels{0};
+  EXPECT_EQ(ssa.destruct(labels).size(), instructions.size());
+  EXPECT_EQ(labels, 0);
+}
+
+TEST_F(SSAFormTest, LoopCounter) {
+  //  0: entry  i = 0; jmp check
+  //  1: body   i = i + 1
+  //  2: check  cmp i, 3; jl body
+  //  3: end    push i
+  const auto i = variable("i");
+  const auto t = variable("t");
+  const std::vector instructions{
+    Instruction{Operation::MOV, i, number(0)},
+    Instruction{Operation::JMP, Operand{}, label(".check")},
+    Instruction{Operation::LABEL, Operand{}, label(".body")},
+    Instruction{Operation::MOV, t, i},
+    Instruction{Operation::IADD, t, number(1)},
+    Instruction{Operation::MOV, i, t},
+    Instruction{Operation::LABEL, Operand{}, label(".check")},
+    Instruction{Operation::CMP, Operand{}, i, number(3)},
+    Instruction{Operation::JL, Operand{}, label(".body")},
+    Instruction{Operation::PUSH, Operand{}, i},
+    Instruction{Operation::RET},
+  };
+  const SSAForm ssa{instructions, m_registers};
+  expectSingleDefinitions(ssa);
+
+  const auto &blocks = ssa.getBlocks();
+  ASSERT_EQ(blocks.size(), 4);
+  EXPECT_TRUE(blocks[0].m_phis.empty());
+  EXPECT_TRUE(blocks[1].m_phis.empty());
+  EXPECT_TRUE(blocks[3].m_phis.empty());
+
+  // `t` never leaves the loop's body, so only `i` needs a phi function
+  ASSERT_EQ(blocks[2].m_phis.size(), 1);
+  const auto &phi = blocks[2].m_phis[0];
+  EXPECT_EQ(name(phi.m_target), "i.1");
+  ASSERT_EQ(phi.m_arguments.size(), 2);
+  EXPECT_EQ(name(phi.m_arguments[0]), "i");   // from the entry
+  EXPECT_EQ(name(phi.m_arguments[1]), "i.2"); // from the body
+  EXPECT_EQ(name(blocks[1].m_instructions[1].getArg1()), "i.1");
+  EXPECT_EQ(name(blocks[1].m_instructions[3].getTarget()), "i.2");
+  EXPECT_EQ(name(blocks[2].m_instructions[1].getArg1()), "i.1");
+  EXPECT_EQ(name(blocks[3].m_instructions[0].getArg1()), "i.1");
+
+  // The copies go before the jumps into the check, and the body falls through to it
+  size_t labels{0};
+  const auto output = ssa.destruct(labels);
+  ASSERT_EQ(output.size(), instructions.size() + 2);
+  EXPECT_EQ(output[1].getOperation(), Operation::MOV);
+  EXPECT_EQ(name(output[1].getTarget()), "i.1");
+  EXPECT_EQ(name(output[1].getArg1()), "i");
+  EXPECT_EQ(output[2].getOperation(), Operation::JMP);
+  EXPECT_EQ(output[7].getOperation(), Operation::MOV);
+  EXPECT_EQ(name(output[7].getTarget()), "i.1");
+  EXPECT_EQ(name(output[7].getArg1()), "i.2");
+  EXPECT_EQ(output[8].getOperation(), Operation::LABEL);
+  EXPECT_EQ(labels, 0);
+}
+
+TEST_F(SSAFormTest, CriticalEdgesAreSplit) {
+  //  0: x = 1; cmp x, 0; je join   <- critical edge to the join
+  //  1: x = 2
+  //  2: join: push x
+  const auto x = variable("x");
+  const std::vector instructions{
+    Instruction{Operation::MOV, x, number(1)},
+    Instruction{Operation::CMP, Operand{}, x, number(0)},
+    Instruction{Operation::JE, Operand{}, label(".join")},
+    Instruction{Operation::MOV, x, number(2)},
+    Instruction{Operation::LABEL, Operand{}, label(".join")},
+    Instruction{Operation::PUSH, Operand{}, x},
+    Instruction{Operation::RET},
+  };
+  const SSAForm ssa{instructions, m_registers};
+  expectSingleDefinitions(ssa);
+  EXPECT_TRUE(ssa.getGraph().isCriticalEdge(0, 2));
+
+  const auto &blocks = ssa.getBlocks();
+  ASSERT_EQ(blocks[2].m_phis.size(), 1);
+  const auto &phi = blocks[2].m_phis[0];
+  EXPECT_EQ(name(phi.m_target), "x.2");
+  EXPECT_EQ(name(phi.m_arguments[0]), "x");
+  EXPECT_EQ(name(phi.m_arguments[1]), "x.1");
+
+  size_t labels{4};
+  const auto output = ssa.destruct(labels);
+  EXPECT_EQ(labels, 5);
+  ASSERT_EQ(output.size(), instructions.size() + 4);
+  // The jump is redirected to a block after the function, which makes the copy
+  EXPECT_EQ(output[2].getOperation(), Operation::JE);
+  EXPECT_EQ(output[2].getArg1(), label(".L5_split"));
+  EXPECT_EQ(name(output[4].getTarget()), "x.2");
+  EXPECT_EQ(name(output[4].getArg1()), "x.1");
+  EXPECT_EQ(output[5].getOperation(), Operation::LABEL);
+  EXPECT_EQ(output[8].getOperation(), Operation::LABEL);
+  EXPECT_EQ(output[8].getArg1(), label(".L5_split"));
+  EXPECT_EQ(name(output[9].getTarget()), "x.2");
+  EXPECT_EQ(name(output[9].getArg1()), "x");
+  EXPECT_EQ(output[10].getOperation(), Operation::JMP);
+  EXPECT_EQ(output[10].getArg1(), label(".join"));
+}
+
+TEST_F(SSAFormTest, CriticalFallThroughEdgeGetsCopiesAfterTheJump) {
+  //  0: x = 1; cmp x, 0; je other
+  //  1: x = 2; jmp join
+  //  2: other: cmp x, 1; jne after  <- falls through to the join over a critical edge
+  //  3: join: push x
+  //  4: after: ret
+  const auto x = variable("x");
+  const std::vector instructions{
+    Instruction{Operation::MOV, x, number(1)},
+    Instruction{Operation::CMP, Operand{}, x, number(0)},
+    Instruction{Operation::JE, Operand{}, label(".other")},
+    Instruction{Operation::MOV, x, number(2)},
+    Instruction{Operation::JMP, Operand{}, label(".join")},
+    Instruction{Operation::LABEL, Operand{}, label(".other")},
+    Instruction{Operation::CMP, Operand{}, x, number(1)},
+    Instruction{Operation::JNE, Operand{}, label(".after")},
+    Instruction{Operation::LABEL, Operand{}, label(".join")},
+    Instruction{Operation::PUSH, Operand{}, x},
+    Instruction{Operation::LABEL, Operand{}, label(".after")},
+    Instruction{Operation::RET},
+  };
+  const SSAForm ssa{instructions, m_registers};
+  expectSingleDefinitions(ssa);
+  EXPECT_TRUE(ssa.getGraph().isCriticalEdge(2, 3));
+
+  size_t labels{0};
+  const auto output = ssa.destruct(labels);
+  EXPECT_EQ(labels, 0);
+  // other: cmp x, 1; jne after; x.2 <- x; join: ...
+  ASSERT_EQ(output.size(), instructions.size() + 2);
+  EXPECT_EQ(output[8].getOperation(), Operation::JNE);
+  EXPECT_EQ(output[9].getOperation(), Operation::MOV);
+  EXPECT_EQ(name(output[9].getArg1()), "x");
+  EXPECT_EQ(output[10].getOperation(), Operation::LABEL);
+}
@@ -45,34 +45,33 @@ TEST_F(IRGeneratorTestWithRegisterAllocation, InstructionsShouldBeOptimized) {
     print((1 + 2) * 3);
   })"sv;
   SetUp(program.data());
-  const auto &unoptimizedInstructions = m_generator.getInstructions(IRGenerator::Transformation::NONE);
+  const auto &generatedInstructions   = m_generator.getInstructions(IRGenerator::Transformation::NONE);
+  const auto &unoptimizedInstructions = m_generator.getInstructions(IRGenerator::Transformation::REGISTER_ALLOCATION);
   const auto &optimizedInstructions   = m_generator.getInstructions(IRGenerator::Transformation::INSTRUCTION_OPTIMIZATION);
 
   // since we add extra instructions from `_print_number_` module
-  EXPECT_LT(unoptimizedInstructions.size(), optimizedInstructions.size());
+  EXPECT_LT(generatedInstructions.size(), optimizedInstructions.size());
+  EXPECT_EQ(unoptimizedInstructions.size(), optimizedInstructions.size() + 1);
 
-  // `rax <- rax`
-  EXPECT_EQ(unoptimizedInstructions[2]->getOperation(), Operation::MOV);
-  EXPECT_EQ(unoptimizedInstructions[2]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(unoptimizedInstructions[2]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(unoptimizedInstructions[2]->getTarget()->getValue<Basic::register_t>(),
-            unoptimizedInstructions[2]->getArg1()->getValue<Basic::register_t>());
+  // the product is computed right in `rdi`, which passes it to `_print_number_`
+  EXPECT_EQ(unoptimizedInstructions[3].getOperation(), Operation::IMUL);
+  EXPECT_EQ(unoptimizedInstructions[3].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(unoptimizedInstructions[3].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(unoptimizedInstructions[3].getTarget().getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(unoptimizedInstructions[3].getArg1().getValue<int>(), 3);
 
-  // `rax <- rax` has been optimized out, so should not be present anymore
+  // `rdi <- rdi`
+  EXPECT_EQ(unoptimizedInstructions[4].getOperation(), Operation::MOV);
+  EXPECT_EQ(unoptimizedInstructions[4].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(unoptimizedInstructions[4].getArg1().getType(), TType::REGISTER);
+  EXPECT_EQ(unoptimizedInstructions[4].getTarget().getValue<Basic::register_t>(),
+            unoptimizedInstructions[4].getArg1().getValue<Basic::register_t>());
 
-  // the following unoptimized instruction should contain IR for `rax * 3`
-  EXPECT_EQ(unoptimizedInstructions[3]->getOperation(), Operation::IMUL);
-  EXPECT_EQ(unoptimizedInstructions[3]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(unoptimizedInstructions[3]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(unoptimizedInstructions[3]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  EXPECT_EQ(unoptimizedInstructions[3]->getArg1()->getValue<int>(), 3);
+  // `rdi <- rdi` has been optimized out, so should not be present anymore
 
-  // in its old place (`rax <- rax`) now should stand IR for `rax * 3`
-  EXPECT_EQ(optimizedInstructions[2]->getOperation(), Operation::IMUL);
-  EXPECT_EQ(optimizedInstructions[2]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(optimizedInstructions[2]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(optimizedInstructions[2]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  EXPECT_EQ(optimizedInstructions[2]->getArg1()->getValue<int>(), 3);
+  // in its old place (`rdi <- rdi`) now should stand the call to `_print_number_`
+  EXPECT_EQ(optimizedInstructions[4].getOperation(), Operation::CALL);
+  EXPECT_EQ(optimizedInstructions[4].getTarget().getValue<std::string>(), "__builtin_print_number");
 }
 
 TEST_F(IRGeneratorTestWithRegisterAllocation, PrintNumberLiteralShouldNotInsertModules) {
@@ -83,103 +82,55 @@ TEST_F(IRGeneratorTestWithRegisterAllocation, PrintNumberLiteralShouldNotInsertM
   SetUp(program.data());
   const auto &instructions = m_generator.getInstructions(IRGenerator::Transformation::INSTRUCTION_OPTIMIZATION);
 
-  EXPECT_EQ(instructions.size(), 22);
-  // push rdx
-  EXPECT_EQ(instructions[0]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[0]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[0]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDX);
-  // push rsi
-  EXPECT_EQ(instructions[1]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[1]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[1]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RSI);
+  EXPECT_EQ(instructions.size(), 10);
   // mov rdx, 5
-  EXPECT_EQ(instructions[2]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[2]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[2]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RDX);
-  EXPECT_EQ(instructions[2]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[2]->getArg1()->getValue<int>(), 5);
+  EXPECT_EQ(instructions[0].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[0].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[0].getTarget().getValue<Basic::register_t>(), Basic::register_t::RDX);
+  EXPECT_EQ(instructions[0].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[0].getArg1().getValue<int>(), 5);
   // mov rsi, "12345"
-  EXPECT_EQ(instructions[3]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[3]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[3]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RSI);
-  EXPECT_EQ(instructions[3]->getArg1()->getType(), TType::LIT_STR);
-  EXPECT_STREQ(instructions[3]->getArg1()->getValue<std::string>().c_str(), "12345");
-  // push rax
-  EXPECT_EQ(instructions[4]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[4]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[4]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  // push rcx
-  EXPECT_EQ(instructions[5]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[5]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[5]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RCX);
-  // push r11
-  EXPECT_EQ(instructions[6]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[6]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[6]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::R11);
-  // push rdi
-  EXPECT_EQ(instructions[7]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[7]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[7]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[1].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[1].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[1].getTarget().getValue<Basic::register_t>(), Basic::register_t::RSI);
+  EXPECT_EQ(instructions[1].getArg1().getType(), TType::LIT_STR);
+  EXPECT_STREQ(instructions[1].getArg1().getValue<std::string>().c_str(), "12345");
   // mov rax, 1
-  EXPECT_EQ(instructions[8]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[8]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[8]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  EXPECT_EQ(instructions[8]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[8]->getArg1()->getValue<int>(), 1);
+  EXPECT_EQ(instructions[2].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[2].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[2].getTarget().getValue<Basic::register_t>(), Basic::register_t::RAX);
+  EXPECT_EQ(instructions[2].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[2].getArg1().getValue<int>(), 1);
   // mov rdi, 1
-  EXPECT_EQ(instructions[9]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[9]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[9]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RDI);
-  EXPECT_EQ(instructions[9]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[9]->getArg1()->getValue<int>(), 1);
+  EXPECT_EQ(instructions[3].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[3].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[3].getTarget().getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[3].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[3].getArg1().getValue<int>(), 1);
   // syscall
-  EXPECT_EQ(instructions[10]->getOperation(), Operation::SYSCALL);
-  // pop rdi
-  EXPECT_EQ(instructions[11]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[11]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[11]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDI);
-  // pop r11
-  EXPECT_EQ(instructions[12]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[12]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[12]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::R11);
-  // pop rcx
-  EXPECT_EQ(instructions[13]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[13]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[13]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RCX);
-  // pop rax
-  EXPECT_EQ(instructions[14]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[14]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[14]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  // pop rsi
-  EXPECT_EQ(instructions[15]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[15]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[15]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RSI);
-  // pop rdx
-  EXPECT_EQ(instructions[16]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[16]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[16]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDX);
+  EXPECT_EQ(instructions[4].getOperation(), Operation::SYSCALL);
   // call __builtin_exit
-  EXPECT_EQ(instructions[17]->getOperation(), Operation::CALL);
-  EXPECT_EQ(instructions[17]->getTarget()->getType(), TType::IDENT_VOID);
-  EXPECT_STREQ(instructions[17]->getTarget()->getValue<std::string>().c_str(), "__builtin_exit");
+  EXPECT_EQ(instructions[5].getOperation(), Operation::CALL);
+  EXPECT_EQ(instructions[5].getTarget().getType(), TType::IDENT_VOID);
+  EXPECT_STREQ(instructions[5].getTarget().getValue<std::string>().c_str(), "__builtin_exit");
   // label __builtin_exit
-  EXPECT_EQ(instructions[18]->getOperation(), Operation::LABEL);
-  EXPECT_EQ(instructions[18]->getArg1()->getType(), TType::IDENT_VOID);
-  EXPECT_STREQ(instructions[18]->getArg1()->getValue<std::string>().c_str(), "__builtin_exit");
+  EXPECT_EQ(instructions[6].getOperation(), Operation::LABEL);
+  EXPECT_EQ(instructions[6].getArg1().getType(), TType::IDENT_VOID);
+  EXPECT_STREQ(instructions[6].getArg1().getValue<std::string>().c_str(), "__builtin_exit");
   // xor rdi, rdi
-  EXPECT_EQ(instructions[19]->getOperation(), Operation::XOR);
-  EXPECT_EQ(instructions[19]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[19]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDI);
-  EXPECT_EQ(instructions[19]->getArg2()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[19]->getArg2()->getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[7].getOperation(), Operation::XOR);
+  EXPECT_EQ(instructions[7].getArg1().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[7].getArg1().getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[7].getArg2().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[7].getArg2().getValue<Basic::register_t>(), Basic::register_t::RDI);
   // mov rax, 60
-  EXPECT_EQ(instructions[20]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[20]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[20]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  EXPECT_EQ(instructions[20]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[20]->getArg1()->getValue<int>(), 60);
+  EXPECT_EQ(instructions[8].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[8].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[8].getTarget().getValue<Basic::register_t>(), Basic::register_t::RAX);
+  EXPECT_EQ(instructions[8].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[8].getArg1().getValue<int>(), 60);
   // syscall
-  EXPECT_EQ(instructions[21]->getOperation(), Operation::SYSCALL);
+  EXPECT_EQ(instructions[9].getOperation(), Operation::SYSCALL);
 }
 
 TEST_F(IRGeneratorTestWithRegisterAllocation, PrintStringLiteralShouldNotInsertModules) {
@@ -190,103 +141,55 @@ TEST_F(IRGeneratorTestWithRegisterAllocation, PrintStringLiteralShouldNotInsertM
   SetUp(program.data());
   const auto &instructions = m_generator.getInstructions(IRGenerator::Transformation::INSTRUCTION_OPTIMIZATION);
 
-  EXPECT_EQ(instructions.size(), 22);
-  // push rdx
-  EXPECT_EQ(instructions[0]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[0]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[0]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDX);
-  // push rsi
-  EXPECT_EQ(instructions[1]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[1]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[1]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RSI);
+  EXPECT_EQ(instructions.size(), 10);
   // mov rdx, 5
-  EXPECT_EQ(instructions[2]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[2]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[2]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RDX);
-  EXPECT_EQ(instructions[2]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[2]->getArg1()->getValue<int>(), 5);
+  EXPECT_EQ(instructions[0].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[0].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[0].getTarget().getValue<Basic::register_t>(), Basic::register_t::RDX);
+  EXPECT_EQ(instructions[0].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[0].getArg1().getValue<int>(), 5);
   // mov rsi, "12345"
-  EXPECT_EQ(instructions[3]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[3]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[3]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RSI);
-  EXPECT_EQ(instructions[3]->getArg1()->getType(), TType::LIT_STR);
-  EXPECT_STREQ(instructions[3]->getArg1()->getValue<std::string>().c_str(), "haiii");
-  // push rax
-  EXPECT_EQ(instructions[4]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[4]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[4]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  // push rcx
-  EXPECT_EQ(instructions[5]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[5]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[5]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RCX);
-  // push r11
-  EXPECT_EQ(instructions[6]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[6]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[6]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::R11);
-  // push rdi
-  EXPECT_EQ(instructions[7]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[7]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[7]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[1].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[1].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[1].getTarget().getValue<Basic::register_t>(), Basic::register_t::RSI);
+  EXPECT_EQ(instructions[1].getArg1().getType(), TType::LIT_STR);
+  EXPECT_STREQ(instructions[1].getArg1().getValue<std::string>().c_str(), "haiii");
   // mov rax, 1
-  EXPECT_EQ(instructions[8]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[8]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[8]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  EXPECT_EQ(instructions[8]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[8]->getArg1()->getValue<int>(), 1);
+  EXPECT_EQ(instructions[2].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[2].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[2].getTarget().getValue<Basic::register_t>(), Basic::register_t::RAX);
+  EXPECT_EQ(instructions[2].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[2].getArg1().getValue<int>(), 1);
   // mov rdi, 1
-  EXPECT_EQ(instructions[9]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[9]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[9]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RDI);
-  EXPECT_EQ(instructions[9]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[9]->getArg1()->getValue<int>(), 1);
+  EXPECT_EQ(instructions[3].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[3].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[3].getTarget().getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[3].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[3].getArg1().getValue<int>(), 1);
   // syscall
-  EXPECT_EQ(instructions[10]->getOperation(), Operation::SYSCALL);
-  // pop rdi
-  EXPECT_EQ(instructions[11]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[11]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[11]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDI);
-  // pop r11
-  EXPECT_EQ(instructions[12]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[12]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[12]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::R11);
-  // pop rcx
-  EXPECT_EQ(instructions[13]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[13]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[13]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RCX);
-  // pop rax
-  EXPECT_EQ(instructions[14]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[14]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[14]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  // pop rsi
-  EXPECT_EQ(instructions[15]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[15]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[15]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RSI);
-  // pop rdx
-  EXPECT_EQ(instructions[16]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[16]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[16]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDX);
+  EXPECT_EQ(instructions[4].getOperation(), Operation::SYSCALL);
   // call __builtin_exit
-  EXPECT_EQ(instructions[17]->getOperation(), Operation::CALL);
-  EXPECT_EQ(instructions[17]->getTarget()->getType(), TType::IDENT_VOID);
-  EXPECT_STREQ(instructions[17]->getTarget()->getValue<std::string>().c_str(), "__builtin_exit");
+  EXPECT_EQ(instructions[5].getOperation(), Operation::CALL);
+  EXPECT_EQ(instructions[5].getTarget().getType(), TType::IDENT_VOID);
+  EXPECT_STREQ(instructions[5].getTarget().getValue<std::string>().c_str(), "__builtin_exit");
   // label __builtin_exit
-  EXPECT_EQ(instructions[18]->getOperation(), Operation::LABEL);
-  EXPECT_EQ(instructions[18]->getArg1()->getType(), TType::IDENT_VOID);
-  EXPECT_STREQ(instructions[18]->getArg1()->getValue<std::string>().c_str(), "__builtin_exit");
+  EXPECT_EQ(instructions[6].getOperation(), Operation::LABEL);
+  EXPECT_EQ(instructions[6].getArg1().getType(), TType::IDENT_VOID);
+  EXPECT_STREQ(instructions[6].getArg1().getValue<std::string>().c_str(), "__builtin_exit");
   // xor rdi, rdi
-  EXPECT_EQ(instructions[19]->getOperation(), Operation::XOR);
-  EXPECT_EQ(instructions[19]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[19]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDI);
-  EXPECT_EQ(instructions[19]->getArg2()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[19]->getArg2()->getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[7].getOperation(), Operation::XOR);
+  EXPECT_EQ(instructions[7].getArg1().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[7].getArg1().getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[7].getArg2().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[7].getArg2().getValue<Basic::register_t>(), Basic::register_t::RDI);
   // mov rax, 60
-  EXPECT_EQ(instructions[20]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[20]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[20]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  EXPECT_EQ(instructions[20]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[20]->getArg1()->getValue<int>(), 60);
+  EXPECT_EQ(instructions[8].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[8].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[8].getTarget().getValue<Basic::register_t>(), Basic::register_t::RAX);
+  EXPECT_EQ(instructions[8].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[8].getArg1().getValue<int>(), 60);
   // syscall
-  EXPECT_EQ(instructions[21]->getOperation(), Operation::SYSCALL);
+  EXPECT_EQ(instructions[9].getOperation(), Operation::SYSCALL);
 }
 
 TEST_F(IRGeneratorTestWithRegisterAllocation, PrintBooleanLiteralShouldNotInsertModules) {
@@ -297,175 +200,101 @@ TEST_F(IRGeneratorTestWithRegisterAllocation, PrintBooleanLiteralShouldNotInsert
   SetUp(program.data());
   const auto &instructions = m_generator.getInstructions(IRGenerator::Transformation::INSTRUCTION_OPTIMIZATION);
 
-  EXPECT_EQ(instructions.size(), 39);
-  // push rdx
-  EXPECT_EQ(instructions[0]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[0]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[0]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDX);
-  // push rsi
-  EXPECT_EQ(instructions[1]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[1]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[1]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RSI);
+  EXPECT_EQ(instructions.size(), 15);
   // mov rdx, 4
-  EXPECT_EQ(instructions[2]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[2]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[2]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RDX);
-  EXPECT_EQ(instructions[2]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[2]->getArg1()->getValue<int>(), 4);
+  EXPECT_EQ(instructions[0].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[0].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[0].getTarget().getValue<Basic::register_t>(), Basic::register_t::RDX);
+  EXPECT_EQ(instructions[0].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[0].getArg1().getValue<int>(), 4);
   // mov rsi, "true"
-  EXPECT_EQ(instructions[3]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[3]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[3]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RSI);
-  EXPECT_EQ(instructions[3]->getArg1()->getType(), TType::LIT_STR);
-  EXPECT_STREQ(instructions[3]->getArg1()->getValue<std::string>().c_str(), "true");
-  // push rax
-  EXPECT_EQ(instructions[4]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[4]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[4]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  // push rcx
-  EXPECT_EQ(instructions[5]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[5]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[5]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RCX);
-  // push r11
-  EXPECT_EQ(instructions[6]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[6]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[6]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::R11);
-  // push rdi
-  EXPECT_EQ(instructions[7]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[7]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[7]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[1].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[1].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[1].getTarget().getValue<Basic::register_t>(), Basic::register_t::RSI);
+  EXPECT_EQ(instructions[1].getArg1().getType(), TType::LIT_STR);
+  EXPECT_STREQ(instructions[1].getArg1().getValue<std::string>().c_str(), "true");
   // mov rax, 1
-  EXPECT_EQ(instructions[8]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[8]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[8]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  EXPECT_EQ(instructions[8]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[8]->getArg1()->getValue<int>(), 1);
+  EXPECT_EQ(instructions[2].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[2].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[2].getTarget().getValue<Basic::register_t>(), Basic::register_t::RAX);
+  EXPECT_EQ(instructions[2].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[2].getArg1().getValue<int>(), 1);
   // mov rdi, 1
-  EXPECT_EQ(instructions[9]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[9]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[9]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RDI);
-  EXPECT_EQ(instructions[9]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[9]->getArg1()->getValue<int>(), 1);
+  EXPECT_EQ(instructions[3].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[3].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[3].getTarget().getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[3].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[3].getArg1().getValue<int>(), 1);
   // syscall
-  EXPECT_EQ(instructions[10]->getOperation(), Operation::SYSCALL);
-  // pop rdi
-  EXPECT_EQ(instructions[11]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[11]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[11]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDI);
-  // pop r11
-  EXPECT_EQ(instructions[12]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[12]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[12]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::R11);
-  // pop rcx
-  EXPECT_EQ(instructions[13]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[13]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[13]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RCX);
-  // pop rax
-  EXPECT_EQ(instructions[14]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[14]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[14]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  // pop rsi
-  EXPECT_EQ(instructions[15]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[15]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[15]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RSI);
-  // pop rdx
-  EXPECT_EQ(instructions[16]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[16]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[16]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDX);
-  // push rdx
-  EXPECT_EQ(instructions[17]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[17]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[17]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDX);
-  // push rsi
-  EXPECT_EQ(instructions[18]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[18]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[18]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RSI);
+  EXPECT_EQ(instructions[4].getOperation(), Operation::SYSCALL);
   // mov rdx, 5
-  EXPECT_EQ(instructions[19]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[19]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[19]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RDX);
-  EXPECT_EQ(instructions[19]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[19]->getArg1()->getValue<int>(), 5);
+  EXPECT_EQ(instructions[5].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[5].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[5].getTarget().getValue<Basic::register_t>(), Basic::register_t::RDX);
+  EXPECT_EQ(instructions[5].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[5].getArg1().getValue<int>(), 5);
   // mov rsi, "false"
-  EXPECT_EQ(instructions[20]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[20]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[20]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RSI);
-  EXPECT_EQ(instructions[20]->getArg1()->getType(), TType::LIT_STR);
-  EXPECT_STREQ(instructions[20]->getArg1()->getValue<std::string>().c_str(), "false");
-  // push rax
-  EXPECT_EQ(instructions[21]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[21]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[21]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  // push rcx
-  EXPECT_EQ(instructions[22]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[22]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[22]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RCX);
-  // push r11
-  EXPECT_EQ(instructions[23]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[23]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[23]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::R11);
-  // push rdi
-  EXPECT_EQ(instructions[24]->getOperation(), Operation::PUSH);
-  EXPECT_EQ(instructions[24]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[24]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[6].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[6].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[6].getTarget().getValue<Basic::register_t>(), Basic::register_t::RSI);
+  EXPECT_EQ(instructions[6].getArg1().getType(), TType::LIT_STR);
+  EXPECT_STREQ(instructions[6].getArg1().getValue<std::string>().c_str(), "false");
   // mov rax, 1
-  EXPECT_EQ(instructions[25]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[25]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[25]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  EXPECT_EQ(instructions[25]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[25]->getArg1()->getValue<int>(), 1);
+  EXPECT_EQ(instructions[7].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[7].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[7].getTarget().getValue<Basic::register_t>(), Basic::register_t::RAX);
+  EXPECT_EQ(instructions[7].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[7].getArg1().getValue<int>(), 1);
   // mov rdi, 1
-  EXPECT_EQ(instructions[26]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[26]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[26]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RDI);
-  EXPECT_EQ(instructions[26]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[26]->getArg1()->getValue<int>(), 1);
+  EXPECT_EQ(instructions[8].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[8].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[8].getTarget().getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[8].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[8].getArg1().getValue<int>(), 1);
   // syscall
-  EXPECT_EQ(instructions[27]->getOperation(), Operation::SYSCALL);
-  // pop rdi
-  EXPECT_EQ(instructions[28]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[28]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[28]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDI);
-  // pop r11
-  EXPECT_EQ(instructions[29]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[29]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[29]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::R11);
-  // pop rcx
-  EXPECT_EQ(instructions[30]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[30]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[30]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RCX);
-  // pop rax
-  EXPECT_EQ(instructions[31]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[31]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[31]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  // pop rsi
-  EXPECT_EQ(instructions[32]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[32]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[32]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RSI);
-  // pop rdx
-  EXPECT_EQ(instructions[33]->getOperation(), Operation::POP);
-  EXPECT_EQ(instructions[33]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[33]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDX);
+  EXPECT_EQ(instructions[9].getOperation(), Operation::SYSCALL);
   // call __builtin_exit
-  EXPECT_EQ(instructions[34]->getOperation(), Operation::CALL);
-  EXPECT_EQ(instructions[34]->getTarget()->getType(), TType::IDENT_VOID);
-  EXPECT_STREQ(instructions[34]->getTarget()->getValue<std::string>().c_str(), "__builtin_exit");
+  EXPECT_EQ(instructions[10].getOperation(), Operation::CALL);
+  EXPECT_EQ(instructions[10].getTarget().getType(), TType::IDENT_VOID);
+  EXPECT_STREQ(instructions[10].getTarget().getValue<std::string>().c_str(), "__builtin_exit");
   // label __builtin_exit
-  EXPECT_EQ(instructions[35]->getOperation(), Operation::LABEL);
-  EXPECT_EQ(instructions[35]->getArg1()->getType(), TType::IDENT_VOID);
-  EXPECT_STREQ(instructions[35]->getArg1()->getValue<std::string>().c_str(), "__builtin_exit");
+  EXPECT_EQ(instructions[11].getOperation(), Operation::LABEL);
+  EXPECT_EQ(instructions[11].getArg1().getType(), TType::IDENT_VOID);
+  EXPECT_STREQ(instructions[11].getArg1().getValue<std::string>().c_str(), "__builtin_exit");
   // xor rdi, rdi
-  EXPECT_EQ(instructions[36]->getOperation(), Operation::XOR);
-  EXPECT_EQ(instructions[36]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[36]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDI);
-  EXPECT_EQ(instructions[36]->getArg2()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[36]->getArg2()->getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[12].getOperation(), Operation::XOR);
+  EXPECT_EQ(instructions[12].getArg1().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[12].getArg1().getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[12].getArg2().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[12].getArg2().getValue<Basic::register_t>(), Basic::register_t::RDI);
   // mov rax, 60
-  EXPECT_EQ(instructions[37]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[37]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[37]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  EXPECT_EQ(instructions[37]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[37]->getArg1()->getValue<int>(), 60);
+  EXPECT_EQ(instructions[13].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[13].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[13].getTarget().getValue<Basic::register_t>(), Basic::register_t::RAX);
+  EXPECT_EQ(instructions[13].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[13].getArg1().getValue<int>(), 60);
   // syscall
-  EXPECT_EQ(instructions[38]->getOperation(), Operation::SYSCALL);
+  EXPECT_EQ(instructions[14].getOperation(), Operation::SYSCALL);
+}
+
+TEST_F(IRGeneratorTestWithRegisterAllocation, PrintShouldNotSaveRegistersItLeavesIntact) {
+  constexpr auto program = R"(
+  fn main() {
+    int a = 5;
+    print(a);
+    print(a + 1, "\n");
+  })"sv;
+  SetUp(program.data());
+  const auto &instructions = m_generator.getInstructions(IRGenerator::Transformation::INSTRUCTION_OPTIMIZATION);
+
+  // `a` outlives the first print, so it's kept out of `rdi`, which `__builtin_print_number` overwrites,
+  // and neither the module nor the system call touch the register it's in
+  const auto exit = std::ranges::find_if(instructions, [](const Instruction &instruction) {
+    return instruction.getOperation() == Operation::CALL &&
+           instruction.getTarget().getValue<std::string>() == "__builtin_exit";
+  });
+  ASSERT_NE(exit, instructions.end());
+  EXPECT_TRUE(std::none_of(instructions.begin(), exit, [](const Instruction &instruction) {
+    return instruction.getOperation() == Operation::PUSH || instruction.getOperation() == Operation::POP;
+  }));
 }
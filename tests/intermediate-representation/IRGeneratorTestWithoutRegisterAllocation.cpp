@@ -24,6 +24,10 @@ class IRGeneratorTestWithoutRegisterAllocationFixture : public testing::Test {
     root->accept(m_generator);
   }
 
+  std::string name(const Operand &operand) const {
+    return m_generator.getVirtualRegisters().getName(operand.getVirtualRegister());
+  }
+
  protected:
   IRGenerator m_generator{false};
 
@@ -41,63 +45,64 @@ TEST_F(IRGeneratorTestWithoutRegisterAllocation, VariableDeclarationStatements)
     int bb = aa - ba;
   })"sv;
   SetUp(program.data());
-  const auto &temporaries = m_generator.getTemporaryVars();
+  const auto &virtualRegisters = m_generator.getVirtualRegisters();
   const auto &instructions = m_generator.getInstructions(IRGenerator::Transformation::NONE);
 
-  EXPECT_EQ(temporaries.size(), 4); // from _t0 to _t3
+  EXPECT_EQ(virtualRegisters.getTemporaryCount(), 4); // from _t0 to _t3
+  EXPECT_EQ(virtualRegisters.size(), 7); // and aa, ba, bb
 
   // _tx = a <op> b rewritten as
   //    _tx = a
   //    _tx = _tx <op> b
 
   // <_t0, *, 2, 10> = <target, op, arg1, arg2>
-  EXPECT_EQ(instructions[0]->getOperation(), Operation::MOV);
-  EXPECT_STREQ(instructions[0]->getTarget()->getValue<std::string>().c_str(), "_t0");
-  EXPECT_EQ(instructions[0]->getArg1()->getValue<int>(), 2);
-  EXPECT_EQ(instructions[1]->getOperation(), Operation::IMUL);
-  EXPECT_STREQ(instructions[1]->getTarget()->getValue<std::string>().c_str(), "_t0");
-  EXPECT_EQ(instructions[1]->getArg1()->getValue<int>(), 10);
+  EXPECT_EQ(instructions[0].getOperation(), Operation::MOV);
+  EXPECT_STREQ(name(instructions[0].getTarget()).c_str(), "_t0");
+  EXPECT_EQ(instructions[0].getArg1().getValue<int>(), 2);
+  EXPECT_EQ(instructions[1].getOperation(), Operation::IMUL);
+  EXPECT_STREQ(name(instructions[1].getTarget()).c_str(), "_t0");
+  EXPECT_EQ(instructions[1].getArg1().getValue<int>(), 10);
 
   // <_t1, +, 5, _t0>
-  EXPECT_EQ(instructions[2]->getOperation(), Operation::MOV);
-  EXPECT_STREQ(instructions[2]->getTarget()->getValue<std::string>().c_str(), "_t1");
-  EXPECT_EQ(instructions[2]->getArg1()->getValue<int>(), 5);
-  EXPECT_EQ(instructions[3]->getOperation(), Operation::IADD);
-  EXPECT_STREQ(instructions[3]->getTarget()->getValue<std::string>().c_str(), "_t1");
-  EXPECT_STREQ(instructions[3]->getArg1()->getValue<std::string>().c_str(), "_t0");
+  EXPECT_EQ(instructions[2].getOperation(), Operation::MOV);
+  EXPECT_STREQ(name(instructions[2].getTarget()).c_str(), "_t1");
+  EXPECT_EQ(instructions[2].getArg1().getValue<int>(), 5);
+  EXPECT_EQ(instructions[3].getOperation(), Operation::IADD);
+  EXPECT_STREQ(name(instructions[3].getTarget()).c_str(), "_t1");
+  EXPECT_STREQ(name(instructions[3].getArg1()).c_str(), "_t0");
 
   // <aa, <-, _t1, null>
-  EXPECT_EQ(instructions[4]->getOperation(), Operation::MOV);
-  EXPECT_STREQ(instructions[4]->getTarget()->getValue<std::string>().c_str(), "aa");
-  EXPECT_STREQ(instructions[4]->getArg1()->getValue<std::string>().c_str(), "_t1");
+  EXPECT_EQ(instructions[4].getOperation(), Operation::MOV);
+  EXPECT_STREQ(name(instructions[4].getTarget()).c_str(), "aa");
+  EXPECT_STREQ(name(instructions[4].getArg1()).c_str(), "_t1");
 
   // <_t2, -, 7, 1>
-  EXPECT_EQ(instructions[5]->getOperation(), Operation::MOV);
-  EXPECT_STREQ(instructions[5]->getTarget()->getValue<std::string>().c_str(), "_t2");
-  EXPECT_EQ(instructions[5]->getArg1()->getValue<int>(), 7);
-  EXPECT_EQ(instructions[6]->getOperation(), Operation::ISUB);
-  EXPECT_STREQ(instructions[6]->getTarget()->getValue<std::string>().c_str(), "_t2");
-  EXPECT_EQ(instructions[6]->getArg1()->getValue<int>(), 1);
+  EXPECT_EQ(instructions[5].getOperation(), Operation::MOV);
+  EXPECT_STREQ(name(instructions[5].getTarget()).c_str(), "_t2");
+  EXPECT_EQ(instructions[5].getArg1().getValue<int>(), 7);
+  EXPECT_EQ(instructions[6].getOperation(), Operation::ISUB);
+  EXPECT_STREQ(name(instructions[6].getTarget()).c_str(), "_t2");
+  EXPECT_EQ(instructions[6].getArg1().getValue<int>(), 1);
 
   // <ba, <-, _t2, null>
-  EXPECT_EQ(instructions[7]->getOperation(), Operation::MOV);
-  EXPECT_STREQ(instructions[7]->getTarget()->getValue<std::string>().c_str(), "ba");
-  EXPECT_STREQ(instructions[7]->getArg1()->getValue<std::string>().c_str(), "_t2");
+  EXPECT_EQ(instructions[7].getOperation(), Operation::MOV);
+  EXPECT_STREQ(name(instructions[7].getTarget()).c_str(), "ba");
+  EXPECT_STREQ(name(instructions[7].getArg1()).c_str(), "_t2");
 
   // <_t3, <-, aa, null>
-  EXPECT_EQ(instructions[8]->getOperation(), Operation::MOV);
-  EXPECT_STREQ(instructions[8]->getTarget()->getValue<std::string>().c_str(), "_t3");
-  EXPECT_STREQ(instructions[8]->getArg1()->getValue<std::string>().c_str(), "aa");
+  EXPECT_EQ(instructions[8].getOperation(), Operation::MOV);
+  EXPECT_STREQ(name(instructions[8].getTarget()).c_str(), "_t3");
+  EXPECT_STREQ(name(instructions[8].getArg1()).c_str(), "aa");
 
   // <_t3, -, ba, null>
-  EXPECT_EQ(instructions[9]->getOperation(), Operation::ISUB);
-  EXPECT_STREQ(instructions[9]->getTarget()->getValue<std::string>().c_str(), "_t3");
-  EXPECT_STREQ(instructions[9]->getArg1()->getValue<std::string>().c_str(), "ba");
+  EXPECT_EQ(instructions[9].getOperation(), Operation::ISUB);
+  EXPECT_STREQ(name(instructions[9].getTarget()).c_str(), "_t3");
+  EXPECT_STREQ(name(instructions[9].getArg1()).c_str(), "ba");
 
   // <bb, <-, _t3, null>
-  EXPECT_EQ(instructions[10]->getOperation(), Operation::MOV);
-  EXPECT_STREQ(instructions[10]->getTarget()->getValue<std::string>().c_str(), "bb");
-  EXPECT_STREQ(instructions[10]->getArg1()->getValue<std::string>().c_str(), "_t3");
+  EXPECT_EQ(instructions[10].getOperation(), Operation::MOV);
+  EXPECT_STREQ(name(instructions[10].getTarget()).c_str(), "bb");
+  EXPECT_STREQ(name(instructions[10].getArg1()).c_str(), "_t3");
 }
 
 TEST_F(IRGeneratorTestWithoutRegisterAllocation, PrintIRForVariableDeclarationStatements) {
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0
 
 #include <gtest/gtest.h>
+#include <fmt/format.h>
 // Wisnia
 #include "Lexer.hpp"
 #include "Token.hpp"
@@ -273,3 +274,130 @@ TEST(LexerTest, OutOfRangeValueInt) {
       },
       TokenError);
 }
+
+TEST(LexerTest, CompactTokensReferToSource) {
+  constexpr auto program = R"(int ab = 42; print("a\tb", "cd");)"sv;
+  std::istringstream iss{program.data()};
+  Lexer lexer{iss};
+  const auto &arena{lexer.getArena()};
+  const auto &tokens{arena.getTokens()};
+  const auto source{lexer.getSource()->getData()};
+  const auto isInSource = [&](const std::string_view text) {
+    return text.data() >= source.data() && text.data() + text.size() <= source.data() + source.size();
+  };
+
+  EXPECT_EQ(tokens.size(), 13);
+  // ab
+  EXPECT_EQ(tokens[1].m_type, TType::IDENT);
+  EXPECT_EQ(tokens[1].getText(), "ab");
+  EXPECT_TRUE(isInSource(tokens[1].getText()));
+  // 42
+  EXPECT_EQ(tokens[3].m_type, TType::LIT_INT);
+  EXPECT_EQ(tokens[3].getText(), "42");
+  EXPECT_EQ(tokens[3].m_int, 42);
+  // "a\tb" is unescaped into the arena
+  EXPECT_EQ(tokens[7].m_type, TType::LIT_STR);
+  EXPECT_EQ(tokens[7].getText(), "a\tb");
+  EXPECT_FALSE(isInSource(tokens[7].getText()));
+  // "cd" is read in place
+  EXPECT_EQ(tokens[9].m_type, TType::LIT_STR);
+  EXPECT_EQ(tokens[9].getText(), "cd");
+  EXPECT_TRUE(isInSource(tokens[9].getText()));
+
+  // the parser still gets the usual tokens
+  EXPECT_EQ(lexer.getTokens().size(), tokens.size());
+  EXPECT_EQ(lexer.getTokens()[3]->getValue<int>(), 42);
+  EXPECT_EQ(lexer.getTokens()[7]->getValue<std::string>(), "a\tb");
+}
+
+TEST(LexerTest, TokenPositions) {
+  constexpr auto program = "fn main() {\n  print(\"a\", 12);\n}"sv;
+  std::istringstream iss{program.data()};
+  Lexer lexer{iss};
+  const auto &tokens{lexer.getTokens()};
+
+  EXPECT_EQ(tokens.size(), 14);
+  // fn
+  EXPECT_EQ(tokens[0]->getPosition().getFileName(), "in-memory");
+  EXPECT_EQ(tokens[0]->getPosition().getLineNo(), 1);
+  EXPECT_EQ(tokens[0]->getPosition().getColumnNo(), 1);
+  // main
+  EXPECT_EQ(tokens[1]->getPosition().getLineNo(), 1);
+  EXPECT_EQ(tokens[1]->getPosition().getColumnNo(), 4);
+  // "a"
+  EXPECT_EQ(tokens[7]->getType(), TType::LIT_STR);
+  EXPECT_EQ(tokens[7]->getPosition().getLineNo(), 2);
+  EXPECT_EQ(tokens[7]->getPosition().getColumnNo(), 9);
+  // 12
+  EXPECT_EQ(tokens[9]->getType(), TType::LIT_INT);
+  EXPECT_EQ(tokens[9]->getPosition().getLineNo(), 2);
+  EXPECT_EQ(tokens[9]->getPosition().getColumnNo(), 14);
+  // }
+  EXPECT_EQ(tokens[12]->getPosition().getLineNo(), 3);
+  EXPECT_EQ(tokens[12]->getPosition().getColumnNo(), 1);
+}
+
+TEST(LexerTest, EveryNewlineIsCounted) {
+  // after a number, escaped in a string, and right after a '*' in a multi-line comment
+  constexpr auto program = "x = 1\n2.5\n\"a\\\nb\" /* *\n*/ y"sv;
+  std::istringstream iss{program.data()};
+  Lexer lexer{iss};
+  const auto &tokens{lexer.getTokens()};
+
+  EXPECT_EQ(tokens.size(), 7);
+  // 1
+  EXPECT_EQ(tokens[2]->getPosition().getLineNo(), 1);
+  // 2.5
+  EXPECT_EQ(tokens[3]->getType(), TType::LIT_FLT);
+  EXPECT_EQ(tokens[3]->getPosition().getLineNo(), 2);
+  EXPECT_EQ(tokens[3]->getPosition().getColumnNo(), 1);
+  // the string with the escaped newline
+  EXPECT_EQ(tokens[4]->getType(), TType::LIT_STR);
+  EXPECT_EQ(tokens[4]->getPosition().getLineNo(), 3);
+  // y
+  EXPECT_EQ(tokens[5]->getPosition().getLineNo(), 5);
+  EXPECT_EQ(tokens[5]->getPosition().getColumnNo(), 4);
+}
+
+TEST(LexerTest, KeywordsAndLookalikes) {
+  std::string program{};
+  for (const auto &[keyword, type] : Str2TokenKw) {
+    program += fmt::format("{} {}_ _{} {}{} ", keyword, keyword, keyword, keyword, keyword.back());
+  }
+  program += "f fo fors Fn IF for_eac print2";
+  std::istringstream iss{program};
+  Lexer lexer{iss};
+  const auto &tokens{lexer.getTokens()};
+
+  EXPECT_EQ(tokens.size(), Str2TokenKw.size() * 4 + 8);
+  for (size_t i = 0; i < Str2TokenKw.size(); ++i) {
+    EXPECT_EQ(tokens[i * 4]->getType(), Str2TokenKw[i].second);
+    for (size_t j = 1; j < 4; ++j) {
+      EXPECT_EQ(tokens[i * 4 + j]->getType(), TType::IDENT);
+    }
+  }
+  for (size_t i = Str2TokenKw.size() * 4; i < tokens.size() - 1; ++i) {
+    EXPECT_EQ(tokens[i]->getType(), TType::IDENT);
+  }
+}
+
+TEST(LexerTest, StreamingTokens) {
+  constexpr auto program = "fn main() {\n  x = \"a\\tb\" + 12; // done\n}"sv;
+  std::istringstream batchStream{program.data()};
+  Lexer batch{batchStream};
+  std::istringstream iss{program.data()};
+  Lexer lexer{iss, Lexer::Streaming{}};
+
+  EXPECT_TRUE(lexer.isStreaming());
+  for (const auto &expected : batch.getTokens()) {
+    const auto token = lexer.next();
+    EXPECT_EQ(token->getType(), expected->getType());
+    EXPECT_EQ(token->getASTValueStr(), expected->getASTValueStr());
+    EXPECT_EQ(token->getPosition().getLineNo(), expected->getPosition().getLineNo());
+    EXPECT_EQ(token->getPosition().getColumnNo(), expected->getPosition().getColumnNo());
+    // a streaming lexer keeps nothing but the upcoming token
+    EXPECT_LE(lexer.getArena().size(), 1);
+  }
+  // the input is exhausted
+  EXPECT_EQ(lexer.next()->getType(), TType::TOK_EOF);
+}
@@ -3,6 +3,7 @@
 
 #include <gtest/gtest.h>
 #include <filesystem>
+#include <fstream>
 // Wisnia
 #include "Lexer.hpp"
 #include "Token.hpp"
@@ -50,6 +51,36 @@ TEST(LexerTest, ReadFromFile) {
   // }
   EXPECT_EQ(tokens[15]->getType(), TType::OP_BRACE_C);
   EXPECT_EQ(tokens[16]->getType(), TType::TOK_EOF);
+
+  // source file is read in place
+  EXPECT_TRUE(lexer.getSource()->isMapped());
+  EXPECT_EQ(lexer.getSource()->getFileName(), *filePath);
+}
+
+TEST(LexerTest, ReadFromFileWithoutTrailingNewline) {
+  const auto filePath = fs::temp_directory_path() / "no-trailing-newline.wsn";
+  {
+    std::ofstream file{filePath};
+    file << "fn main() {\n  print(var);\n}";
+  }
+
+  std::shared_ptr<const SourceBuffer> source;
+  {
+    Lexer lexer{filePath.string()};
+    const auto &tokens{lexer.getTokens()};
+
+    EXPECT_EQ(tokens.size(), 12);
+    EXPECT_EQ(tokens[10]->getType(), TType::OP_BRACE_C);
+    EXPECT_EQ(tokens[10]->getPosition().getLineNo(), 3);
+    EXPECT_EQ(tokens[11]->getType(), TType::TOK_EOF);
+    source = lexer.getSource();
+  }
+
+  // the mapping outlives the lexer and the missing newline wasn't appended to it
+  EXPECT_TRUE(source->isMapped());
+  EXPECT_FALSE(source->hasTrailingNewline());
+  EXPECT_EQ(source->getData().back(), '}');
+  fs::remove(filePath);
 }
 
 TEST(LexerTest, ReadFromNonExistentFileShouldFail) {
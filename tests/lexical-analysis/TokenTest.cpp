@@ -102,3 +102,72 @@ TEST(TokenTest, StringTokensWithEscapeSymbols) {
   EXPECT_STREQ(tokens[5]->getValueStr().c_str(), "hello \"world\"");
   EXPECT_EQ(tokens[6]->getType(), TType::TOK_EOF);
 }
+
+TEST(TokenTest, SourceLocations) {
+  const SourceManager::Scope scope{};
+  constexpr auto program = "fn main() {\n  x = 1;\n}"sv;
+  std::istringstream iss{program.data()};
+  const auto source = SourceBuffer::fromStream(iss);
+  Lexer lexer{source, {0, source->size()}};
+  const auto &tokens{lexer.getTokens()};
+
+  // x
+  const auto &position = tokens[5]->getPosition();
+  EXPECT_EQ(sizeof(position), 8);
+  EXPECT_EQ(position.getLocation().getOffset(), program.find('x'));
+  EXPECT_EQ(position.getFileName(), "in-memory");
+  EXPECT_EQ(position.getLineNo(), 2);
+  EXPECT_EQ(position.getColumnNo(), 3);
+
+  // the same source is registered only once, while another one of the same name gets an ID of its own
+  Lexer same{source, {0, source->size()}};
+  EXPECT_EQ(same.getTokens()[5]->getPosition().getLocation().getFileId(), position.getLocation().getFileId());
+  std::istringstream otherStream{program.data()};
+  Lexer other{otherStream};
+  EXPECT_NE(other.getTokens()[5]->getPosition().getLocation().getFileId(), position.getLocation().getFileId());
+  EXPECT_EQ(other.getTokens()[5]->getPosition().getLineNo(), 2);
+
+  // tokens that aren't read from a source have no position
+  const Token token{TType::IDENT, std::string{"y"}};
+  EXPECT_FALSE(token.getPosition().getLocation().isValid());
+  EXPECT_EQ(token.getPosition().getFileName(), "");
+  EXPECT_EQ(token.getPosition().getLineNo(), 0);
+}
+
+TEST(TokenTest, LinesPastTheOldLimit) {
+  // more lines than would fit into 17 bits
+  constexpr size_t lines{200003};
+  std::string program{};
+  for (size_t line = 1; line < lines; ++line) {
+    program += "x\n";
+  }
+  program += "    y";
+  std::istringstream iss{program};
+  Lexer lexer{iss};
+  const auto &tokens{lexer.getTokens()};
+
+  ASSERT_EQ(tokens.size(), lines + 1);
+  EXPECT_EQ(tokens[lines - 2]->getPosition().getLineNo(), lines - 1);
+  EXPECT_EQ(tokens[lines - 1]->getValue<std::string>(), "y");
+  EXPECT_EQ(tokens[lines - 1]->getPosition().getLineNo(), lines);
+  EXPECT_EQ(tokens[lines - 1]->getPosition().getColumnNo(), 5);
+}
+
+TEST(TokenTest, SourceFilesPerCompilation) {
+  const auto sourceOf = [](const std::string &text) {
+    std::istringstream iss{text};
+    return SourceBuffer::fromStream(iss);
+  };
+
+  // each compilation registers its files anew
+  for (uint32_t compilation = 0; compilation < 10; compilation++) {
+    const SourceManager::Scope scope{};
+    EXPECT_EQ(SourceManager::registerFile(sourceOf("x")), 0);
+  }
+
+  // and one compilation can have any number of them
+  const SourceManager::Scope scope{};
+  for (uint32_t file = 0; file < 1000; file++) {
+    EXPECT_EQ(SourceManager::registerFile(sourceOf("x")), file);
+  }
+}
@@ -15,7 +15,7 @@
 using namespace Wisnia;
 using namespace std::literals;
 
-class IProgramTestFixture : public testing::Test {
+class IProgramTestFixture : public testing::TestWithParam<RegisterAllocator::Algorithm> {
   struct Program {
     int m_status;
     std::string m_output;
@@ -89,7 +89,7 @@ class IProgramTestFixture : public testing::Test {
 
  private:
   SemanticAnalysis m_analysis{};
-  IRGenerator m_generator{};
+  IRGenerator m_generator{true, GetParam()};
 };
 
 #define EXPECT_PROGRAM_OUTPUT(statement, output)      \
@@ -106,7 +106,7 @@ using ProgramTest = IProgramTestFixture;
 // Default values
 // ----------------------------------------------------
 
-TEST_F(ProgramTest, DefaultIntValue) {
+TEST_P(ProgramTest, DefaultIntValue) {
   constexpr auto program = R"(
   fn main() {
     int var;
@@ -116,7 +116,7 @@ TEST_F(ProgramTest, DefaultIntValue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "0");
 }
 
-TEST_F(ProgramTest, DefaultStringValue) {
+TEST_P(ProgramTest, DefaultStringValue) {
   constexpr auto program = R"(
   fn main() {
     string var;
@@ -126,7 +126,7 @@ TEST_F(ProgramTest, DefaultStringValue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "");
 }
 
-TEST_F(ProgramTest, DefaultBooleanValue) {
+TEST_P(ProgramTest, DefaultBooleanValue) {
   constexpr auto program = R"(
   fn main() {
     bool var;
@@ -140,7 +140,7 @@ TEST_F(ProgramTest, DefaultBooleanValue) {
 // Print values
 // ----------------------------------------------------
 
-TEST_F(ProgramTest, PrintStrings) {
+TEST_P(ProgramTest, PrintStrings) {
   constexpr auto program = R"(
   fn main() {
     print("hello world\n");
@@ -156,7 +156,7 @@ TEST_F(ProgramTest, PrintStrings) {
   );
 }
 
-TEST_F(ProgramTest, PrintNumbers) {
+TEST_P(ProgramTest, PrintNumbers) {
   constexpr auto program = R"(
   fn main() {
     print(12345, 67890, 55555);
@@ -165,7 +165,7 @@ TEST_F(ProgramTest, PrintNumbers) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "123456789055555");
 }
 
-TEST_F(ProgramTest, PrintBooleans) {
+TEST_P(ProgramTest, PrintBooleans) {
   constexpr auto program = R"(
   fn main() {
     print(true, false, true);
@@ -174,7 +174,7 @@ TEST_F(ProgramTest, PrintBooleans) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "truefalsetrue");
 }
 
-TEST_F(ProgramTest, PrintStringVariables) {
+TEST_P(ProgramTest, PrintStringVariables) {
   constexpr auto program = R"(
   fn main() {
     string str1 = "ABCDE";
@@ -186,7 +186,7 @@ TEST_F(ProgramTest, PrintStringVariables) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "ABCDE1234567890");
 }
 
-TEST_F(ProgramTest, PrintMaxInt) {
+TEST_P(ProgramTest, PrintMaxInt) {
   constexpr auto program = R"(
   fn main() {
     int max = 2147483647; // mov rax, 0x7fffffff --> 48 c7 c0 | ff ff ff 7f
@@ -200,7 +200,7 @@ TEST_F(ProgramTest, PrintMaxInt) {
 // Exhaust registers
 // ----------------------------------------------------
 
-TEST_F(ProgramTest, ExhaustRegistersForMovInt) {
+TEST_P(ProgramTest, ExhaustRegistersForMovInt) {
   // trying to exhaust all 15 registers (rax - r15)
   constexpr auto program = R"(
   fn main() {
@@ -229,7 +229,7 @@ TEST_F(ProgramTest, ExhaustRegistersForMovInt) {
   );
 }
 
-TEST_F(ProgramTest, ExhaustRegistersForMovBoolean) {
+TEST_P(ProgramTest, ExhaustRegistersForMovBoolean) {
   // trying to exhaust all 15 registers (rax - r15)
   constexpr auto program = R"(
   fn main() {
@@ -258,7 +258,7 @@ TEST_F(ProgramTest, ExhaustRegistersForMovBoolean) {
   );
 }
 
-TEST_F(ProgramTest, ExhaustRegistersForAddInt) {
+TEST_P(ProgramTest, ExhaustRegistersForAddInt) {
   // trying to exhaust all 15 registers (rax - r15)
   constexpr auto program = R"(
   fn main() {
@@ -286,7 +286,7 @@ TEST_F(ProgramTest, ExhaustRegistersForAddInt) {
   );
 }
 
-TEST_F(ProgramTest, ExhaustRegistersForSubInt) {
+TEST_P(ProgramTest, ExhaustRegistersForSubInt) {
   // trying to exhaust all 14 registers (rcx - r15)
   constexpr auto program = R"(
   fn main() {
@@ -314,7 +314,7 @@ TEST_F(ProgramTest, ExhaustRegistersForSubInt) {
   );
 }
 
-TEST_F(ProgramTest, ExhaustRegistersForMulInt) {
+TEST_P(ProgramTest, ExhaustRegistersForMulInt) {
   // trying to exhaust all 14 registers (rcx - r15)
   constexpr auto program = R"(
   fn main() {
@@ -346,7 +346,7 @@ TEST_F(ProgramTest, ExhaustRegistersForMulInt) {
 // Calculate expressions
 // ----------------------------------------------------
 
-TEST_F(ProgramTest, CalculateSum) {
+TEST_P(ProgramTest, CalculateSum) {
   constexpr auto program = R"(
   fn main() {
     int sum = 1 + 10 + 100 + 1000 + 10000 + 100000 + 1000000 + 10000000 + 100000000 + 1000000000;
@@ -356,7 +356,7 @@ TEST_F(ProgramTest, CalculateSum) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "1111111111");
 }
 
-TEST_F(ProgramTest, CalculateDifference) {
+TEST_P(ProgramTest, CalculateDifference) {
   constexpr auto program = R"(
   fn main() {
     int diff = 23456789 - 1 - 10 - 100 - 1000 - 10000 - 100000 - 1000000 - 10000000;
@@ -366,7 +366,7 @@ TEST_F(ProgramTest, CalculateDifference) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "12345678");
 }
 
-TEST_F(ProgramTest, CalculateProduct) {
+TEST_P(ProgramTest, CalculateProduct) {
   constexpr auto program = R"(
   fn main() {
     int prod = 2 * 4 * 6 * 8 * 10 * 12 * 14 * 16 * 18 * 20;
@@ -376,7 +376,7 @@ TEST_F(ProgramTest, CalculateProduct) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "3715891200");
 }
 
-TEST_F(ProgramTest, CalculateExpression1) {
+TEST_P(ProgramTest, CalculateExpression1) {
   constexpr auto program = R"(
   fn main() {
     int expr = ((1 + 2) * 3 + 4 * 5) - 6 * 7 + 13;
@@ -386,7 +386,7 @@ TEST_F(ProgramTest, CalculateExpression1) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "0");
 }
 
-TEST_F(ProgramTest, CalculateExpression2) {
+TEST_P(ProgramTest, CalculateExpression2) {
   constexpr auto program = R"(
   fn main() {
     int expr = 0;
@@ -396,7 +396,7 @@ TEST_F(ProgramTest, CalculateExpression2) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "6");
 }
 
-TEST_F(ProgramTest, CalculateExpression3) {
+TEST_P(ProgramTest, CalculateExpression3) {
   constexpr auto program = R"(
   fn main() {
     int expr = 0;
@@ -406,7 +406,7 @@ TEST_F(ProgramTest, CalculateExpression3) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "4");
 }
 
-TEST_F(ProgramTest, CalculateExpression4) {
+TEST_P(ProgramTest, CalculateExpression4) {
   constexpr auto program = R"(
   fn main() {
     int expr = 5;
@@ -416,7 +416,7 @@ TEST_F(ProgramTest, CalculateExpression4) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "29");
 }
 
-TEST_F(ProgramTest, PrintSum) {
+TEST_P(ProgramTest, PrintSum) {
   constexpr auto program = R"(
   fn main() {
     print(1 + 10 + 100 + 1000 + 10000 + 100000 + 1000000 + 10000000 + 100000000 + 1000000000);
@@ -425,7 +425,7 @@ TEST_F(ProgramTest, PrintSum) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "1111111111");
 }
 
-TEST_F(ProgramTest, PrintDifference) {
+TEST_P(ProgramTest, PrintDifference) {
   constexpr auto program = R"(
   fn main() {
     print(23456789 - 1 - 10 - 100 - 1000 - 10000 - 100000 - 1000000 - 10000000);
@@ -434,7 +434,7 @@ TEST_F(ProgramTest, PrintDifference) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "12345678");
 }
 
-TEST_F(ProgramTest, PrintProduct) {
+TEST_P(ProgramTest, PrintProduct) {
   constexpr auto program = R"(
   fn main() {
     print(2 * 4 * 6 * 8 * 10 * 12 * 14 * 16 * 18 * 20);
@@ -443,7 +443,7 @@ TEST_F(ProgramTest, PrintProduct) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "3715891200");
 }
 
-TEST_F(ProgramTest, PrintExpression) {
+TEST_P(ProgramTest, PrintExpression) {
   constexpr auto program = R"(
   fn main() {
     print(((1 + 2) * 3 + 4 * 5) - 6 * 7 + 13);
@@ -452,7 +452,7 @@ TEST_F(ProgramTest, PrintExpression) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "0");
 }
 
-TEST_F(ProgramTest, AddVariables) {
+TEST_P(ProgramTest, AddVariables) {
   constexpr auto program = R"(
   fn main() {
     int num1  = 1;
@@ -472,7 +472,7 @@ TEST_F(ProgramTest, AddVariables) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "1111111111");
 }
 
-TEST_F(ProgramTest, SubtractVariables) {
+TEST_P(ProgramTest, SubtractVariables) {
   constexpr auto program = R"(
   fn main() {
     int num1 = 1;
@@ -491,7 +491,7 @@ TEST_F(ProgramTest, SubtractVariables) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "12345678");
 }
 
-TEST_F(ProgramTest, MultiplyVariables) {
+TEST_P(ProgramTest, MultiplyVariables) {
   constexpr auto program = R"(
   fn main() {
     int num1  = 2;
@@ -515,7 +515,7 @@ TEST_F(ProgramTest, MultiplyVariables) {
 // Variable assignment
 // ----------------------------------------------------
 
-TEST_F(ProgramTest, AssignVariables) {
+TEST_P(ProgramTest, AssignVariables) {
   constexpr auto program = R"(
   fn main() {
     int num1 = 1;
@@ -532,7 +532,7 @@ TEST_F(ProgramTest, AssignVariables) {
 // Function call
 // ----------------------------------------------------
 
-TEST_F(ProgramTest, CallFunction) {
+TEST_P(ProgramTest, CallFunction) {
   constexpr auto program = R"(
   fn foo() {
     print("inside foo\n");
@@ -551,7 +551,7 @@ TEST_F(ProgramTest, CallFunction) {
   );
 }
 
-TEST_F(ProgramTest, CallFunctionWithArguments) {
+TEST_P(ProgramTest, CallFunctionWithArguments) {
   constexpr auto program = R"(
   fn foo(value_1: int, value_2: int, value_3: int) {
     print("inside foo 1\n");
@@ -574,7 +574,7 @@ TEST_F(ProgramTest, CallFunctionWithArguments) {
   );
 }
 
-TEST_F(ProgramTest, CallFunctionInsideAnotherWithArguments) {
+TEST_P(ProgramTest, CallFunctionInsideAnotherWithArguments) {
   constexpr auto program = R"(
   fn bar(value_1: string) {
     print("inside bar 1\n");
@@ -606,7 +606,7 @@ TEST_F(ProgramTest, CallFunctionInsideAnotherWithArguments) {
   );
 }
 
-TEST_F(ProgramTest, CallFunctionShouldNotOverrideVariables) {
+TEST_P(ProgramTest, CallFunctionShouldNotOverrideVariables) {
   constexpr auto program = R"(
   fn foo(value_1: int, value_2: int, value_3: int) {
     int a = 1;
@@ -637,7 +637,7 @@ TEST_F(ProgramTest, CallFunctionShouldNotOverrideVariables) {
 // Function return
 // ----------------------------------------------------
 
-TEST_F(ProgramTest, FunctionReturnInt) {
+TEST_P(ProgramTest, FunctionReturnInt) {
   constexpr auto program = R"(
   fn foo() -> int {
     return 5;
@@ -650,7 +650,7 @@ TEST_F(ProgramTest, FunctionReturnInt) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "5");
 }
 
-TEST_F(ProgramTest, FunctionReturnBoolean) {
+TEST_P(ProgramTest, FunctionReturnBoolean) {
   constexpr auto program = R"(
   fn foo() -> bool {
     return true;
@@ -663,7 +663,7 @@ TEST_F(ProgramTest, FunctionReturnBoolean) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, FunctionReturnVariable) {
+TEST_P(ProgramTest, FunctionReturnVariable) {
   constexpr auto program = R"(
   fn foo() -> int {
     int var = 5;
@@ -677,7 +677,7 @@ TEST_F(ProgramTest, FunctionReturnVariable) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "5");
 }
 
-TEST_F(ProgramTest, FunctionReturnIntExpression) {
+TEST_P(ProgramTest, FunctionReturnIntExpression) {
   constexpr auto program = R"(
   fn foo() -> int {
     return 10 - 2 * 3;
@@ -690,7 +690,7 @@ TEST_F(ProgramTest, FunctionReturnIntExpression) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "4");
 }
 
-TEST_F(ProgramTest, FunctionReturnVariableExpression) {
+TEST_P(ProgramTest, FunctionReturnVariableExpression) {
   constexpr auto program = R"(
   fn foo() -> int {
     int var = 5;
@@ -704,7 +704,7 @@ TEST_F(ProgramTest, FunctionReturnVariableExpression) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "15");
 }
 
-TEST_F(ProgramTest, FunctionReturnVariableWithArgumentExpression) {
+TEST_P(ProgramTest, FunctionReturnVariableWithArgumentExpression) {
   constexpr auto program = R"(
   fn foo(value_1: int, value_2: int) -> int {
     return value_1 + value_2;
@@ -718,7 +718,7 @@ TEST_F(ProgramTest, FunctionReturnVariableWithArgumentExpression) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "18");
 }
 
-TEST_F(ProgramTest, PrintFunctionReturnInt) {
+TEST_P(ProgramTest, PrintFunctionReturnInt) {
   constexpr auto program = R"(
   fn foo() -> int {
     return 5;
@@ -730,7 +730,7 @@ TEST_F(ProgramTest, PrintFunctionReturnInt) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "5");
 }
 
-TEST_F(ProgramTest, PrintFunctionReturnBoolean) {
+TEST_P(ProgramTest, PrintFunctionReturnBoolean) {
   constexpr auto program = R"(
   fn foo() -> bool {
     return true;
@@ -742,7 +742,7 @@ TEST_F(ProgramTest, PrintFunctionReturnBoolean) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, PrintFunctionReturnVariable) {
+TEST_P(ProgramTest, PrintFunctionReturnVariable) {
   constexpr auto program = R"(
   fn foo() -> int {
     int var = 5;
@@ -755,7 +755,7 @@ TEST_F(ProgramTest, PrintFunctionReturnVariable) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "5");
 }
 
-TEST_F(ProgramTest, PrintFunctionReturnIntExpression) {
+TEST_P(ProgramTest, PrintFunctionReturnIntExpression) {
   constexpr auto program = R"(
   fn foo() -> int {
     return 10 - 2 * 3;
@@ -767,7 +767,7 @@ TEST_F(ProgramTest, PrintFunctionReturnIntExpression) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "4");
 }
 
-TEST_F(ProgramTest, PrintFunctionReturnVariableExpression) {
+TEST_P(ProgramTest, PrintFunctionReturnVariableExpression) {
   constexpr auto program = R"(
   fn foo() -> int {
     int var = 5;
@@ -780,7 +780,7 @@ TEST_F(ProgramTest, PrintFunctionReturnVariableExpression) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "15");
 }
 
-TEST_F(ProgramTest, PrintFunctionReturnVariableWithArgumentExpression) {
+TEST_P(ProgramTest, PrintFunctionReturnVariableWithArgumentExpression) {
   constexpr auto program = R"(
   fn foo(value_1: int, value_2: int) -> int {
     return value_1 + value_2;
@@ -793,11 +793,201 @@ TEST_F(ProgramTest, PrintFunctionReturnVariableWithArgumentExpression) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "18");
 }
 
+TEST_P(ProgramTest, FunctionReturnKeepsCallerVariables) {
+  constexpr auto program = R"(
+  fn foo(value: int) -> int {
+    int a = 100;
+    int b = 200;
+    return value + a + b;
+  }
+  fn main() {
+    int a = 1;
+    int b = 2;
+    int c = foo(a) + b;
+    print(a, " ", b, " ", c, " ", a + foo(b));
+  })"sv;
+  SetUp(program);
+  EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "1 2 303 303");
+}
+
+TEST_P(ProgramTest, FunctionEarlyReturn) {
+  constexpr auto program = R"(
+  fn compare(value: int, limit: int) -> int {
+    if (value < limit) {
+      return 0;
+    }
+    if (value == limit) {
+      return 1;
+    }
+    return 2;
+  }
+  fn main() {
+    print(compare(3, 5), compare(5, 5), compare(7, 5));
+  })"sv;
+  SetUp(program);
+  EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "012");
+}
+
+TEST_P(ProgramTest, RecursiveFunction) {
+  constexpr auto program = R"(
+  fn fibonacci(n: int) -> int {
+    if (n <= 1) {
+      return n;
+    }
+    return fibonacci(n - 1) + fibonacci(n - 2);
+  }
+  fn main() {
+    print(fibonacci(20));
+  })"sv;
+  SetUp(program);
+  EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "6765");
+}
+
+TEST_P(ProgramTest, FunctionWithArgumentsOnTheStack) {
+  constexpr auto program = R"(
+  fn digits(a: int, b: int, c: int, d: int, e: int, f: int, g: int, h: int) -> int {
+    return a * 10000000 + b * 1000000 + c * 100000 + d * 10000 + e * 1000 + f * 100 + g * 10 + h;
+  }
+  fn subtract(x: int, y: int) -> int {
+    return x - y;
+  }
+  fn swap(x: int, y: int) -> int {
+    return subtract(y, x);
+  }
+  fn main() {
+    int c = 3;
+    print(digits(1, 2, c, 4, 5, 6, 7, 8), " ", swap(2, 9), " ", c);
+  })"sv;
+  SetUp(program);
+  EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "12345678 7 3");
+}
+
+TEST_P(ProgramTest, SpilledVariables) {
+  constexpr auto program = R"(
+  fn main() {
+    int a = 1;
+    int b = 2;
+    int c = 3;
+    int d = 4;
+    int e = 5;
+    int f = 6;
+    int g = 7;
+    int h = 8;
+    int i = 9;
+    int j = 10;
+    int k = 11;
+    int l = 12;
+    int m = 13;
+    int n = 14;
+    int o = 15;
+    int p = 16;
+    int r = 17;
+    int total = 0;
+    for (int x = 0; x < 10; x = x + 1) {
+      a = a + x;
+      total = total + a + b + c + d + e + f + g + h + i + j + k + l + m + n + o + p + r;
+    }
+    print(total);
+  })"sv;
+  SetUp(program);
+  EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "1695");
+}
+
+TEST_P(ProgramTest, SpilledVariablesCopiedIntoThemselves) {
+  // The copy reads the variable's stack slot before writing it back
+  constexpr auto program = R"(
+  fn main() {
+    int a = 1;
+    int b = 2;
+    int c = 3;
+    int d = 4;
+    int e = 5;
+    int f = 6;
+    int g = 7;
+    int h = 8;
+    int i = 9;
+    int j = 10;
+    int k = 11;
+    int l = 12;
+    int m = 13;
+    int n = 14;
+    int o = 15;
+    int p = 16;
+    int r = 17;
+    int total = 0;
+    for (int x = 0; x < 10; x = x + 1) {
+      a = a + x;
+      b = b;
+      c = c;
+      d = d;
+      e = e;
+      f = f;
+      g = g;
+      h = h;
+      i = i;
+      j = j;
+      k = k;
+      l = l;
+      m = m;
+      n = n;
+      o = o;
+      p = p;
+      r = r;
+      total = total + a + b + c + d + e + f + g + h + i + j + k + l + m + n + o + p + r;
+    }
+    print(total);
+  })"sv;
+  SetUp(program);
+  EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "1695");
+}
+
+TEST_P(ProgramTest, CodeLargerThanAPage) {
+  // The jumps over the body reach past a single byte's offset, and the code past the first page
+  std::string program{"fn main() {\n  int a = 0;\n  while (a < 1) {\n"};
+  for (int i = 1; i <= 400; i++) {
+    program += "    a = a + " + std::to_string(i) + ";\n";
+  }
+  program += "  }\n  print(a);\n}";
+  SetUp(program);
+  EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "80200");
+}
+
+TEST_P(ProgramTest, SpilledVariablesAcrossCalls) {
+  constexpr auto program = R"(
+  fn countdown(n: int, a: int, b: int, c: int, d: int, e: int, f: int, g: int) -> int {
+    if (n < 1) {
+      return a + b + c + d + e + f + g;
+    }
+    int v1 = n * 2;
+    int v2 = n * 3;
+    int v3 = n * 4;
+    int v4 = n * 5;
+    int v5 = n * 6;
+    int v6 = n * 7;
+    int v7 = n * 8;
+    int v8 = n * 9;
+    int v9 = n * 10;
+    int v10 = n * 11;
+    int v11 = n * 12;
+    int v12 = n * 13;
+    int v13 = n * 14;
+    int v14 = n * 15;
+    int v15 = n * 16;
+    int rest = countdown(n - 1, a + 1, b, c, d, e, f, g);
+    return rest + v1 + v2 + v3 + v4 + v5 + v6 + v7 + v8 + v9 + v10 + v11 + v12 + v13 + v14 + v15;
+  }
+  fn main() {
+    print(countdown(10, 1, 2, 3, 4, 5, 6, 7));
+  })"sv;
+  SetUp(program);
+  EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "7463");
+}
+
 // ----------------------------------------------------
 // Conditional expressions
 // ----------------------------------------------------
 
-TEST_F(ProgramTest, ConditionalIntLiteralTrue) {
+TEST_P(ProgramTest, ConditionalIntLiteralTrue) {
   constexpr auto program = R"(
   fn main() {
     if (5) {
@@ -810,7 +1000,7 @@ TEST_F(ProgramTest, ConditionalIntLiteralTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalIntLiteralFalse) {
+TEST_P(ProgramTest, ConditionalIntLiteralFalse) {
   constexpr auto program = R"(
   fn main() {
     if (0) {
@@ -823,7 +1013,7 @@ TEST_F(ProgramTest, ConditionalIntLiteralFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalBooleanLiteralTrue) {
+TEST_P(ProgramTest, ConditionalBooleanLiteralTrue) {
   constexpr auto program = R"(
   fn main() {
     if (true) {
@@ -836,7 +1026,7 @@ TEST_F(ProgramTest, ConditionalBooleanLiteralTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalBooleanLiteralFalse) {
+TEST_P(ProgramTest, ConditionalBooleanLiteralFalse) {
   constexpr auto program = R"(
   fn main() {
     if (false) {
@@ -849,7 +1039,7 @@ TEST_F(ProgramTest, ConditionalBooleanLiteralFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalIntTrue) {
+TEST_P(ProgramTest, ConditionalIntTrue) {
   constexpr auto program = R"(
   fn main() {
     int value = 5;
@@ -863,7 +1053,7 @@ TEST_F(ProgramTest, ConditionalIntTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalIntFalse) {
+TEST_P(ProgramTest, ConditionalIntFalse) {
   constexpr auto program = R"(
   fn main() {
     int value = 0;
@@ -877,7 +1067,7 @@ TEST_F(ProgramTest, ConditionalIntFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalIntGreaterThanTrue) {
+TEST_P(ProgramTest, ConditionalIntGreaterThanTrue) {
   constexpr auto program = R"(
   fn main() {
     int value = 7;
@@ -891,7 +1081,7 @@ TEST_F(ProgramTest, ConditionalIntGreaterThanTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalIntVariablesGreaterThanTrue) {
+TEST_P(ProgramTest, ConditionalIntVariablesGreaterThanTrue) {
   constexpr auto program = R"(
   fn main() {
     int value1 = 7;
@@ -906,7 +1096,7 @@ TEST_F(ProgramTest, ConditionalIntVariablesGreaterThanTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalIntGreaterThanFalse) {
+TEST_P(ProgramTest, ConditionalIntGreaterThanFalse) {
   constexpr auto program = R"(
   fn main() {
     int value = 6;
@@ -920,7 +1110,7 @@ TEST_F(ProgramTest, ConditionalIntGreaterThanFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalIntVariablesGreaterThanFalse) {
+TEST_P(ProgramTest, ConditionalIntVariablesGreaterThanFalse) {
   constexpr auto program = R"(
   fn main() {
     int value1 = 6;
@@ -935,7 +1125,7 @@ TEST_F(ProgramTest, ConditionalIntVariablesGreaterThanFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalIntGreaterThanOrEqualTrue) {
+TEST_P(ProgramTest, ConditionalIntGreaterThanOrEqualTrue) {
   constexpr auto program = R"(
   fn main() {
     int value = 6;
@@ -949,7 +1139,7 @@ TEST_F(ProgramTest, ConditionalIntGreaterThanOrEqualTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalIntVariableGreaterThanOrEqualTrue) {
+TEST_P(ProgramTest, ConditionalIntVariableGreaterThanOrEqualTrue) {
   constexpr auto program = R"(
   fn main() {
     int value1 = 6;
@@ -964,7 +1154,7 @@ TEST_F(ProgramTest, ConditionalIntVariableGreaterThanOrEqualTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalIntGreaterThanOrEqualFalse) {
+TEST_P(ProgramTest, ConditionalIntGreaterThanOrEqualFalse) {
   constexpr auto program = R"(
   fn main() {
     int value = 5;
@@ -978,7 +1168,7 @@ TEST_F(ProgramTest, ConditionalIntGreaterThanOrEqualFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalIntVariablesGreaterThanOrEqualFalse) {
+TEST_P(ProgramTest, ConditionalIntVariablesGreaterThanOrEqualFalse) {
   constexpr auto program = R"(
   fn main() {
     int value1 = 5;
@@ -993,7 +1183,7 @@ TEST_F(ProgramTest, ConditionalIntVariablesGreaterThanOrEqualFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalIntLessTrue) {
+TEST_P(ProgramTest, ConditionalIntLessTrue) {
   constexpr auto program = R"(
   fn main() {
     int value = 5;
@@ -1007,7 +1197,7 @@ TEST_F(ProgramTest, ConditionalIntLessTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalIntVariablesLessTrue) {
+TEST_P(ProgramTest, ConditionalIntVariablesLessTrue) {
   constexpr auto program = R"(
   fn main() {
     int value1 = 5;
@@ -1022,7 +1212,7 @@ TEST_F(ProgramTest, ConditionalIntVariablesLessTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalIntLessFalse) {
+TEST_P(ProgramTest, ConditionalIntLessFalse) {
   constexpr auto program = R"(
   fn main() {
     int value = 7;
@@ -1036,7 +1226,7 @@ TEST_F(ProgramTest, ConditionalIntLessFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalIntVariablesLessFalse) {
+TEST_P(ProgramTest, ConditionalIntVariablesLessFalse) {
   constexpr auto program = R"(
   fn main() {
     int value1 = 7;
@@ -1051,7 +1241,7 @@ TEST_F(ProgramTest, ConditionalIntVariablesLessFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalIntLessOrEqualTrue) {
+TEST_P(ProgramTest, ConditionalIntLessOrEqualTrue) {
   constexpr auto program = R"(
   fn main() {
     int value = 6;
@@ -1065,7 +1255,7 @@ TEST_F(ProgramTest, ConditionalIntLessOrEqualTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalIntVariablesLessOrEqualTrue) {
+TEST_P(ProgramTest, ConditionalIntVariablesLessOrEqualTrue) {
   constexpr auto program = R"(
   fn main() {
     int value1 = 6;
@@ -1080,7 +1270,7 @@ TEST_F(ProgramTest, ConditionalIntVariablesLessOrEqualTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalIntLessOrEqualFalse) {
+TEST_P(ProgramTest, ConditionalIntLessOrEqualFalse) {
   constexpr auto program = R"(
   fn main() {
     int value = 10;
@@ -1094,7 +1284,7 @@ TEST_F(ProgramTest, ConditionalIntLessOrEqualFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalIntVariablesLessOrEqualFalse) {
+TEST_P(ProgramTest, ConditionalIntVariablesLessOrEqualFalse) {
   constexpr auto program = R"(
   fn main() {
     int value1 = 10;
@@ -1109,7 +1299,7 @@ TEST_F(ProgramTest, ConditionalIntVariablesLessOrEqualFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalIntEqualTrue) {
+TEST_P(ProgramTest, ConditionalIntEqualTrue) {
   constexpr auto program = R"(
   fn main() {
     int value = 6;
@@ -1123,7 +1313,7 @@ TEST_F(ProgramTest, ConditionalIntEqualTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalBooleanEqualTrue) {
+TEST_P(ProgramTest, ConditionalBooleanEqualTrue) {
   constexpr auto program = R"(
   fn main() {
     bool value = true;
@@ -1137,7 +1327,7 @@ TEST_F(ProgramTest, ConditionalBooleanEqualTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalIntVariablesEqualTrue) {
+TEST_P(ProgramTest, ConditionalIntVariablesEqualTrue) {
   constexpr auto program = R"(
   fn main() {
     int value1 = 6;
@@ -1152,7 +1342,7 @@ TEST_F(ProgramTest, ConditionalIntVariablesEqualTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalBooleanVariablesEqualTrue) {
+TEST_P(ProgramTest, ConditionalBooleanVariablesEqualTrue) {
   constexpr auto program = R"(
   fn main() {
     bool value1 = true;
@@ -1167,7 +1357,7 @@ TEST_F(ProgramTest, ConditionalBooleanVariablesEqualTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalIntEqualFalse) {
+TEST_P(ProgramTest, ConditionalIntEqualFalse) {
   constexpr auto program = R"(
   fn main() {
     int value = 7;
@@ -1181,7 +1371,7 @@ TEST_F(ProgramTest, ConditionalIntEqualFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalBooleanEqualFalse) {
+TEST_P(ProgramTest, ConditionalBooleanEqualFalse) {
   constexpr auto program = R"(
   fn main() {
     bool value = true;
@@ -1195,7 +1385,7 @@ TEST_F(ProgramTest, ConditionalBooleanEqualFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalIntVariablesEqualFalse) {
+TEST_P(ProgramTest, ConditionalIntVariablesEqualFalse) {
   constexpr auto program = R"(
   fn main() {
     int value1 = 7;
@@ -1210,7 +1400,7 @@ TEST_F(ProgramTest, ConditionalIntVariablesEqualFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalBooleanVariablesEqualFalse) {
+TEST_P(ProgramTest, ConditionalBooleanVariablesEqualFalse) {
   constexpr auto program = R"(
   fn main() {
     bool value1 = true;
@@ -1225,7 +1415,7 @@ TEST_F(ProgramTest, ConditionalBooleanVariablesEqualFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalIntNotEqualTrue) {
+TEST_P(ProgramTest, ConditionalIntNotEqualTrue) {
   constexpr auto program = R"(
   fn main() {
     int value = 5;
@@ -1239,7 +1429,7 @@ TEST_F(ProgramTest, ConditionalIntNotEqualTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalBooleanNotEqualTrue) {
+TEST_P(ProgramTest, ConditionalBooleanNotEqualTrue) {
   constexpr auto program = R"(
   fn main() {
     bool value = true;
@@ -1253,7 +1443,7 @@ TEST_F(ProgramTest, ConditionalBooleanNotEqualTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalIntVariablesNotEqualTrue) {
+TEST_P(ProgramTest, ConditionalIntVariablesNotEqualTrue) {
   constexpr auto program = R"(
   fn main() {
     int value1 = 5;
@@ -1268,7 +1458,7 @@ TEST_F(ProgramTest, ConditionalIntVariablesNotEqualTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalBooleanVariablesNotEqualTrue) {
+TEST_P(ProgramTest, ConditionalBooleanVariablesNotEqualTrue) {
   constexpr auto program = R"(
   fn main() {
     bool value1 = true;
@@ -1283,7 +1473,7 @@ TEST_F(ProgramTest, ConditionalBooleanVariablesNotEqualTrue) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "true");
 }
 
-TEST_F(ProgramTest, ConditionalIntNotEqualFalse) {
+TEST_P(ProgramTest, ConditionalIntNotEqualFalse) {
   constexpr auto program = R"(
   fn main() {
     int value = 6;
@@ -1297,7 +1487,7 @@ TEST_F(ProgramTest, ConditionalIntNotEqualFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalBooleanNotEqualFalse) {
+TEST_P(ProgramTest, ConditionalBooleanNotEqualFalse) {
   constexpr auto program = R"(
   fn main() {
     bool value = true;
@@ -1311,7 +1501,7 @@ TEST_F(ProgramTest, ConditionalBooleanNotEqualFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalIntVariablesNotEqualFalse) {
+TEST_P(ProgramTest, ConditionalIntVariablesNotEqualFalse) {
   constexpr auto program = R"(
   fn main() {
     int value1 = 6;
@@ -1326,7 +1516,7 @@ TEST_F(ProgramTest, ConditionalIntVariablesNotEqualFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalBooleanVariablesNotEqualFalse) {
+TEST_P(ProgramTest, ConditionalBooleanVariablesNotEqualFalse) {
   constexpr auto program = R"(
   fn main() {
     bool value1 = true;
@@ -1341,7 +1531,7 @@ TEST_F(ProgramTest, ConditionalBooleanVariablesNotEqualFalse) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "false");
 }
 
-TEST_F(ProgramTest, ConditionalBooleanFollowup) {
+TEST_P(ProgramTest, ConditionalBooleanFollowup) {
   constexpr auto program = R"(
   fn main() {
     bool value1 = true;
@@ -1361,7 +1551,7 @@ TEST_F(ProgramTest, ConditionalBooleanFollowup) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "truetruetrue");
 }
 
-TEST_F(ProgramTest, ConditionalBooleanNested) {
+TEST_P(ProgramTest, ConditionalBooleanNested) {
   constexpr auto program = R"(
   fn main() {
     bool value1 = true;
@@ -1385,7 +1575,7 @@ TEST_F(ProgramTest, ConditionalBooleanNested) {
 // For loops
 // ----------------------------------------------------
 
-TEST_F(ProgramTest, ForLoopPrintStrings) {
+TEST_P(ProgramTest, ForLoopPrintStrings) {
   constexpr auto program = R"(
   fn main() {
     for (int i = 1; i <= 3; i = i + 1) {
@@ -1396,7 +1586,7 @@ TEST_F(ProgramTest, ForLoopPrintStrings) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "hellohellohello");
 }
 
-TEST_F(ProgramTest, ForLoopPrintIncrement) {
+TEST_P(ProgramTest, ForLoopPrintIncrement) {
   constexpr auto program = R"(
   fn main() {
     for (int i = 1; i < 65; i = i * 2) {
@@ -1407,7 +1597,7 @@ TEST_F(ProgramTest, ForLoopPrintIncrement) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "1248163264");
 }
 
-TEST_F(ProgramTest, ForLoopFollowup) {
+TEST_P(ProgramTest, ForLoopFollowup) {
   constexpr auto program = R"(
   fn main() {
     for (int i = 0; i < 3; i = i + 1) {
@@ -1425,7 +1615,7 @@ TEST_F(ProgramTest, ForLoopFollowup) {
   );
 }
 
-TEST_F(ProgramTest, ForLoopFactorial) {
+TEST_P(ProgramTest, ForLoopFactorial) {
   constexpr auto program = R"(
   fn factorial(n: int) -> int {
     int res = 1;
@@ -1441,7 +1631,7 @@ TEST_F(ProgramTest, ForLoopFactorial) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "479001600");
 }
 
-TEST_F(ProgramTest, ForLoopFibonacci) {
+TEST_P(ProgramTest, ForLoopFibonacci) {
   constexpr auto program = R"(
   fn fibonacci(n: int) -> int {
     if (n <= 1) {
@@ -1463,7 +1653,7 @@ TEST_F(ProgramTest, ForLoopFibonacci) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "4181");
 }
 
-TEST_F(ProgramTest, ForLoopBreak) {
+TEST_P(ProgramTest, ForLoopBreak) {
   constexpr auto program = R"(
   fn main() {
     for (int i = 0; i < 1000000; i = i + 1) {
@@ -1482,7 +1672,7 @@ TEST_F(ProgramTest, ForLoopBreak) {
 // While loops
 // ----------------------------------------------------
 
-TEST_F(ProgramTest, WhileLoopPrintStrings) {
+TEST_P(ProgramTest, WhileLoopPrintStrings) {
   constexpr auto program = R"(
   fn main() {
     int i = 1;
@@ -1495,7 +1685,7 @@ TEST_F(ProgramTest, WhileLoopPrintStrings) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "hellohellohello");
 }
 
-TEST_F(ProgramTest, WhileLoopPrintIncrement) {
+TEST_P(ProgramTest, WhileLoopPrintIncrement) {
   constexpr auto program = R"(
   fn main() {
     int i = 1;
@@ -1508,7 +1698,7 @@ TEST_F(ProgramTest, WhileLoopPrintIncrement) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "1248163264");
 }
 
-TEST_F(ProgramTest, WhileLoopFollowup) {
+TEST_P(ProgramTest, WhileLoopFollowup) {
   constexpr auto program = R"(
   fn main() {
     int i = 0;
@@ -1530,7 +1720,7 @@ TEST_F(ProgramTest, WhileLoopFollowup) {
   );
 }
 
-TEST_F(ProgramTest, WhileLoopFactorial) {
+TEST_P(ProgramTest, WhileLoopFactorial) {
   constexpr auto program = R"(
   fn factorial(n: int) -> int {
     int res = 1;
@@ -1548,7 +1738,7 @@ TEST_F(ProgramTest, WhileLoopFactorial) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "479001600");
 }
 
-TEST_F(ProgramTest, WhileLoopFibonacci) {
+TEST_P(ProgramTest, WhileLoopFibonacci) {
   constexpr auto program = R"(
   fn fibonacci(n: int) -> int {
     if (n <= 1) {
@@ -1572,7 +1762,7 @@ TEST_F(ProgramTest, WhileLoopFibonacci) {
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "4181");
 }
 
-TEST_F(ProgramTest, WhileLoopBreak) {
+TEST_P(ProgramTest, WhileLoopBreak) {
   constexpr auto program = R"(
   fn main() {
     int i = 0;
@@ -1588,3 +1778,28 @@ TEST_F(ProgramTest, WhileLoopBreak) {
   SetUp(program);
   EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "012345yay!");
 }
+
+TEST_P(ProgramTest, WhileLoopCarriedVariable) {
+  constexpr auto program = R"(
+  fn main() {
+    int x = 7;
+    int i = 0;
+    while (i < 5) {
+      print(x);
+      int y = i * 10;
+      x = y;
+      i = i + 1;
+    }
+  })"sv;
+  SetUp(program);
+  EXPECT_PROGRAM_OUTPUT(exec("./a.out"), "70102030");
+}
+
+// Every program behaves the same whichever way its registers are allocated
+INSTANTIATE_TEST_SUITE_P(RegisterAllocation, ProgramTest,
+                         testing::Values(RegisterAllocator::Algorithm::LINEAR_SCAN,
+                                         RegisterAllocator::Algorithm::GRAPH_COLORING),
+                         [](const auto &info) {
+                           return info.param == RegisterAllocator::Algorithm::LINEAR_SCAN ? "LinearScan"
+                                                                                           : "GraphColoring";
+                         });
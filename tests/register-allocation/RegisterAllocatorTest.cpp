@@ -2,12 +2,17 @@
 // SPDX-License-Identifier: GPL-3.0
 
 #include <gtest/gtest.h>
+#include <chrono>
+#include <map>
+#include <ranges>
 // Wisnia
 #include "AST.hpp"
 #include "IRGenerator.hpp"
 #include "Instruction.hpp"
 #include "Lexer.hpp"
+#include "Modules.hpp"
 #include "Parser.hpp"
+#include "RegisterAllocator.hpp"
 #include "SemanticAnalysis.hpp"
 
 using namespace Wisnia;
@@ -25,6 +30,10 @@ class RegisterAllocatorTestFixture : public testing::Test {
     root->accept(m_generator);
   }
 
+  void TearDown() override {
+    Modules::markAllAsUnused();
+  }
+
  protected:
   IRGenerator m_generator{};
 
@@ -52,54 +61,478 @@ TEST_F(RegisterAllocatorTest, RegisterForEachVariable) {
     int m = 13;
     int n = 14;
     int o = 15;
-    int p = 16; // expected to be spilled
-    int r = 17; // expected to be spilled
+    int p = 16;
+    int r = 17;
     int sum = a + b + c + d + e + f + g + h + i + j + k + l + m + n + o + p + r;
   })"sv;
   SetUp(program.data());
   constexpr auto registers = RegisterAllocator::getAllocatableRegisters;
   const auto &instructions = m_generator.getInstructions(IRGenerator::Transformation::INSTRUCTION_OPTIMIZATION);
 
-  // 16 assigned registers
-  for (size_t i = 0; i < registers.size(); i++) {
-    const auto &op  = instructions[i]->getOperation();
-    const auto &var = instructions[i]->getTarget();
-    const auto &arg = instructions[i]->getArg1();
+  // The variables are given a register each while there are any left
+  const auto assigned = std::min<size_t>(registers.size(), 17);
+  for (size_t i = 0; i < assigned; i++) {
+    const auto op  = instructions[i].getOperation();
+    const auto var = instructions[i].getTarget();
+    const auto arg = instructions[i].getArg1();
     EXPECT_EQ(op, Operation::MOV);
-    EXPECT_EQ(var->getType(), TType::REGISTER);
-    EXPECT_EQ(var->getValue<Basic::register_t>(), registers[i]);
-    EXPECT_EQ(arg->getType(), TType::LIT_INT);
-    EXPECT_EQ(arg->getValue<int>(), i + 1);
+    EXPECT_EQ(var.getType(), TType::REGISTER);
+    EXPECT_EQ(var.getValue<Basic::register_t>(), registers[i]);
+    EXPECT_EQ(arg.getType(), TType::LIT_INT);
+    EXPECT_EQ(arg.getValue<int>(), i + 1);
   }
 
-  // 2 spilled registers
-
-  EXPECT_EQ(instructions[15]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[15]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[15]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::SPILLED);
-  EXPECT_EQ(instructions[15]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[15]->getArg1()->getValue<int>(), 16);
-
-  EXPECT_EQ(instructions[16]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[16]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[16]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::SPILLED);
-  EXPECT_EQ(instructions[16]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[16]->getArg1()->getValue<int>(), 17);
+  // The rest hold constants, which are added to the sum as they are instead of being kept on the stack.
+  // Only the additions of main, which comes before the modules
+  const auto end = std::ranges::find(instructions, Operation::LABEL, &Instruction::getOperation);
+  for (size_t i = assigned; i < 17; i++) {
+    EXPECT_EQ(std::count_if(instructions.begin(), end, [&](const Instruction &instruction) {
+      return instruction.getOperation() == Operation::IADD && instruction.getArg1().getType() == TType::LIT_INT &&
+             instruction.getArg1().getValue<int>() == static_cast<int>(i + 1);
+    }), 1);
+  }
+  EXPECT_TRUE(std::ranges::none_of(instructions, [](const Instruction &instruction) {
+    return instruction.getOperation() == Operation::LOAD || instruction.getOperation() == Operation::STORE;
+  }));
+  EXPECT_TRUE(std::ranges::none_of(instructions, [](const Instruction &instruction) {
+    return std::ranges::any_of(std::views::iota(size_t{0}, Instruction::kOperands), [&](const size_t i) {
+      const auto operand = instruction.getOperand(i);
+      return operand.getType() == TType::REGISTER && operand.getValue<Basic::register_t>() == SPILLED;
+    });
+  }));
 
   // then goes the last 3 instructions marking the end of the program
 
   // xor rdi, rdi
-  EXPECT_EQ(instructions[instructions.size() - 3]->getOperation(), Operation::XOR);
-  EXPECT_EQ(instructions[instructions.size() - 3]->getArg1()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[instructions.size() - 3]->getArg1()->getValue<Basic::register_t>(), Basic::register_t::RDI);
-  EXPECT_EQ(instructions[instructions.size() - 3]->getArg2()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[instructions.size() - 3]->getArg2()->getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[instructions.size() - 3].getOperation(), Operation::XOR);
+  EXPECT_EQ(instructions[instructions.size() - 3].getArg1().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[instructions.size() - 3].getArg1().getValue<Basic::register_t>(), Basic::register_t::RDI);
+  EXPECT_EQ(instructions[instructions.size() - 3].getArg2().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[instructions.size() - 3].getArg2().getValue<Basic::register_t>(), Basic::register_t::RDI);
   // mov rax, 0x3c
-  EXPECT_EQ(instructions[instructions.size() - 2]->getOperation(), Operation::MOV);
-  EXPECT_EQ(instructions[instructions.size() - 2]->getTarget()->getType(), TType::REGISTER);
-  EXPECT_EQ(instructions[instructions.size() - 2]->getTarget()->getValue<Basic::register_t>(), Basic::register_t::RAX);
-  EXPECT_EQ(instructions[instructions.size() - 2]->getArg1()->getType(), TType::LIT_INT);
-  EXPECT_EQ(instructions[instructions.size() - 2]->getArg1()->getValue<int>(), 60);
+  EXPECT_EQ(instructions[instructions.size() - 2].getOperation(), Operation::MOV);
+  EXPECT_EQ(instructions[instructions.size() - 2].getTarget().getType(), TType::REGISTER);
+  EXPECT_EQ(instructions[instructions.size() - 2].getTarget().getValue<Basic::register_t>(), Basic::register_t::RAX);
+  EXPECT_EQ(instructions[instructions.size() - 2].getArg1().getType(), TType::LIT_INT);
+  EXPECT_EQ(instructions[instructions.size() - 2].getArg1().getValue<int>(), 60);
   // syscall
-  EXPECT_EQ(instructions[instructions.size() - 1]->getOperation(), Operation::SYSCALL);
+  EXPECT_EQ(instructions[instructions.size() - 1].getOperation(), Operation::SYSCALL);
+}
+
+TEST_F(RegisterAllocatorTest, SaveOnlyRegistersLiveAcrossCall) {
+  constexpr auto program = R"(
+  fn foo(value: int) -> int {
+    int x = value * 2;
+    int y = value * 3;
+    return x + y;
+  }
+  fn main() {
+    int a = 1;
+    int b = 2;
+    int c = foo(a);
+    print(b + c);
+  })"sv;
+  SetUp(program.data());
+  const auto &instructions = m_generator.getInstructions(IRGenerator::Transformation::REGISTER_ALLOCATION);
+  const auto reg = [](const Operand &operand) {
+    EXPECT_EQ(operand.getType(), TType::REGISTER);
+    return operand.getValue<Basic::register_t>();
+  };
+  const auto call = static_cast<size_t>(std::ranges::find_if(instructions, [](const Instruction &instruction) {
+    return instruction.getOperation() == Operation::CALL && instruction.getTarget().getValue<std::string>() == "foo";
+  }) - instructions.begin());
+  ASSERT_EQ(call, 7);
+
+  // _t0 <- 1; a <- _t0; _t1 <- 2; b <- _t1
+  const auto b = reg(instructions[3].getTarget());
+  // `a` isn't needed after the call, so only `b` is saved, as `foo` overwrites its register
+  EXPECT_TRUE(m_generator.getRegisterAllocator().getClobberedRegisters("foo").test(b));
+  // push b
+  EXPECT_EQ(instructions[4].getOperation(), Operation::PUSH);
+  EXPECT_EQ(reg(instructions[4].getArg1()), b);
+  // _t2 <- a; rdi <- _t2
+  EXPECT_EQ(instructions[5].getOperation(), Operation::MOV);
+  EXPECT_EQ(reg(instructions[5].getTarget()), RDI);
+  EXPECT_EQ(instructions[6].getOperation(), Operation::MOV);
+  EXPECT_EQ(reg(instructions[6].getTarget()), RDI);
+  // call foo
+  // _t3 <- rax
+  EXPECT_EQ(instructions[8].getOperation(), Operation::MOV);
+  EXPECT_EQ(reg(instructions[8].getArg1()), RAX);
+  EXPECT_NE(reg(instructions[8].getTarget()), b);
+  // pop b
+  EXPECT_EQ(instructions[9].getOperation(), Operation::POP);
+  EXPECT_EQ(reg(instructions[9].getArg1()), b);
+  // c <- _t3
+  EXPECT_EQ(instructions[10].getOperation(), Operation::MOV);
+  EXPECT_EQ(reg(instructions[10].getArg1()), reg(instructions[8].getTarget()));
+}
+
+TEST_F(RegisterAllocatorTest, SkipSavingRegistersTheCalleeKeeps) {
+  constexpr auto program = R"(
+  fn foo(value: int) -> int {
+    return value + 1;
+  }
+  fn main() {
+    int a = 1;
+    int b = 2;
+    int c = foo(a);
+    print(b + c);
+  })"sv;
+  SetUp(program.data());
+  const auto &instructions = m_generator.getInstructions(IRGenerator::Transformation::REGISTER_ALLOCATION);
+  const auto call = std::ranges::find_if(instructions, [](const Instruction &instruction) {
+    return instruction.getOperation() == Operation::CALL && instruction.getTarget().getValue<std::string>() == "foo";
+  });
+  ASSERT_NE(call, instructions.end());
+
+  // `foo` only computes its result in `rax`, so `b` stays in its register across the call
+  const auto clobbers = m_generator.getRegisterAllocator().getClobberedRegisters("foo");
+  EXPECT_EQ(clobbers, RegisterAllocator::RegisterSet{}.set(RAX));
+  EXPECT_FALSE(clobbers.test(instructions[3].getTarget().getValue<Basic::register_t>()));
+  EXPECT_TRUE(std::none_of(instructions.begin(), call, [](const Instruction &instruction) {
+    return instruction.getOperation() == Operation::PUSH;
+  }));
+  EXPECT_NE(std::next(call)->getOperation(), Operation::POP);
+}
+
+TEST_F(RegisterAllocatorTest, ClobberedRegistersIncludeTheCalledFunctions) {
+  constexpr auto program = R"(
+  fn leaf(value: int) -> int {
+    int x = value * 2;
+    int y = value * 3;
+    return x + y;
+  }
+  fn countdown(value: int) -> int {
+    if (value < 1) {
+      return leaf(value);
+    }
+    return countdown(value - 1);
+  }
+  fn main() {
+    print(countdown(3));
+  })"sv;
+  SetUp(program.data());
+  const auto &allocator = m_generator.getRegisterAllocator();
+  const auto leaf = allocator.getClobberedRegisters("leaf");
+  const auto countdown = allocator.getClobberedRegisters("countdown");
+
+  // The recursive call reaches the fixpoint with what `leaf` overwrites
+  EXPECT_TRUE(leaf.any());
+  EXPECT_EQ(leaf & countdown, leaf);
+  EXPECT_FALSE(countdown.test(RSP));
+
+  // The module pushes the registers it uses and pops them back, except for `rdi`, which it
+  // overwrites with the arguments of its system call
+  const auto print = allocator.getClobberedRegisters("__builtin_print_number");
+  EXPECT_TRUE(print.test(RDI));
+  EXPECT_FALSE(print.test(RAX));
+  EXPECT_FALSE(print.test(RDX));
+
+  // Nothing is known about a function that wasn't allocated
+  EXPECT_TRUE(allocator.getClobberedRegisters("unknown").all());
+}
+
+TEST_F(RegisterAllocatorTest, SpillVariablesOutsideLoops) {
+  constexpr auto program = R"(
+  fn compute(x: int) -> int {
+    int o1 = x + 1;
+    int o2 = x + 2;
+    int o3 = x + 3;
+    int o4 = x + 4;
+    int o5 = x + 5;
+    int l1 = x + 1;
+    int l2 = x + 2;
+    int l3 = x + 3;
+    int l4 = x + 4;
+    int l5 = x + 5;
+    int l6 = x + 6;
+    int l7 = x + 7;
+    int l8 = x + 8;
+    int l9 = x + 9;
+    int l10 = x + 10;
+    int l11 = x + 11;
+    int l12 = x + 12;
+    int total = 0;
+    for (int i = 0; i < 100; i = i + 1) {
+      total = total + l1 + l2 + l3 + l4 + l5 + l6 + l7 + l8 + l9 + l10 + l11 + l12;
+    }
+    return total + o1 + o2 + o3 + o4 + o5;
+  }
+  fn main() {
+    print(compute(0));
+  })"sv;
+  SetUp(program.data());
+  const auto &instructions = m_generator.getInstructions(IRGenerator::Transformation::REGISTER_ALLOCATION);
+  const auto isStackSlot = [](const Instruction &instruction) {
+    return instruction.getOperation() == Operation::LOAD || instruction.getOperation() == Operation::STORE;
+  };
+  const auto findLabel = [&](std::string_view label) {
+    return std::ranges::find_if(instructions, [&](const Instruction &instruction) {
+      return instruction.getOperation() == Operation::LABEL &&
+             instruction.getArg1().getValue<std::string_view>() == label;
+    });
+  };
+  const auto body = findLabel(".L1_for_body");
+  const auto end = findLabel(".L1_for_end");
+  ASSERT_LT(body, end);
+
+  // The variables used only after the loop are the ones kept on the stack
+  EXPECT_EQ(std::count_if(instructions.begin(), body, isStackSlot), 4);
+  EXPECT_TRUE(std::none_of(body, end, isStackSlot));
+  EXPECT_EQ(std::count_if(end, instructions.end(), isStackSlot), 4);
+}
+
+TEST_F(RegisterAllocatorTest, RematerializeConstantsInsteadOfSpilling) {
+  constexpr auto program = R"(
+  fn main() {
+    int o1 = 1;
+    int o2 = 2;
+    int o3 = 3;
+    int o4 = 4;
+    int o5 = 5;
+    int l1 = 1;
+    int l2 = 2;
+    int l3 = 3;
+    int l4 = 4;
+    int l5 = 5;
+    int l6 = 6;
+    int l7 = 7;
+    int l8 = 8;
+    int l9 = 9;
+    int l10 = 10;
+    int l11 = 11;
+    int l12 = 12;
+    int total = 0;
+    for (int i = 0; i < 100; i = i + 1) {
+      total = total + l1 + l2 + l3 + l4 + l5 + l6 + l7 + l8 + l9 + l10 + l11 + l12;
+    }
+    print(total + o1 + o2 + o3 + o4 + o5);
+  })"sv;
+  SetUp(program.data());
+  const auto &instructions = m_generator.getInstructions(IRGenerator::Transformation::REGISTER_ALLOCATION);
+
+  // The variables that hold constants are set to their literals again where they're read, so nothing
+  // is kept on the stack, and none of them is moved into a register before the loop just to wait there
+  EXPECT_TRUE(std::ranges::none_of(instructions, [](const Instruction &instruction) {
+    return instruction.getOperation() == Operation::LOAD || instruction.getOperation() == Operation::STORE;
+  }));
+  const auto body = std::ranges::find_if(instructions, [&](const Instruction &instruction) {
+    return instruction.getOperation() == Operation::LABEL &&
+           instruction.getArg1().getValue<std::string_view>() == ".L1_for_body";
+  });
+  ASSERT_NE(body, instructions.end());
+  EXPECT_LT(std::count_if(instructions.begin(), body, [](const Instruction &instruction) {
+    return instruction.getOperation() == Operation::MOV && instruction.getArg1().getType() == TType::LIT_INT;
+  }), 17);
+}
+
+TEST_F(RegisterAllocatorTest, SplitVariablesAroundLoops) {
+  constexpr auto program = R"(
+  fn compute(x: int) -> int {
+    int y = x + x * x;
+    int total = 0;
+    for (int i = 0; i < 100; i = i + 1) {
+      int a1 = i + 1;
+      int a2 = i + 2;
+      int a3 = i + 3;
+      int a4 = i + 4;
+      int a5 = i + 5;
+      int a6 = i + 6;
+      int a7 = i + 7;
+      int a8 = i + 8;
+      int a9 = i + 9;
+      int a10 = i + 10;
+      int a11 = i + 11;
+      int a12 = i + 12;
+      int a13 = i + 13;
+      int a14 = i + 14;
+      total = total + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10 + a11 + a12 + a13 + a14;
+    }
+    return total + y * x;
+  }
+  fn main() {
+    print(compute(3));
+  })"sv;
+  SetUp(program.data());
+  const auto &instructions = m_generator.getInstructions(IRGenerator::Transformation::REGISTER_ALLOCATION);
+  const auto findLabel = [&](std::string_view label) {
+    return std::ranges::find_if(instructions, [&](const Instruction &instruction) {
+      return instruction.getOperation() == Operation::LABEL &&
+             instruction.getArg1().getValue<std::string_view>() == label;
+    });
+  };
+  const auto body = findLabel(".L1_for_body");
+  const auto check = findLabel(".L1_for_check");
+  ASSERT_LT(body, check);
+
+  // The stores and the loads of each stack slot, before, inside and after the loop
+  struct Accesses {
+    int m_before{0}, m_inside{0}, m_after{0};
+  };
+  std::map<int, Accesses> slots{};
+  for (auto it = instructions.begin(); it != instructions.end(); ++it) {
+    if (it->getOperation() == Operation::STORE) {
+      auto &accesses = slots[it->getTarget().getValue<int>()];
+      (it < body ? accesses.m_before : it < check ? accesses.m_inside : accesses.m_after)++;
+    } else if (it->getOperation() == Operation::LOAD) {
+      auto &accesses = slots[it->getArg1().getValue<int>()];
+      (it < body ? accesses.m_before : it < check ? accesses.m_inside : accesses.m_after)++;
+    }
+  }
+
+  // `x` and `y` leave their registers to the loop: each is stored once on the way into it and loaded
+  // once on the way out, instead of being loaded at each of its uses
+  const auto split = std::ranges::count_if(slots, [](const auto &slot) { return slot.second.m_inside == 0; });
+  EXPECT_EQ(split, 2);
+  for (const auto &[offset, accesses] : slots) {
+    if (accesses.m_inside == 0) {
+      EXPECT_EQ(accesses.m_before, 1);
+      EXPECT_EQ(accesses.m_after, 1);
+    }
+  }
+}
+
+TEST_F(RegisterAllocatorTest, SplitBlocksAddressTheFrame) {
+  // f(x):
+  //     y <- x; y <- y + x; i <- 0
+  //     cmp x, 0; je .end          <- .end is reached from here and from the loop, which leaves `y`
+  //   .head:                          on the stack, so its load goes to a block of its own
+  //     cmp i, 100; jge .end
+  //     t1 <- i + 1; ... t15 <- i + 15; i <- i + t1 + ... + t15; jmp .head
+  //   .end:
+  //     rax <- y; ret
+  VirtualRegisters registers{};
+  const auto variable = [&](std::string_view name) {
+    return Operand{TType::IDENT_INT, registers.createVariable(StringInterner::global().intern(name))};
+  };
+  const auto label = [](std::string_view name) { return Operand{TType::IDENT_VOID, name}; };
+  const auto number = [](const int value) { return Operand{TType::LIT_INT, value}; };
+  const auto x = variable("x");
+  const auto y = variable("y");
+  const auto i = variable("i");
+  std::vector function{
+    Instruction{Operation::LABEL, Operand{}, label("f")},
+    Instruction{Operation::MOV, x, Operand{TType::REGISTER, Basic::register_t::RDI}},
+    Instruction{Operation::MOV, y, x},
+    Instruction{Operation::IADD, y, x},
+    Instruction{Operation::MOV, i, number(0)},
+    Instruction{Operation::CMP, Operand{}, x, number(0)},
+    Instruction{Operation::JE, Operand{}, label(".end")},
+    Instruction{Operation::LABEL, Operand{}, label(".head")},
+    Instruction{Operation::CMP, Operand{}, i, number(100)},
+    Instruction{Operation::JGE, Operand{}, label(".end")},
+  };
+  std::vector<Operand> temporaries{};
+  for (int k = 1; k <= 15; k++) {
+    const Operand t{TType::IDENT_INT, registers.createTemporary()};
+    function.emplace_back(Operation::MOV, t, i);
+    function.emplace_back(Operation::IADD, t, number(k));
+    temporaries.push_back(t);
+  }
+  for (const auto &t : temporaries) {
+    function.emplace_back(Operation::IADD, i, t);
+  }
+  function.emplace_back(Operation::JMP, Operand{}, label(".head"));
+  function.emplace_back(Operation::LABEL, Operand{}, label(".end"));
+  function.emplace_back(Operation::MOV, Operand{TType::REGISTER, Basic::register_t::RAX}, y);
+  function.emplace_back(Operation::RET);
+
+  RegisterAllocator allocator{registers};
+  allocator.allocate(function);
+  allocator.lowerCalls();
+  const auto &instructions = allocator.getInstructions();
+
+  ASSERT_TRUE(std::ranges::any_of(instructions, [](const Instruction &instruction) {
+    return instruction.getOperation() == Operation::LABEL &&
+           instruction.getArg1().getValue<std::string>().ends_with("_split");
+  }));
+  // The split block comes after the return, where the frame is still set up when it's jumped to
+  ASSERT_EQ(instructions[1].getOperation(), Operation::ISUB);
+  const auto frameSize = instructions[1].getArg1().getValue<int>();
+  for (const auto &instruction : instructions) {
+    if (instruction.getOperation() == Operation::LOAD) {
+      EXPECT_GE(instruction.getArg1().getValue<int>(), 0);
+      EXPECT_LT(instruction.getArg1().getValue<int>(), frameSize);
+    } else if (instruction.getOperation() == Operation::STORE) {
+      EXPECT_GE(instruction.getTarget().getValue<int>(), 0);
+      EXPECT_LT(instruction.getTarget().getValue<int>(), frameSize);
+    }
+  }
+}
+
+TEST_F(RegisterAllocatorTest, GraphColoringCoalescesCopies) {
+  // Each binary expression copies its left operand into a temporary, which can share the operand's
+  // register once the operand isn't needed anymore
+  constexpr auto program = R"(
+  fn main() {
+    int a = 1;
+    int b = a + 2;
+    int c = b * a;
+    int d = c - b;
+    print(d);
+  })"sv;
+  const auto countCopies = [&](const RegisterAllocator::Algorithm algorithm) {
+    std::istringstream iss{program.data()};
+    Lexer lexer{iss};
+    Parser parser{lexer};
+    const auto &root = parser.parse();
+    SemanticAnalysis analysis{};
+    root->accept(analysis);
+    IRGenerator generator{true, algorithm};
+    root->accept(generator);
+    const auto &instructions = generator.getInstructions(IRGenerator::Transformation::INSTRUCTION_OPTIMIZATION);
+    // Only the moves of main, which comes before the modules
+    const auto end = std::ranges::find(instructions, Operation::LABEL, &Instruction::getOperation);
+    return std::count_if(instructions.begin(), end, [](const Instruction &instruction) {
+      return instruction.getOperation() == Operation::MOV && instruction.getTarget().getType() == TType::REGISTER &&
+             instruction.getArg1().getType() == TType::REGISTER;
+    });
+  };
+  EXPECT_EQ(countCopies(RegisterAllocator::Algorithm::LINEAR_SCAN), 4);
+  EXPECT_EQ(countCopies(RegisterAllocator::Algorithm::GRAPH_COLORING), 2);
+}
+
+TEST_F(RegisterAllocatorTest, AllocationTimeGrowsLinearly) {
+  //   a = 0
+  //   t = a; t += k; cmp t, k; je .Lk; a = t; .Lk:    for each k
+  //   push a; ret
+  // A block for each k, with a temporary that stays in it and a variable live across all of them
+  VirtualRegisters registers{};
+  const Operand a{TType::IDENT_INT, registers.createVariable(StringInterner::global().intern("a"))};
+  const auto generate = [&](const int blocks) {
+    std::vector function{Instruction{Operation::MOV, a, Operand{TType::LIT_INT, 0}}};
+    for (int k = 0; k < blocks; k++) {
+      const Operand t{TType::IDENT_INT, registers.createTemporary()};
+      const Operand label{TType::IDENT_VOID, ".L" + std::to_string(k)};
+      const Operand number{TType::LIT_INT, k};
+      function.emplace_back(Operation::MOV, t, a);
+      function.emplace_back(Operation::IADD, t, number);
+      function.emplace_back(Operation::CMP, Operand{}, t, number);
+      function.emplace_back(Operation::JE, Operand{}, label);
+      function.emplace_back(Operation::MOV, a, t);
+      function.emplace_back(Operation::LABEL, Operand{}, label);
+    }
+    function.emplace_back(Operation::PUSH, Operand{}, a);
+    function.emplace_back(Operation::RET);
+    return function;
+  };
+  // The fastest of a few runs, to leave out the noise of other tests running at the same time
+  const auto measure = [&](const std::vector<Instruction> &function) {
+    auto fastest = std::chrono::steady_clock::duration::max();
+    for (int run = 0; run < 3; run++) {
+      RegisterAllocator allocator{registers};
+      const auto start = std::chrono::steady_clock::now();
+      allocator.allocate(function);
+      fastest = std::min(fastest, std::chrono::steady_clock::now() - start);
+      EXPECT_EQ(allocator.getInstructions().size(), function.size());
+    }
+    return std::chrono::duration<double>(fastest).count();
+  };
+
+  const auto quarter = generate(12'500 / 6);
+  const auto full = generate(50'000 / 6);
+  ASSERT_GE(full.size(), 50'000);
+  // Four times the instructions take about four times as long, where a quadratic allocator takes sixteen
+  EXPECT_LT(measure(full), 8 * measure(quarter));
 }
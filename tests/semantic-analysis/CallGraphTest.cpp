@@ -0,0 +1,94 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <gtest/gtest.h>
+// Wisnia
+#include "AST.hpp"
+#include "CallGraph.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "SemanticAnalysis.hpp"
+#include "StringInterner.hpp"
+
+using namespace Wisnia;
+using namespace std::literals;
+
+class CallGraphTest : public testing::Test {
+ protected:
+  void analyze(std::string_view program) {
+    std::istringstream iss{program.data()};
+    Lexer lexer{iss};
+    Parser parser{lexer};
+    m_root = parser.parse();
+    m_root->accept(m_analysis);
+  }
+
+  const CallGraph::Function &function(std::string_view name) const {
+    const auto index = m_analysis.getCallGraph().find(Basic::StringInterner::global().intern(name));
+    EXPECT_TRUE(index.has_value()) << name;
+    return m_analysis.getCallGraph().getFunction(*index);
+  }
+
+  std::vector<std::string_view> names(const std::vector<CallGraph::Index> &indices) const {
+    std::vector<std::string_view> result{};
+    for (const auto index : indices) {
+      result.push_back(Basic::StringInterner::global().lookup(m_analysis.getCallGraph().getFunction(index).m_symbol));
+    }
+    return result;
+  }
+
+  std::unique_ptr<AST::Root> m_root;
+  SemanticAnalysis m_analysis;
+};
+
+TEST_F(CallGraphTest, EdgesFollowCallSites) {
+  analyze(R"(
+  fn leaf() -> int { return 1; }
+  fn middle() -> int { return leaf() + leaf(); }
+  fn unused() {}
+  fn main() {
+    int a = middle();
+    print(leaf());
+  }
+  )"sv);
+
+  const auto &graph = m_analysis.getCallGraph();
+  ASSERT_EQ(graph.getFunctions().size(), 4);
+  EXPECT_EQ(graph.getFunctions()[0].m_definition->getVariable()->getToken()->getValue<std::string>(), "leaf");
+
+  EXPECT_EQ(names(function("main").m_callees), (std::vector{"middle"sv, "leaf"sv}));
+  EXPECT_EQ(names(function("middle").m_callees), (std::vector{"leaf"sv, "leaf"sv}));
+  EXPECT_EQ(names(function("leaf").m_callers), (std::vector{"middle"sv, "middle"sv, "main"sv}));
+  EXPECT_TRUE(function("leaf").isCalled());
+  EXPECT_FALSE(function("unused").isCalled());
+  EXPECT_FALSE(function("main").isCalled());
+  EXPECT_FALSE(graph.find(Basic::StringInterner::global().intern("not_a_function")).has_value());
+}
+
+TEST_F(CallGraphTest, RecursiveCalls) {
+  analyze(R"(
+  fn countdown(n: int) -> int {
+    if (n > 0) { return countdown(n - 1); }
+    return n;
+  }
+  fn main() { print(countdown(3)); }
+  )"sv);
+
+  EXPECT_EQ(names(function("countdown").m_callees), (std::vector{"countdown"sv}));
+  EXPECT_EQ(names(function("countdown").m_callers), (std::vector{"countdown"sv, "main"sv}));
+}
+
+TEST_F(CallGraphTest, CallsBeforeDefinitionAreRejected) {
+  EXPECT_THROW(analyze(R"(
+  fn main() { later(); }
+  fn later() {}
+  )"sv), SemanticError);
+}
+
+TEST_F(CallGraphTest, RedefinitionsAreRejected) {
+  EXPECT_THROW(analyze(R"(
+  fn twice() {}
+  fn main() { twice(); }
+  fn twice() {}
+  )"sv), SemanticError);
+}
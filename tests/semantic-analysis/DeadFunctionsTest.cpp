@@ -0,0 +1,81 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <gtest/gtest.h>
+// Wisnia
+#include "AST.hpp"
+#include "DeadFunctions.hpp"
+#include "Instruction.hpp"
+#include "IRGenerator.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+#include "SemanticAnalysis.hpp"
+
+using namespace Wisnia;
+using namespace std::literals;
+
+namespace {
+constexpr auto kProgram = R"(
+  fn helper() -> int { return 2; }
+  fn used() -> int { return helper() * 3; }
+  fn only_called_by_dead() -> int { return 4; }
+  fn dead() -> int { return only_called_by_dead(); }
+  fn ping(n: int) -> int { if (n > 0) { return ping(n - 1); } return 0; }
+  fn main() {
+    print(used());
+  }
+)"sv;
+
+std::unique_ptr<AST::Root> parse(SemanticAnalysis &analysis) {
+  std::istringstream iss{kProgram.data()};
+  Lexer lexer{iss};
+  Parser parser{lexer};
+  auto root = parser.parse();
+  root->accept(analysis);
+  return root;
+}
+
+std::vector<std::string> functionNames(const AST::Root &root) {
+  std::vector<std::string> names{};
+  for (const auto &function : root.getGlobalFunctions()) {
+    names.push_back(dynamic_cast<const AST::FnDef &>(*function).getVariable()->getToken()->getValue<std::string>());
+  }
+  return names;
+}
+
+std::vector<std::string> labels(AST::Root &root) {
+  IRGenerator generator{false};
+  root.accept(generator);
+  std::vector<std::string> names{};
+  for (const auto &instruction : generator.getInstructions(IRGenerator::Transformation::NONE)) {
+    if (instruction.getOperation() == Operation::LABEL) {
+      names.push_back(instruction.getArg1().getValue<std::string>());
+    }
+  }
+  return names;
+}
+}  // namespace
+
+TEST(DeadFunctionsTest, UnreachableFunctionsAreRemoved) {
+  SemanticAnalysis analysis;
+  const auto root = parse(analysis);
+  EXPECT_EQ(eliminateDeadFunctions(*root, analysis.getCallGraph()), 3);
+  EXPECT_EQ(functionNames(*root), (std::vector<std::string>{"helper", "used", "main"}));
+}
+
+TEST(DeadFunctionsTest, NoCodeIsGeneratedForThem) {
+  SemanticAnalysis keptAnalysis;
+  const auto kept = parse(keptAnalysis);
+  SemanticAnalysis prunedAnalysis;
+  const auto pruned = parse(prunedAnalysis);
+  eliminateDeadFunctions(*pruned, prunedAnalysis.getCallGraph());
+
+  // Every function but main starts with a label of its name
+  const auto keptLabels = labels(*kept);
+  const auto prunedLabels = labels(*pruned);
+  for (const auto name : {"dead", "only_called_by_dead", "ping"}) {
+    EXPECT_NE(std::find(keptLabels.begin(), keptLabels.end(), name), keptLabels.end()) << name;
+    EXPECT_EQ(std::find(prunedLabels.begin(), prunedLabels.end(), name), prunedLabels.end()) << name;
+  }
+  EXPECT_LT(prunedLabels.size(), keptLabels.size());
+}
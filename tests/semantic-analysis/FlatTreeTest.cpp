@@ -0,0 +1,61 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <algorithm>
+// Wisnia
+#include "AST.hpp"
+#include "FlatTree.hpp"
+#include "Lexer.hpp"
+#include "NodeCollector.hpp"
+#include "SemanticTestFixture.hpp"
+
+using namespace Wisnia;
+using FlatTreeTest = SemanticTestFixture;
+
+namespace {
+template <typename T>
+void expectSameNodes(AST::Root &root, const AST::FlatTree &tree) {
+  NodeCollector<T> collector;
+  root.accept(collector);
+  EXPECT_EQ(tree.collect<T>(), collector.getNodes());
+}
+}  // namespace
+
+TEST_F(FlatTreeTest, ChildrenAreLaidOutTogether) {
+  const AST::FlatTree tree{*m_root};
+  ASSERT_GT(tree.size(), 1);
+  EXPECT_EQ(tree.kind(AST::FlatTree::kRoot), AST::NodeKind::ROOT);
+  EXPECT_EQ(tree.token(AST::FlatTree::kRoot), nullptr);
+
+  const auto topLevel = tree.children(AST::FlatTree::kRoot);
+  ASSERT_EQ(topLevel.size(), 3);
+  EXPECT_EQ(tree.kind(topLevel[0]), AST::NodeKind::CLASS_DEF);
+  EXPECT_EQ(tree.kind(topLevel[1]), AST::NodeKind::FN_DEF);
+  EXPECT_EQ(tree.kind(topLevel[2]), AST::NodeKind::FN_DEF);
+  EXPECT_EQ(tree.token(tree.child(topLevel[2], 0))->getValue<std::string>(), "main");
+
+  // Every node but the root is the child of exactly one other node
+  std::vector<size_t> parents(tree.size(), 0);
+  for (AST::FlatTree::NodeId id = 0; id < tree.size(); ++id) {
+    for (const auto child : tree.children(id)) {
+      ASSERT_LT(child, tree.size());
+      ++parents[child];
+    }
+  }
+  EXPECT_EQ(parents[AST::FlatTree::kRoot], 0);
+  EXPECT_TRUE(std::all_of(parents.begin() + 1, parents.end(), [](const size_t count) { return count == 1; }));
+}
+
+TEST_F(FlatTreeTest, CollectsLikeNodeCollector) {
+  const AST::FlatTree tree{*m_root};
+  expectSameNodes<AST::ClassDef>(*m_root, tree);
+  expectSameNodes<AST::Field>(*m_root, tree);
+  expectSameNodes<AST::FnDef>(*m_root, tree);
+  expectSameNodes<AST::Param>(*m_root, tree);
+  expectSameNodes<AST::VarExpr>(*m_root, tree);
+  expectSameNodes<AST::VarAssignStmt>(*m_root, tree);
+  expectSameNodes<AST::CompExpr>(*m_root, tree);
+  expectSameNodes<AST::FnCallExpr>(*m_root, tree);
+  expectSameNodes<AST::ElseIfStmt>(*m_root, tree);
+  expectSameNodes<AST::StringExpr>(*m_root, tree);
+}
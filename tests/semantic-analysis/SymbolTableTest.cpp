@@ -0,0 +1,71 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <gtest/gtest.h>
+// Wisnia
+#include "AST.hpp"
+#include "StringInterner.hpp"
+#include "SymbolTable.hpp"
+#include "Token.hpp"
+
+using namespace Wisnia;
+using namespace Basic;
+using namespace std::literals;
+
+namespace {
+AST::VarExpr makeVar(const std::string &name) {
+  return AST::VarExpr{std::make_shared<Token>(TType::IDENT, name)};
+}
+}  // namespace
+
+TEST(StringInternerTest, SameTextSameSymbol) {
+  auto &interner = StringInterner::global();
+  const SymbolId first = interner.intern("interned_name");
+  EXPECT_EQ(interner.intern("interned_name"s), first);
+  EXPECT_NE(interner.intern("interned_other_name"), first);
+  EXPECT_EQ(interner.lookup(first), "interned_name");
+  EXPECT_EQ(interner.find("interned_name"), first);
+  EXPECT_EQ(interner.find("never_interned_name"), std::nullopt);
+}
+
+TEST(SymbolTableTest, InnerScopesShadowOuterOnes) {
+  auto outer = makeVar("shadowed");
+  auto inner = makeVar("shadowed");
+  auto innermost = makeVar("shadowed");
+  auto local = makeVar("local_only");
+
+  SymbolTable table;
+  table.addSymbol(&outer);
+  EXPECT_EQ(table.findSymbol("shadowed"), &outer);
+
+  table.pushScope();
+  table.addSymbol(&inner);
+  table.addSymbol(&local);
+  EXPECT_EQ(table.findSymbol("shadowed"), &inner);
+
+  table.pushScope();
+  table.addSymbol(&innermost);
+  EXPECT_EQ(table.findSymbol("shadowed"), &innermost);
+  EXPECT_EQ(table.findSymbol("local_only"), &local);
+  table.popScope();
+
+  EXPECT_EQ(table.findSymbol("shadowed"), &inner);
+  table.popScope();
+
+  EXPECT_EQ(table.findSymbol("shadowed"), &outer);
+  EXPECT_THROW(table.findSymbol("local_only"), SemanticError);
+  EXPECT_THROW(table.findSymbol("never_declared_name"), SemanticError);
+}
+
+TEST(SymbolTableTest, RedeclarationInTheSameScope) {
+  auto first = makeVar("redeclared");
+  auto second = makeVar("redeclared");
+
+  SymbolTable table;
+  table.pushScope();
+  table.addSymbol(&first);
+  table.addSymbol(&second);
+  EXPECT_EQ(table.findSymbol("redeclared"), &second);
+  table.popScope();
+  EXPECT_THROW(table.findSymbol("redeclared"), SemanticError);
+}
@@ -0,0 +1,98 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <gtest/gtest.h>
+#include <fmt/format.h>
+// Wisnia
+#include "AST.hpp"
+#include "Lexer.hpp"
+#include "NodeCollector.hpp"
+#include "ParallelParser.hpp"
+#include "Parser.hpp"
+#include "SemanticAnalysis.hpp"
+
+using namespace Wisnia;
+using namespace std::literals;
+
+namespace {
+constexpr auto kProgram = R"(
+  fn add(a: int, b: int) -> int { return a + b; }
+  fn main() {
+    int x = 5;
+    int y = add(x, 2) * x;
+    print(x, y);
+  }
+)"sv;
+
+std::string dump(const AST::Root &root) {
+  std::ostringstream output;
+  root.print(output);
+  return output.str();
+}
+}  // namespace
+
+TEST(NodeArenaTest, NodesAreAllocatedInTheArenaInScope) {
+  std::istringstream heapStream{kProgram.data()};
+  Lexer heapLexer{heapStream};
+  Parser heapParser{heapLexer};
+  const auto heapRoot = heapParser.parse();
+
+  AST::NodeArena arena{};
+  std::unique_ptr<AST::Root> root{};
+  {
+    AST::NodeArena::Scope scope{arena};
+    EXPECT_EQ(AST::NodeArena::current(), &arena);
+    std::istringstream iss{kProgram.data()};
+    Lexer lexer{iss};
+    Parser parser{lexer};
+    root = parser.parse();
+  }
+  EXPECT_EQ(AST::NodeArena::current(), nullptr);
+  EXPECT_GT(arena.getAllocations(), 20);
+  EXPECT_EQ(arena.getBlocks(), 1);
+  EXPECT_EQ(dump(*root), dump(*heapRoot));
+
+  // nodes made after the scope is gone are on the heap, and both kinds can be mixed in a tree
+  root->addGlobalFunction(std::make_unique<AST::Root>());
+  const size_t allocations = arena.getAllocations();
+  root.reset();
+  EXPECT_EQ(arena.getAllocations(), allocations);
+}
+
+TEST(NodeArenaTest, ParallelParserHandsOverThreadArenas) {
+  std::string program{};
+  for (size_t i = 0; i < 100; ++i) {
+    program += fmt::format("fn f{}(a: int) -> int {{ return a + {}; }}\n", i, i);
+  }
+  std::istringstream iss{program};
+  const auto source = SourceBuffer::fromStream(iss);
+
+  AST::NodeArena arena{};
+  AST::NodeArena::Scope scope{arena};
+  const auto root = ParallelParser{source, 4}.parse();
+
+  EXPECT_EQ(root->getGlobalFunctions().size(), 100);
+  // 100 functions, each with at least a name, a parameter and a return statement
+  EXPECT_GT(arena.getAllocations(), 300);
+}
+
+TEST(NodeArenaTest, VariableUsesShareTheDeclaredType) {
+  std::istringstream iss{kProgram.data()};
+  Lexer lexer{iss};
+  Parser parser{lexer};
+  const auto root = parser.parse();
+  SemanticAnalysis analysis{};
+  root->accept(analysis);
+
+  NodeCollector<AST::VarExpr> collector{};
+  root->accept(collector);
+  std::unordered_map<std::string, const AST::BaseType *> types{};
+  for (const auto *var : collector.getNodes()) {
+    if (var->getToken()->getValue<std::string>() == "x") {
+      ASSERT_NE(var->getType(), nullptr);
+      const auto [it, _] = types.try_emplace("x", var->getType());
+      EXPECT_EQ(var->getType(), it->second);
+    }
+  }
+  EXPECT_EQ(types.size(), 1);
+}
@@ -0,0 +1,90 @@
+// Copyright (C) 2019-2024 Tautvydas Povilaitis (belijzajac)
+// SPDX-License-Identifier: GPL-3.0
+
+#include <gtest/gtest.h>
+#include <fmt/format.h>
+// Wisnia
+#include "AST.hpp"
+#include "Lexer.hpp"
+#include "ParallelParser.hpp"
+#include "Parser.hpp"
+
+using namespace Wisnia;
+using namespace Basic;
+using namespace std::literals;
+
+TEST(ParallelParserTest, SplitAtTopLevelBraces) {
+  constexpr auto program = R"(fn a() { if (true) { print("}"); } }
+  // }
+  class B { def B() {} int x; }
+  /* } */ fn c() { print("\"}"); }
+  )"sv;
+  const auto ranges = ParallelParser::split(program, 100);
+
+  ASSERT_EQ(ranges.size(), 4);
+  EXPECT_EQ(program.substr(ranges[0].m_begin, ranges[0].m_end - ranges[0].m_begin).back(), '}');
+  EXPECT_TRUE(program.substr(ranges[1].m_begin).starts_with("\n  // }\n  class B"));
+  EXPECT_TRUE(program.substr(ranges[2].m_begin).starts_with("\n  /* } */ fn c()"));
+  EXPECT_EQ(ranges[3].m_end, program.size());
+}
+
+TEST(ParallelParserTest, UnbalancedBracesAreLeftInOnePiece) {
+  EXPECT_EQ(ParallelParser::split("fn a() {} }"sv, 100).size(), 1);
+  EXPECT_EQ(ParallelParser::split("fn a() {} fn b() {"sv, 100).size(), 1);
+  EXPECT_EQ(ParallelParser::split("fn a() {} fn b() { print(\"}); }"sv, 100).size(), 1);
+}
+
+TEST(ParallelParserTest, SameTreeAsSequential) {
+  std::string program{};
+  for (size_t i = 0; i < 200; ++i) {
+    program += fmt::format(R"(
+    /* function *
+     * number {} */
+    fn f{}(a: int) -> int {{
+      int b = a * {}
+      ;
+      print("{{\"\
+      \n", b); // }}
+      return b;
+    }}
+    )", i, i, i);
+  }
+  std::istringstream iss{program};
+  const auto source = SourceBuffer::fromStream(iss);
+  ASSERT_GT(ParallelParser::split(source->getData(), 8).size(), 1);
+
+  std::istringstream sequentialStream{program};
+  Lexer lexer{sequentialStream};
+  Parser parser{lexer};
+  const auto sequential = parser.parse();
+  const auto parallel = ParallelParser{source, 4}.parse();
+
+  std::ostringstream expected, actual;
+  sequential->print(expected);
+  parallel->print(actual);
+  EXPECT_EQ(actual.str(), expected.str());
+
+  ASSERT_EQ(parallel->getGlobalFunctions().size(), sequential->getGlobalFunctions().size());
+  for (size_t i = 0; i < sequential->getGlobalFunctions().size(); ++i) {
+    const auto &expectedPosition = sequential->getGlobalFunctions()[i]->getToken()->getPosition();
+    const auto &actualPosition = parallel->getGlobalFunctions()[i]->getToken()->getPosition();
+    EXPECT_EQ(actualPosition.getLineNo(), expectedPosition.getLineNo());
+    EXPECT_EQ(actualPosition.getColumnNo(), expectedPosition.getColumnNo());
+  }
+}
+
+TEST(ParallelParserTest, FirstErrorInSourceIsReported) {
+  std::string program{};
+  for (size_t i = 0; i < 100; ++i) {
+    program += fmt::format("fn f{}() {{ {} }}\n", i, i == 40 || i == 80 ? "int;" : "");
+  }
+  std::istringstream iss{program};
+  ParallelParser parser{SourceBuffer::fromStream(iss), 4};
+
+  try {
+    parser.parse();
+    FAIL() << "expected a ParserError";
+  } catch (const ParserError &ex) {
+    EXPECT_TRUE(std::string_view{ex.what()}.ends_with(":41"));
+  }
+}
@@ -841,3 +841,25 @@ TEST(ParserTest, ClassDefinition) {
   EXPECT_STREQ(field->getVariable()->getToken()->getValue<std::string>().c_str(), "m_var");
   EXPECT_EQ(field->getValue(), nullptr);
 }
+
+TEST(ParserTest, StreamingLexerBuildsTheSameTree) {
+  constexpr auto program = R"(
+  class Foo { def Foo(v: int) {} rem Foo {} int x; }
+  fn bar(a: int) -> int { return a * (2 + a); }
+  fn main() {
+    int a = 5;
+    for (int i = 0; i < 10; i = i + 1) { if (i == a && i >= 2) { print("i=", i); } }
+    a = foo.bar(a);
+  }
+  )"sv;
+  auto dump = [&](auto... streaming) {
+    std::istringstream iss{program.data()};
+    Lexer lexer{iss, streaming...};
+    Parser parser{lexer};
+    std::ostringstream output;
+    parser.parse()->print(output);
+    return output.str();
+  };
+
+  EXPECT_EQ(dump(Lexer::Streaming{}), dump());
+}